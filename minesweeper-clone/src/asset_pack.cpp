@@ -0,0 +1,218 @@
+/**********************************************************************************************
+*
+*   Minesweeper Clone - Asset Pack
+*
+*   Every game asset in one indexed file, memory-mapped at startup so assets are loaded
+*   from memory without opening files.
+*
+*   Copyright (c) 2024 (DoughnutDude)
+*
+**********************************************************************************************/
+
+#include "asset_pack.h"
+
+#include <stdio.h>          // Required for: FILE, fopen(), fread(), fwrite(), fseek(), fclose()
+#include <stdlib.h>         // Required for: calloc(), free()
+#include <string.h>         // Required for: memcmp(), memcpy(), memset(), strlen(), strcmp(), strcpy()
+
+#if defined(_WIN32)
+    // NOTE: windows.h is only included here, it collides with raylib.h
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <sys/mman.h>   // Required for: mmap(), munmap()
+    #include <sys/stat.h>   // Required for: fstat()
+    #include <fcntl.h>      // Required for: open()
+    #include <unistd.h>     // Required for: close()
+#endif
+
+#define internal static
+
+#define ASSET_PACK_HEADER_SIZE  16
+#define ASSET_ENTRY_SIZE        (ASSET_NAME_SIZE + 8)
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions Definition
+//----------------------------------------------------------------------------------
+internal unsigned int ReadU32(const unsigned char *data)
+{
+    return (unsigned int)data[0] | ((unsigned int)data[1] << 8) | ((unsigned int)data[2] << 16) | ((unsigned int)data[3] << 24);
+}
+
+internal void WriteU32(unsigned char *data, unsigned int value)
+{
+    for (int i = 0; i < 4; ++i) data[i] = (unsigned char)(value >> (8*i));
+}
+
+internal const char *GetAssetName(const char *path)
+{
+    const char *name = path;
+    for (const char *c = path; *c != '\0'; ++c) if ((*c == '/') || (*c == '\\')) name = c + 1;
+    return name;
+}
+
+internal bool MapAssetPackFile(AssetPack *pack, const char *fileName)
+{
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || (fileSize.QuadPart == 0) || (fileSize.QuadPart > 0x7fffffff))
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    const void *data = (mapping != NULL)? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+    if (data == NULL)
+    {
+        if (mapping != NULL) CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    pack->data = (const unsigned char *)data;
+    pack->size = (unsigned int)fileSize.QuadPart;
+    pack->fileHandle = file;
+    pack->mappingHandle = mapping;
+#else
+    int file = open(fileName, O_RDONLY);
+    if (file < 0) return false;
+
+    struct stat fileStat;
+    if ((fstat(file, &fileStat) != 0) || (fileStat.st_size == 0) || (fileStat.st_size > 0x7fffffff))
+    {
+        close(file);
+        return false;
+    }
+
+    void *data = mmap(NULL, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);        // NOTE: The mapping keeps the file referenced
+    if (data == MAP_FAILED) return false;
+
+    pack->data = (const unsigned char *)data;
+    pack->size = (unsigned int)fileStat.st_size;
+#endif
+    return true;
+}
+
+internal void UnmapAssetPackFile(AssetPack *pack)
+{
+#if defined(_WIN32)
+    UnmapViewOfFile(pack->data);
+    CloseHandle((HANDLE)pack->mappingHandle);
+    CloseHandle((HANDLE)pack->fileHandle);
+#else
+    munmap((void *)pack->data, pack->size);
+#endif
+}
+
+//----------------------------------------------------------------------------------
+// Asset Pack Functions Definition
+//----------------------------------------------------------------------------------
+bool OpenAssetPack(AssetPack *pack, const char *fileName)
+{
+    memset(pack, 0, sizeof(AssetPack));
+    if (!MapAssetPackFile(pack, fileName)) return false;
+
+    // Check the whole index once, lookups can trust it afterwards
+    bool valid = (pack->size >= ASSET_PACK_HEADER_SIZE) && (memcmp(pack->data, "MSPK", 4) == 0) &&
+                 (ReadU32(pack->data + 4) == ASSET_PACK_VERSION);
+    unsigned int entryCount = valid? ReadU32(pack->data + 8) : 0;
+    valid = valid && (entryCount <= (pack->size - ASSET_PACK_HEADER_SIZE)/ASSET_ENTRY_SIZE);
+
+    for (unsigned int i = 0; valid && (i < entryCount); ++i)
+    {
+        const unsigned char *entry = pack->data + ASSET_PACK_HEADER_SIZE + i*ASSET_ENTRY_SIZE;
+        unsigned int offset = ReadU32(entry + ASSET_NAME_SIZE);
+        unsigned int size = ReadU32(entry + ASSET_NAME_SIZE + 4);
+        valid = (entry[ASSET_NAME_SIZE - 1] == '\0') && (offset <= pack->size) && (size <= pack->size - offset);
+    }
+
+    if (!valid)
+    {
+        CloseAssetPack(pack);
+        return false;
+    }
+
+    pack->entryCount = (int)entryCount;
+    return true;
+}
+
+void CloseAssetPack(AssetPack *pack)
+{
+    if (pack->data != NULL) UnmapAssetPackFile(pack);
+    memset(pack, 0, sizeof(AssetPack));
+}
+
+const unsigned char *GetAssetData(const AssetPack *pack, const char *name, int *size)
+{
+    for (int i = 0; i < pack->entryCount; ++i)
+    {
+        const unsigned char *entry = pack->data + ASSET_PACK_HEADER_SIZE + i*ASSET_ENTRY_SIZE;
+        if (strcmp((const char *)entry, name) == 0)
+        {
+            if (size != NULL) *size = (int)ReadU32(entry + ASSET_NAME_SIZE + 4);
+            return pack->data + ReadU32(entry + ASSET_NAME_SIZE);
+        }
+    }
+
+    if (size != NULL) *size = 0;
+    return NULL;
+}
+
+bool BuildAssetPack(const char *fileName, const char **files, int fileCount)
+{
+    unsigned int indexSize = ASSET_PACK_HEADER_SIZE + fileCount*ASSET_ENTRY_SIZE;
+    unsigned char *index = (unsigned char *)calloc(indexSize, 1);
+    FILE *pack = fopen(fileName, "wb");
+    bool result = (index != NULL) && (pack != NULL);
+
+    // Index goes first, written again at the end once offsets are known
+    if (result) result = (fwrite(index, 1, indexSize, pack) == indexSize);
+
+    unsigned int offset = indexSize;
+    for (int i = 0; result && (i < fileCount); ++i)
+    {
+        const char *name = GetAssetName(files[i]);
+        FILE *file = fopen(files[i], "rb");
+        result = (file != NULL) && (strlen(name) < ASSET_NAME_SIZE);
+
+        unsigned char padding[ASSET_PACK_ALIGNMENT] = { 0 };
+        unsigned int paddingSize = (ASSET_PACK_ALIGNMENT - offset%ASSET_PACK_ALIGNMENT)%ASSET_PACK_ALIGNMENT;
+        if (result) result = (fwrite(padding, 1, paddingSize, pack) == paddingSize);
+        offset += paddingSize;
+
+        unsigned int size = 0;
+        unsigned char buffer[4096];
+        size_t count = 0;
+        while (result && ((count = fread(buffer, 1, sizeof(buffer), file)) > 0))
+        {
+            result = (fwrite(buffer, 1, count, pack) == count);
+            size += (unsigned int)count;
+        }
+        if (file != NULL) fclose(file);
+
+        unsigned char *entry = index + ASSET_PACK_HEADER_SIZE + i*ASSET_ENTRY_SIZE;
+        if (result) strcpy((char *)entry, name);
+        WriteU32(entry + ASSET_NAME_SIZE, offset);
+        WriteU32(entry + ASSET_NAME_SIZE + 4, size);
+        offset += size;
+    }
+
+    if (result)
+    {
+        memcpy(index, "MSPK", 4);
+        WriteU32(index + 4, ASSET_PACK_VERSION);
+        WriteU32(index + 8, (unsigned int)fileCount);
+        result = (fseek(pack, 0, SEEK_SET) == 0) && (fwrite(index, 1, indexSize, pack) == indexSize);
+    }
+
+    if (pack != NULL) result = (fclose(pack) == 0) && result;
+    free(index);
+
+    return result;
+}
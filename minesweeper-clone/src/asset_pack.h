@@ -0,0 +1,50 @@
+/**********************************************************************************************
+*
+*   Minesweeper Clone - Asset Pack
+*
+*   Every game asset in one indexed file, memory-mapped at startup so assets are loaded
+*   from memory (LoadFontFromMemory(), LoadWaveFromMemory()...) without opening files.
+*   The pack is written at build time by running the game with --pack-assets.
+*
+*   Pack format (little-endian):
+*       "MSPK", u32 version, u32 entry count, u32 reserved
+*       entries: char name[ASSET_NAME_SIZE], u32 offset, u32 size
+*       data, every asset aligned to ASSET_PACK_ALIGNMENT bytes
+*
+*   Copyright (c) 2024 (DoughnutDude)
+*
+**********************************************************************************************/
+
+#ifndef ASSET_PACK_H
+#define ASSET_PACK_H
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define ASSET_PACK_FILE         "assets.pak"    // Next to the executable
+#define ASSET_PACK_VERSION      1
+#define ASSET_NAME_SIZE         56              // Including the terminating zero
+#define ASSET_PACK_ALIGNMENT    16
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct AssetPack {
+    const unsigned char *data;      // Whole pack file, read only
+    unsigned int size;
+    int entryCount;
+    void *fileHandle;               // Platform handles kept for unmapping
+    void *mappingHandle;
+} AssetPack;
+
+//----------------------------------------------------------------------------------
+// Asset Pack Functions Declaration
+//----------------------------------------------------------------------------------
+bool OpenAssetPack(AssetPack *pack, const char *fileName);      // Map pack file and check its index
+void CloseAssetPack(AssetPack *pack);                           // Unmap pack, asset data pointers become invalid
+const unsigned char *GetAssetData(const AssetPack *pack, const char *name, int *size);  // NULL if not in the pack
+
+// Write files into a new pack, assets are named after the file names without directories
+bool BuildAssetPack(const char *fileName, const char **files, int fileCount);
+
+#endif // ASSET_PACK_H
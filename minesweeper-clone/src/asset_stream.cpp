@@ -0,0 +1,264 @@
+/**********************************************************************************************
+*
+*   Minesweeper Clone - Asset Streaming
+*
+*   Assets are decoded from the asset pack on a worker thread, uploaded on the main thread
+*   a few per frame.
+*
+*   Copyright (c) 2024 (DoughnutDude)
+*
+**********************************************************************************************/
+
+#include "asset_stream.h"
+#include "logger.h"
+
+#include <stdio.h>          // Required for: snprintf()
+#include <string.h>         // Required for: strncpy(), memset()
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#define internal static
+#define global_var static
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum AssetKind {
+    ASSET_FONT_ATLASES = 0,
+    ASSET_SOUND,
+} AssetKind;
+
+typedef enum AssetState {
+    ASSET_QUEUED = 0,       // Waiting for the worker
+    ASSET_DECODED,          // CPU data ready, owned by the main thread from now on
+    ASSET_READY,            // Uploaded into its target
+    ASSET_FAILED,           // Not in the pack or not decodable, target left empty
+} AssetState;
+
+typedef struct AssetRequest {
+    AssetKind kind;
+    AssetGroup group;
+    char name[ASSET_NAME_SIZE];
+    std::atomic<int> state;
+    bool uploading;             // Upload spread over several steps has started (font atlases)
+
+    FontAtlasSet *fontTarget;
+    Sound *soundTarget;
+    FontAtlasSet font;          // Decoded data
+    Wave wave;
+} AssetRequest;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+global_var AssetRequest requests[MAX_ASSET_REQUESTS];
+global_var int requestCount = 0;            // Written by the main thread under streamMutex
+global_var int decodeIndex = 0;             // Next request decoded, worker only
+global_var const AssetPack *streamPack = NULL;
+
+global_var std::thread streamWorker;
+global_var std::mutex streamMutex;
+global_var std::condition_variable streamSignal;
+global_var bool workerRunning = false;
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions Definition
+//----------------------------------------------------------------------------------
+// NOTE: Runs on the worker, only CPU memory is touched (no GPU, no audio device, no TextFormat())
+internal void DecodeAssetRequest(AssetRequest *request)
+{
+    char fileName[ASSET_NAME_SIZE + 8] = { 0 };
+    int dataSize = 0;
+    const unsigned char *data = NULL;
+    bool decoded = false;
+
+    switch (request->kind)
+    {
+        case ASSET_FONT_ATLASES:
+        {
+            snprintf(fileName, sizeof(fileName), "%s.msfa", request->name);
+            data = GetAssetData(streamPack, fileName, &dataSize);
+            decoded = DecodeFontAtlasSet(&request->font, data, dataSize);
+
+            if (!decoded)
+            {
+                // Not baked, rasterize the TTF at the base size only
+                LOG_MESSAGE(LOG_LEVEL_WARNING, LOG_CATEGORY_GAME, "[%s] Baked font atlases not in asset pack, loading TTF", request->name);
+                snprintf(fileName, sizeof(fileName), "%s.ttf", request->name);
+                data = GetAssetData(streamPack, fileName, &dataSize);
+                decoded = DecodeFontAtlasSetTTF(&request->font, data, dataSize);
+            }
+        } break;
+        case ASSET_SOUND:
+        {
+            data = GetAssetData(streamPack, request->name, &dataSize);
+            if (data != NULL) request->wave = LoadWaveFromMemory(GetFileExtension(request->name), data, dataSize);
+            decoded = (request->wave.data != NULL);
+        } break;
+        default: break;
+    }
+
+    if (!decoded) LOG_MESSAGE(LOG_LEVEL_WARNING, LOG_CATEGORY_GAME, "[%s] Asset not in asset pack or invalid", request->name);
+    request->state = decoded? ASSET_DECODED : ASSET_FAILED;
+}
+
+internal void StreamWorkerThread(void)
+{
+    for (;;)
+    {
+        AssetRequest *request = NULL;
+        {
+            std::unique_lock<std::mutex> lock(streamMutex);
+            streamSignal.wait(lock, []{ return !workerRunning || (decodeIndex < requestCount); });
+            if (!workerRunning) break;
+            request = &requests[decodeIndex];
+        }
+
+        DecodeAssetRequest(request);
+        ++decodeIndex;
+    }
+}
+
+// Upload one step of a decoded request, main thread
+internal void UploadAssetRequest(AssetRequest *request)
+{
+    switch (request->kind)
+    {
+        case ASSET_FONT_ATLASES:
+        {
+            // Target becomes the owner first, atlases then show up one per step
+            if (!request->uploading)
+            {
+                *request->fontTarget = request->font;
+                memset(&request->font, 0, sizeof(FontAtlasSet));
+                request->uploading = true;
+            }
+            if (UploadFontAtlas(request->fontTarget)) request->state = ASSET_READY;
+        } break;
+        case ASSET_SOUND:
+        {
+            *request->soundTarget = LoadSoundFromWave(request->wave);
+            UnloadWave(request->wave);
+            request->wave = { 0 };
+            request->state = ASSET_READY;
+        } break;
+        default: break;
+    }
+}
+
+internal void AddAssetRequest(AssetKind kind, AssetGroup group, const char *name, FontAtlasSet *fontTarget, Sound *soundTarget)
+{
+    if (requestCount >= MAX_ASSET_REQUESTS)
+    {
+        LOG_MESSAGE(LOG_LEVEL_WARNING, LOG_CATEGORY_GAME, "[%s] Too many asset requests, not loaded", name);
+        return;
+    }
+
+    AssetRequest *request = &requests[requestCount];
+    request->kind = kind;
+    request->group = group;
+    strncpy(request->name, name, ASSET_NAME_SIZE - 1);
+    request->name[ASSET_NAME_SIZE - 1] = '\0';
+    request->state = ASSET_QUEUED;
+    request->uploading = false;
+    request->fontTarget = fontTarget;
+    request->soundTarget = soundTarget;
+
+    {
+        std::lock_guard<std::mutex> lock(streamMutex);
+        ++requestCount;
+    }
+    streamSignal.notify_one();
+}
+
+//----------------------------------------------------------------------------------
+// Asset Streaming Functions Definition
+//----------------------------------------------------------------------------------
+void InitAssetStreaming(const AssetPack *pack)
+{
+    streamPack = pack;
+
+#if !defined(PLATFORM_WEB)
+    workerRunning = true;
+    streamWorker = std::thread(StreamWorkerThread);
+#endif
+}
+
+void CloseAssetStreaming(void)
+{
+    if (workerRunning)
+    {
+        {
+            std::lock_guard<std::mutex> lock(streamMutex);
+            workerRunning = false;
+        }
+        streamSignal.notify_one();
+        streamWorker.join();
+    }
+
+    // Decoded data never handed to a target
+    for (int i = 0; i < requestCount; ++i)
+    {
+        if (requests[i].state != ASSET_DECODED) continue;
+
+        if (!requests[i].uploading) UnloadFontAtlasSet(&requests[i].font);
+        if (requests[i].wave.data != NULL) UnloadWave(requests[i].wave);
+    }
+
+    requestCount = 0;
+    decodeIndex = 0;
+    streamPack = NULL;
+}
+
+void RequestFontAtlases(AssetGroup group, const char *name, FontAtlasSet *set)
+{
+    AddAssetRequest(ASSET_FONT_ATLASES, group, name, set, NULL);
+}
+
+void RequestSound(AssetGroup group, const char *name, Sound *sound)
+{
+    AddAssetRequest(ASSET_SOUND, group, name, NULL, sound);
+}
+
+void UpdateAssetStreaming(double timeBudget)
+{
+#if defined(PLATFORM_WEB)
+    // No worker, decode one request per frame
+    if (decodeIndex < requestCount) DecodeAssetRequest(&requests[decodeIndex++]);
+#endif
+
+    double startTime = GetTime();
+    for (int i = 0; i < requestCount; ++i)
+    {
+        while (requests[i].state == ASSET_DECODED)
+        {
+            UploadAssetRequest(&requests[i]);
+            if (GetTime() - startTime >= timeBudget) return;
+        }
+    }
+}
+
+bool IsAssetGroupReady(AssetGroup group)
+{
+    for (int i = 0; i < requestCount; ++i)
+    {
+        int state = requests[i].state;
+        if ((requests[i].group == group) && (state != ASSET_READY) && (state != ASSET_FAILED)) return false;
+    }
+
+    return true;
+}
+
+bool IsAssetStreamingDone(void)
+{
+    for (int i = 0; i < requestCount; ++i)
+    {
+        int state = requests[i].state;
+        if ((state != ASSET_READY) && (state != ASSET_FAILED)) return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,48 @@
+/**********************************************************************************************
+*
+*   Minesweeper Clone - Asset Streaming
+*
+*   Assets requested at startup are decoded from the asset pack on a worker thread into CPU
+*   data (font atlases, Wave), the main thread then uploads them (textures, sounds) a few per
+*   frame while the logo screen is shown. Screens wait only for their own asset group.
+*
+*   Copyright (c) 2024 (DoughnutDude)
+*
+**********************************************************************************************/
+
+#ifndef ASSET_STREAM_H
+#define ASSET_STREAM_H
+
+#include "raylib.h"
+#include "asset_pack.h"
+#include "font_atlas.h"
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define MAX_ASSET_REQUESTS      32
+#define ASSET_UPLOAD_TIME       0.004   // Seconds per frame spent uploading decoded assets (at least one step)
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+// NOTE: Screens needing their own assets get their own group, streamed after the title ones
+typedef enum AssetGroup {
+    ASSET_GROUP_TITLE = 0,      // Needed before the title screen shows (and every screen after it)
+} AssetGroup;
+
+//----------------------------------------------------------------------------------
+// Asset Streaming Functions Declaration
+//----------------------------------------------------------------------------------
+void InitAssetStreaming(const AssetPack *pack);     // Start decoding requests, pack must stay open until CloseAssetStreaming()
+void CloseAssetStreaming(void);                     // Stop the worker, decoded assets not uploaded yet are discarded
+
+// Decoded in request order, targets are written on the main thread once uploaded
+void RequestFontAtlases(AssetGroup group, const char *name, FontAtlasSet *set);  // Baked <name>.msfa, <name>.ttf if not baked
+void RequestSound(AssetGroup group, const char *name, Sound *sound);
+
+void UpdateAssetStreaming(double timeBudget);       // Upload decoded assets, main thread
+bool IsAssetGroupReady(AssetGroup group);           // Every asset of the group uploaded (or failed, left empty)
+bool IsAssetStreamingDone(void);
+
+#endif // ASSET_STREAM_H
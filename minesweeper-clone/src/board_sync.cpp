@@ -0,0 +1,394 @@
+/**********************************************************************************************
+*
+*   Minesweeper Clone - Board Sync
+*
+*   Board delta encoding and decoding.
+*
+*   Copyright (c) 2024 (DoughnutDude)
+*
+**********************************************************************************************/
+
+#include "board_sync.h"
+
+#include <string.h>         // Required for: memcmp(), memset()
+
+#define internal static
+
+#define BOARD_DELTA_HEADER_SIZE     (NET_MESSAGE_HEADER_SIZE + 10)      // Framing, opponent index, tick, flags, checksum
+#define BOARD_SPAN_MAX_RUNS         maxBoardWidth                       // A span is at most one row
+#define BOARD_HP_INDEX              (maxBoardWidth*maxBoardHeight)      // Checksum index of the hp, after every tile
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct DeltaWriter {
+    NetWriter *writer;
+    BoardSync *sync;
+    int tick;
+    int player;             // Opponent board index, NET_NO_PLAYER for the player own board
+    bool open;              // Message started and not ended yet
+    int flagsOffset;
+    int checksumOffset;     // Where the checksum is patched once the message is complete
+} DeltaWriter;
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions Definition
+//----------------------------------------------------------------------------------
+internal unsigned int GetTileChecksum(int index, int code)
+{
+    unsigned int value = ((unsigned int)index*16u + (unsigned int)code)*0x9e3779b1u;
+    value ^= value >> 15;
+    value *= 0x85ebca6bu;
+    value ^= value >> 13;
+    return value;
+}
+
+internal TileCode GetTileCodeFromMask(signed char mask, signed char tile)
+{
+    switch (mask)
+    {
+        case 1: return TILE_CODE_HIDDEN;
+        case 2: return TILE_CODE_FLAGGED;
+        case -1: return TILE_CODE_WRONG_FLAG;
+        default: break;
+    }
+
+    if (tile == -1) return TILE_CODE_MINE;
+    if (tile == -2) return TILE_CODE_CLICKED_MINE;
+    return (TileCode)tile;
+}
+
+internal bool IsFlagToggle(TileCode before, TileCode after)
+{
+    return (((before == TILE_CODE_HIDDEN) && (after == TILE_CODE_FLAGGED)) ||
+            ((before == TILE_CODE_FLAGGED) && (after == TILE_CODE_HIDDEN)));
+}
+
+internal void SetSyncHP(BoardSync *sync, int hp)
+{
+    sync->checksum -= GetTileChecksum(BOARD_HP_INDEX, sync->hp);
+    sync->checksum += GetTileChecksum(BOARD_HP_INDEX, hp);
+    sync->hp = hp;
+}
+
+// Server side: the client now has the tile as it is on the game board
+internal void SyncTile(BoardSync *sync, const GameState *game, int x, int y)
+{
+    int index = y*sync->width + x;
+    sync->checksum -= GetTileChecksum(index, GetTileCodeFromMask(sync->boardMask[y][x], game->board[y][x]));
+    sync->checksum += GetTileChecksum(index, GetTileCode(game, x, y));
+    sync->boardMask[y][x] = game->boardMask[y][x];
+}
+
+internal void AddChangedRegion(BoardSync *sync, BoardRegion region)
+{
+    BoardRegion *changed = &sync->changed;
+    if (changed->minX >= changed->maxX) *changed = region;
+    else
+    {
+        if (region.minX < changed->minX) changed->minX = region.minX;
+        if (region.minY < changed->minY) changed->minY = region.minY;
+        if (region.maxX > changed->maxX) changed->maxX = region.maxX;
+        if (region.maxY > changed->maxY) changed->maxY = region.maxY;
+    }
+}
+
+// Hidden rows added below the board, nothing above them moves
+internal void AppendSyncRows(BoardSync *sync, int count)
+{
+    for (int y = sync->height; y < sync->height + count; ++y)
+    {
+        memset(sync->boardMask[y], 1, sync->width);
+        for (int x = 0; x < sync->width; ++x) sync->checksum += GetTileChecksum(y*sync->width + x, TILE_CODE_HIDDEN);
+    }
+    AddChangedRegion(sync, { 0, sync->height, sync->width, sync->height + count });
+    sync->height += count;
+}
+
+// Client side: write a received tile to the view
+internal void SetViewTile(BoardSync *sync, GameState *view, int x, int y, TileCode code)
+{
+    int index = y*sync->width + x;
+    sync->checksum -= GetTileChecksum(index, GetTileCodeFromMask(sync->boardMask[y][x], view->board[y][x]));
+    sync->checksum += GetTileChecksum(index, code);
+
+    AddChangedRegion(sync, { x, y, x + 1, y + 1 });
+
+    signed char mask = 0;
+    switch (code)
+    {
+        case TILE_CODE_MINE: view->board[y][x] = -1; break;
+        case TILE_CODE_CLICKED_MINE: view->board[y][x] = -2; break;
+        case TILE_CODE_WRONG_FLAG: mask = -1; break;
+        case TILE_CODE_HIDDEN: mask = 1; break;
+        case TILE_CODE_FLAGGED: mask = 2; break;
+        default: view->board[y][x] = (signed char)code; break;
+    }
+    view->boardMask[y][x] = mask;
+    sync->boardMask[y][x] = mask;
+}
+
+internal void EndDeltaMessage(DeltaWriter *delta)
+{
+    if (!delta->open) return;
+
+    NetWriter *writer = delta->writer;
+    for (int i = 0; i < 4; ++i) writer->data[delta->checksumOffset + i] = (unsigned char)(delta->sync->checksum >> (8*i));
+    EndNetMessage(writer);
+    delta->open = false;
+}
+
+// Make room for an operation of size bytes, in the open message or a new one, false if the writer is full
+internal bool ReserveDeltaOp(DeltaWriter *delta, int size)
+{
+    NetWriter *writer = delta->writer;
+    if (delta->open)
+    {
+        int payloadSize = writer->size - writer->messageStart - NET_MESSAGE_HEADER_SIZE;
+        if (payloadSize + size <= NET_MAX_MESSAGE_SIZE) return (writer->size + size <= writer->capacity);
+        EndDeltaMessage(delta);
+    }
+
+    if (writer->size + BOARD_DELTA_HEADER_SIZE + size > writer->capacity) return false;
+
+    if (delta->player == NET_NO_PLAYER) BeginNetMessage(writer, MSG_BOARD_DELTA);
+    else
+    {
+        BeginNetMessage(writer, MSG_OPPONENT_DELTA);
+        NetWriteU8(writer, (unsigned int)delta->player);
+    }
+    NetWriteU32(writer, (unsigned int)delta->tick);
+    delta->flagsOffset = writer->size;
+    NetWriteU8(writer, delta->sync->keyframe? BOARD_DELTA_KEYFRAME : 0);
+    delta->checksumOffset = writer->size;
+    NetWriteU32(writer, 0);
+    delta->sync->keyframe = false;
+    delta->open = true;
+    return true;
+}
+
+// Append deltas bringing the client board to game, player is NET_NO_PLAYER for its own board
+internal bool WriteDelta(BoardSync *sync, const GameState *game, NetWriter *writer, int tick, int player)
+{
+    DeltaWriter delta = { writer, sync, tick, player, false, 0, 0 };
+    bool synced = true;
+
+    // NOTE: A keyframe always carries the hp, the client knows the keyframe arrived
+    if (sync->hp != game->hp)
+    {
+        if (!ReserveDeltaOp(&delta, 2)) return false;
+        NetWriteU8(writer, BOARD_OP_HP);
+        NetWriteU8(writer, (unsigned int)game->hp);
+        SetSyncHP(sync, game->hp);
+    }
+
+    for (int y = 0; (y < game->height) && synced; ++y)
+    {
+        if (memcmp(sync->boardMask[y], game->boardMask[y], game->width) == 0) continue;
+
+        int x = 0;
+        while ((x < game->width) && synced)
+        {
+            if (sync->boardMask[y][x] == game->boardMask[y][x])
+            {
+                ++x;
+                continue;
+            }
+
+            TileCode before = GetTileCodeFromMask(sync->boardMask[y][x], game->board[y][x]);
+            TileCode after = GetTileCode(game, x, y);
+            if (IsFlagToggle(before, after))
+            {
+                synced = ReserveDeltaOp(&delta, 3);
+                if (!synced) break;
+
+                NetWriteU8(writer, BOARD_OP_FLAG);
+                NetWriteU8(writer, (unsigned int)x);
+                NetWriteU8(writer, (unsigned int)y);
+                SyncTile(sync, game, x, y);
+                ++x;
+                continue;
+            }
+
+            // Span of changed tiles on this row, run-length encoded (flood fills reveal long runs of zeros)
+            unsigned char runs[BOARD_SPAN_MAX_RUNS];
+            int runCount = 0;
+            int end = x;
+            while ((end < game->width) && (sync->boardMask[y][end] != game->boardMask[y][end]))
+            {
+                TileCode code = GetTileCode(game, end, y);
+                if (IsFlagToggle(GetTileCodeFromMask(sync->boardMask[y][end], game->board[y][end]), code)) break;
+
+                if ((runCount > 0) && ((runs[runCount - 1] >> 4) == code) && ((runs[runCount - 1] & 0x0f) < 0x0f)) ++runs[runCount - 1];
+                else runs[runCount++] = (unsigned char)(code << 4);
+                ++end;
+            }
+
+            synced = ReserveDeltaOp(&delta, 4 + runCount);
+            if (!synced) break;
+
+            NetWriteU8(writer, BOARD_OP_SPAN);
+            NetWriteU8(writer, (unsigned int)x);
+            NetWriteU8(writer, (unsigned int)y);
+            NetWriteU8(writer, (unsigned int)(end - x));
+            for (int i = 0; i < runCount; ++i) NetWriteU8(writer, runs[i]);
+            for (; x < end; ++x) SyncTile(sync, game, x, y);
+        }
+    }
+
+    // A keyframe of a board with nothing to send still needs its message
+    if (sync->keyframe && synced) synced = ReserveDeltaOp(&delta, 0);
+
+    if (synced && delta.open) writer->data[delta.flagsOffset] |= BOARD_DELTA_COMPLETE;
+    EndDeltaMessage(&delta);
+    return synced;
+}
+
+//----------------------------------------------------------------------------------
+// Board Sync Functions Definition
+//----------------------------------------------------------------------------------
+TileCode GetTileCode(const GameState *game, int x, int y)
+{
+    return GetTileCodeFromMask(game->boardMask[y][x], game->board[y][x]);
+}
+
+void ResetBoardSync(BoardSync *sync, int width, int height)
+{
+    sync->width = width;
+    sync->height = height;
+    sync->hp = -1;
+    sync->keyframe = true;
+
+    sync->changed = { 0, 0, width, height };
+
+    sync->checksum = GetTileChecksum(BOARD_HP_INDEX, sync->hp);
+    for (int y = 0; y < height; ++y)
+    {
+        memset(sync->boardMask[y], 1, width);
+        for (int x = 0; x < width; ++x) sync->checksum += GetTileChecksum(y*width + x, TILE_CODE_HIDDEN);
+    }
+}
+
+void InitBoardSync(BoardSync *sync, const GameState *game)
+{
+    ResetBoardSync(sync, game->width, game->height);
+    sync->keyframe = false;
+
+    SetSyncHP(sync, game->hp);
+    for (int y = 0; y < game->height; ++y)
+    {
+        for (int x = 0; x < game->width; ++x) if (game->boardMask[y][x] != 1) SyncTile(sync, game, x, y);
+    }
+}
+
+void InsertBoardSyncRows(BoardSync *sync, int row, int count)
+{
+    if ((count <= 0) || (row < 0) || (row > sync->height) || (sync->height + count > maxBoardHeight)) return;
+
+    if (row < sync->height) ResetBoardSync(sync, sync->width, sync->height + count);
+    else AppendSyncRows(sync, count);
+}
+
+void InsertViewRows(BoardSync *sync, GameState *view, int row, int count)
+{
+    if ((count <= 0) || (row < 0) || (row > sync->height) || (sync->height + count > maxBoardHeight)) return;
+
+    int width = sync->width;
+    if (row < sync->height)
+    {
+        // NOTE: Checksum left as it is, the server sends a keyframe of the board next
+        for (int y = sync->height - 1; y >= row; --y)
+        {
+            memmove(view->board[y + count], view->board[y], width);
+            memmove(view->boardMask[y + count], view->boardMask[y], width);
+            memmove(sync->boardMask[y + count], sync->boardMask[y], width);
+        }
+        for (int y = row; y < row + count; ++y) memset(sync->boardMask[y], 1, width);
+        sync->height += count;
+        sync->changed = { 0, 0, width, sync->height };
+    }
+    else AppendSyncRows(sync, count);
+
+    for (int y = row; y < row + count; ++y)
+    {
+        memset(view->board[y], 0, width);
+        memset(view->boardMask[y], 1, width);
+    }
+    view->height = sync->height;
+}
+
+bool WriteBoardDelta(BoardSync *sync, const GameState *game, NetWriter *writer, int tick)
+{
+    return WriteDelta(sync, game, writer, tick, NET_NO_PLAYER);
+}
+
+bool WriteOpponentDelta(BoardSync *sync, const GameState *game, NetWriter *writer, int tick, int player)
+{
+    return WriteDelta(sync, game, writer, tick, player);
+}
+
+bool ReadBoardDelta(BoardSync *sync, GameState *view, NetReader *payload)
+{
+    view->tick = (int)NetReadU32(payload);
+    unsigned int flags = NetReadU8(payload);
+    unsigned int checksum = NetReadU32(payload);
+    if (payload->overflow) return false;
+
+    sync->complete = ((flags & BOARD_DELTA_COMPLETE) != 0);
+    if (flags & BOARD_DELTA_KEYFRAME)
+    {
+        ResetBoardSync(sync, sync->width, sync->height);
+        view->width = sync->width;
+        view->height = sync->height;
+        for (int y = 0; y < sync->height; ++y)
+        {
+            memset(view->board[y], 0, sync->width);
+            memset(view->boardMask[y], 1, sync->width);
+        }
+    }
+
+    while (payload->position < payload->size)
+    {
+        BoardOp op = (BoardOp)NetReadU8(payload);
+        switch (op)
+        {
+            case BOARD_OP_HP:
+            {
+                int hp = (int)NetReadU8(payload);
+                SetSyncHP(sync, hp);
+                view->hp = hp;
+            } break;
+            case BOARD_OP_FLAG:
+            {
+                int x = (int)NetReadU8(payload);
+                int y = (int)NetReadU8(payload);
+                if ((x >= sync->width) || (y >= sync->height)) return false;
+
+                TileCode code = GetTileCodeFromMask(sync->boardMask[y][x], view->board[y][x]);
+                if ((code != TILE_CODE_HIDDEN) && (code != TILE_CODE_FLAGGED)) return false;
+                SetViewTile(sync, view, x, y, (code == TILE_CODE_HIDDEN)? TILE_CODE_FLAGGED : TILE_CODE_HIDDEN);
+            } break;
+            case BOARD_OP_SPAN:
+            {
+                int x = (int)NetReadU8(payload);
+                int y = (int)NetReadU8(payload);
+                int end = x + (int)NetReadU8(payload);
+                if ((end > sync->width) || (y >= sync->height)) return false;
+
+                while (x < end)
+                {
+                    unsigned int run = NetReadU8(payload);
+                    TileCode code = (TileCode)(run >> 4);
+                    int length = (int)(run & 0x0f) + 1;
+                    if (payload->overflow || (code > TILE_CODE_FLAGGED) || (x + length > end)) return false;
+
+                    for (int i = 0; i < length; ++i, ++x) SetViewTile(sync, view, x, y, code);
+                }
+            } break;
+            default: return false;
+        }
+        if (payload->overflow) return false;
+    }
+
+    return (checksum == sync->checksum);
+}
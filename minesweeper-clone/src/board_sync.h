@@ -0,0 +1,106 @@
+/**********************************************************************************************
+*
+*   Minesweeper Clone - Board Sync
+*
+*   Keeps a client copy of a board up to date with MSG_BOARD_DELTA messages, only the tiles
+*   that changed since the last message are sent.
+*
+*   The server keeps a BoardSync per client: the board as the client has it. Writing a delta
+*   compares it with the real board row by row, encodes what differs and updates it, so
+*   changes a full output buffer could not take are simply sent with the next delta.
+*   Resetting it (ResetBoardSync()) sends a keyframe: the client board is hidden again and
+*   every visible tile is sent.
+*
+*   Opponent boards use the same encoding in MSG_OPPONENT_DELTA messages (WriteOpponentDelta()),
+*   prefixed with the player index of the board. The client keeps the region of tiles a delta
+*   wrote (BoardSync.changed) so a board drawn elsewhere only updates that part.
+*
+*   MSG_BOARD_DELTA payload (little-endian):
+*       u32 tick, u8 flags (BOARD_DELTA_*), u32 checksum of the client board once applied
+*       then operations until the end of the payload:
+*       BOARD_OP_HP         u8 hp
+*       BOARD_OP_FLAG       u8 x, u8 y                  Hidden tile flagged or flagged tile unflagged
+*       BOARD_OP_SPAN       u8 x, u8 y, u8 tile count   Then runs covering the count, one byte each:
+*                                                       tile code << 4 | (run length - 1)
+*
+*   The checksum is a sum of one hash per tile (and hp), it is updated with every tile change
+*   on both sides, a mismatch means the client board is wrong and needs a keyframe.
+*
+*   Boards growing during a match (InsertGameRows()) grow both copies the same way, before any
+*   delta written after: appended rows are hidden tiles both sides add to the checksum, the
+*   rest of the board is not sent again. Rows inserted above others move every tile below,
+*   that is sent as a keyframe. Changes to a board never touch revealed tiles (game_core.h).
+*
+*   Copyright (c) 2024 (DoughnutDude)
+*
+**********************************************************************************************/
+
+#ifndef BOARD_SYNC_H
+#define BOARD_SYNC_H
+
+#include "net_protocol.h"
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define BOARD_DELTA_KEYFRAME    1       // Client board is hidden again before the operations apply
+#define BOARD_DELTA_COMPLETE    2       // Client board is the server board once applied, nothing left to send
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+// Tile as a client sees it
+typedef enum TileCode {
+    TILE_CODE_CLUE_0 = 0,           // 0 to 8: revealed, number of adjacent mines
+    TILE_CODE_MINE = 9,             // Revealed mine
+    TILE_CODE_CLICKED_MINE,         // Mine that was clicked on
+    TILE_CODE_WRONG_FLAG,           // Flag on a safe tile, shown at the end of the game
+    TILE_CODE_HIDDEN,
+    TILE_CODE_FLAGGED,
+} TileCode;
+
+typedef enum BoardOp {
+    BOARD_OP_HP = 1,
+    BOARD_OP_FLAG,
+    BOARD_OP_SPAN,
+} BoardOp;
+
+// Tiles from (minX, minY) up to (maxX, maxY) excluded, empty if minX >= maxX
+typedef struct BoardRegion {
+    int minX;
+    int minY;
+    int maxX;
+    int maxY;
+} BoardRegion;
+
+typedef struct BoardSync {
+    int width;
+    int height;
+    int hp;                             // -1 after a reset, always sent with a keyframe
+    unsigned int checksum;
+    bool keyframe;                      // Server: next delta is a keyframe
+    bool complete;                      // Client: last delta read left the board as it is on the server
+    BoardRegion changed;                // Client: tiles written since the caller last emptied it, whole board after a reset
+    signed char boardMask[maxBoardHeight][maxBoardWidth];   // Client copy of GameState.boardMask
+} BoardSync;
+
+//----------------------------------------------------------------------------------
+// Board Sync Functions Declaration
+//----------------------------------------------------------------------------------
+TileCode GetTileCode(const GameState *game, int x, int y);
+void ResetBoardSync(BoardSync *sync, int width, int height);    // Client board hidden, next delta is a keyframe
+void InitBoardSync(BoardSync *sync, const GameState *game);     // Client board already is game (both sides built it from the seed)
+void InsertBoardSyncRows(BoardSync *sync, int row, int count);  // Server: the client board gets the hidden rows inserted in the board
+void InsertViewRows(BoardSync *sync, GameState *view, int row, int count);     // Client: same rows inserted in view, tiles below move down
+
+// Server: append deltas bringing the client board to game, returns true if it is up to date
+// NOTE: Stops before an operation the writer can not take, the rest goes with the next call
+bool WriteBoardDelta(BoardSync *sync, const GameState *game, NetWriter *writer, int tick);
+bool WriteOpponentDelta(BoardSync *sync, const GameState *game, NetWriter *writer, int tick, int player);   // Same, as MSG_OPPONENT_DELTA
+
+// Client: apply a MSG_BOARD_DELTA payload to view (board, boardMask and hp), false if malformed or
+// the checksum differs (ask for a keyframe). Only tiles that changed are written to view.
+// NOTE: MSG_OPPONENT_DELTA payloads are read the same once their player index is read
+bool ReadBoardDelta(BoardSync *sync, GameState *view, NetReader *payload);
+
+#endif // BOARD_SYNC_H
@@ -0,0 +1,802 @@
+/**********************************************************************************************
+*
+*   Minesweeper Clone - Bot Clients
+*
+*   Scripted match server players and the load test running them against a local server.
+*
+*   Copyright (c) 2024 (DoughnutDude)
+*
+**********************************************************************************************/
+
+#include "bot_client.h"
+#include "net.h"
+#include "net_protocol.h"
+#include "board_sync.h"
+
+#include <stdio.h>          // Required for: printf()
+#include <stdlib.h>         // Required for: malloc(), realloc(), free(), qsort()
+#include <string.h>         // Required for: memmove(), memset(), memcpy()
+#include <signal.h>         // Required for: signal(), SIGINT
+
+#include <atomic>
+#include <thread>
+#include <chrono>
+
+#define internal static
+#define global_var static
+
+#define BOT_OUTPUT_SIZE         256
+#define BOT_POLL_TIMEOUT        5       // Milliseconds a bot thread waits for socket activity
+#define BOT_ACTION_SIZE         (NET_MESSAGE_HEADER_SIZE + 7)
+#define BOT_LOAD_TEST_PORT      (SERVER_DEFAULT_PORT + 1)
+#define BOT_LOCKSTEP_HASH_HISTORY   64  // Steps a bot can trail the first bot of its thread to get them and still report their hash
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum BotState {
+    BOT_WAITING = 0,        // Joined, waiting for the match to start
+    BOT_PLAYING,
+    BOT_FINISHED,           // Board over, waiting for the match end
+    BOT_DONE,               // Disconnected
+} BotState;
+
+// What a bot knows of a tile besides the received board
+typedef enum BotTile {
+    BOT_TILE_UNTRIED = 0,
+    BOT_TILE_SAFE,          // Revealed, or reveal sent
+    BOT_TILE_MINE,          // Flag sent
+} BotTile;
+
+// Lockstep boards of a match, shared by the bots of a thread playing in it: they all get the same
+// steps, the first one to get a step applies it to every board, the others report the hash it got
+typedef struct BotLockstepMatch {
+    unsigned int id;
+    int playerCount;
+    int references;             // Bots playing in it, freed once none is left
+    int step;                   // Next step to apply
+    GameState *boards;          // One per player, seeded with GetMatchBoardSeed()
+    unsigned long long *boardHashes;
+    bool *hashStale;
+    int *changes;               // Per board, inputs that changed it
+    int *accepted;              // Per board, player inputs that changed it (garbage not counted)
+    unsigned int hashes[BOT_LOCKSTEP_HASH_HISTORY];     // After the last steps applied, by step%BOT_LOCKSTEP_HASH_HISTORY
+} BotLockstepMatch;
+
+typedef struct BotLockstepList {
+    BotLockstepMatch **matches;
+    int count;
+} BotLockstepList;
+
+typedef struct Bot {
+    NetSocket socket;
+    BotState state;
+    unsigned int random;
+    double joinTime;
+    double nextActionTime;
+
+    GameSettings settings;
+    int player;
+    PlayerStatus status;
+    bool won;               // Won the match, not only cleared its board
+    unsigned char tried[maxBoardHeight][maxBoardWidth];     // BotTile
+    int untriedCount;
+    int solverStart;        // Tile the solver looks at first, where it found its last action
+    BoardSync sync;
+    GameState view;         // Board as received from the server
+    BotLockstepMatch *lockstep;     // Lockstep matches, view is copied from its board of this player
+    int lockstepChanges;    // Changes of that board view has
+    int lockstepAccepted;   // Inputs of this player already counted accepted
+
+    unsigned int sequence;
+    unsigned int answered;  // Next sequence a result is expected for, results come in order
+    int pendingCount;
+    double sendTimes[BOT_MAX_PENDING_ACTIONS];      // By sequence%BOT_MAX_PENDING_ACTIONS
+    GameAction sent[BOT_MAX_PENDING_ACTIONS];       // Same, lockstep inputs are answered by the step relaying them
+
+    unsigned char input[NET_MESSAGE_HEADER_SIZE + NET_MAX_MESSAGE_SIZE];
+    int inputSize;
+    unsigned char output[BOT_OUTPUT_SIZE];
+    int outputSize;
+} Bot;
+
+typedef struct BotThreadResult {
+    float *roundTrips;      // Milliseconds
+    int roundTripCount;
+    int roundTripCapacity;
+    int actionCount;
+    int acceptedCount;
+    int droppedCount;       // Never answered: skipped by a later result, or timed out
+    int wonCount;
+    int clearedCount;
+    int lostCount;
+    int failedCount;        // Could not connect, or disconnected before the match end
+    int deltaCount;
+    int syncErrorCount;     // Board deltas that did not match their checksum
+    int opponentDeltaCount; // Not decoded, bots do not draw opponent boards
+    int desyncCount;        // Lockstep state hashes the server had another one for
+    long long bytesReceived;
+} BotThreadResult;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+global_var std::atomic<bool> botsRunning(false);
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions Definition
+//----------------------------------------------------------------------------------
+internal double GetSeconds(void)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+internal void StopBots(int signalId)
+{
+    (void)signalId;
+    botsRunning = false;
+}
+
+// xorshift32, bots do not need a reproducible sequence
+internal unsigned int GetBotRandom(Bot *bot)
+{
+    bot->random ^= bot->random << 13;
+    bot->random ^= bot->random >> 17;
+    bot->random ^= bot->random << 5;
+    return bot->random;
+}
+
+internal int CompareFloats(const void *a, const void *b)
+{
+    float fa = *(const float *)a;
+    float fb = *(const float *)b;
+    return (fa < fb)? -1 : (fa > fb)? 1 : 0;
+}
+
+internal void FreeBotLockstepMatch(BotLockstepMatch *match)
+{
+    free(match->boards);
+    free(match->boardHashes);
+    free(match->hashStale);
+    free(match->changes);
+    free(match->accepted);
+    free(match);
+}
+
+// Boards of the match for a bot starting it, generated by the first bot of the thread in it
+internal BotLockstepMatch *JoinBotLockstepMatch(BotLockstepList *list, unsigned int id, int playerCount, GameSettings settings)
+{
+    // Matches every bot left are freed here, bots only drop their reference
+    for (int i = list->count - 1; i >= 0; --i)
+    {
+        if (list->matches[i]->references > 0) continue;
+        FreeBotLockstepMatch(list->matches[i]);
+        list->matches[i] = list->matches[--list->count];
+    }
+
+    for (int i = 0; i < list->count; ++i)
+    {
+        BotLockstepMatch *match = list->matches[i];
+        if ((match->id != id) || (match->playerCount != playerCount)) continue;
+        ++match->references;
+        return match;
+    }
+
+    BotLockstepMatch *match = (BotLockstepMatch *)calloc(1, sizeof(BotLockstepMatch));
+    match->id = id;
+    match->playerCount = playerCount;
+    match->references = 1;
+    match->boards = (GameState *)malloc(playerCount*sizeof(GameState));
+    match->boardHashes = (unsigned long long *)malloc(playerCount*sizeof(unsigned long long));
+    match->hashStale = (bool *)calloc(playerCount, sizeof(bool));
+    match->changes = (int *)calloc(playerCount, sizeof(int));
+    match->accepted = (int *)calloc(playerCount, sizeof(int));
+    unsigned int matchSeed = settings.seed;
+    for (int i = 0; i < playerCount; ++i)
+    {
+        settings.seed = GetMatchBoardSeed(matchSeed, i);
+        InitGame(&match->boards[i], settings);
+        match->boardHashes[i] = GetGameStateHash(&match->boards[i]);
+    }
+
+    list->matches = (BotLockstepMatch **)realloc(list->matches, (list->count + 1)*sizeof(BotLockstepMatch *));
+    list->matches[list->count++] = match;
+    return match;
+}
+
+internal void RecordBotRoundTrip(BotThreadResult *result, double seconds)
+{
+    if (result->roundTripCount >= result->roundTripCapacity)
+    {
+        result->roundTripCapacity = (result->roundTripCapacity > 0)? 2*result->roundTripCapacity : 4096;
+        result->roundTrips = (float *)realloc(result->roundTrips, result->roundTripCapacity*sizeof(float));
+    }
+    result->roundTrips[result->roundTripCount++] = (float)(seconds*1000.0);
+}
+
+internal void CloseBot(Bot *bot, BotThreadResult *result)
+{
+    if (bot->state == BOT_DONE) return;
+
+    if (bot->lockstep != NULL) --bot->lockstep->references;
+    bot->lockstep = NULL;
+
+    if (bot->status == PLAYER_STATUS_WON) ++result->clearedCount;
+    else if (bot->status == PLAYER_STATUS_LOST) ++result->lostCount;
+    if (bot->won) ++result->wonCount;
+    if (bot->state != BOT_FINISHED) ++result->failedCount;
+
+    CloseSocket(bot->socket);
+    bot->socket = NET_INVALID_SOCKET;
+    bot->state = BOT_DONE;
+}
+
+internal void SendBotMessage(Bot *bot, NetWriter *writer)
+{
+    if (EndNetMessage(writer)) bot->outputSize = writer->size;
+}
+
+// Garbage rows grew the board to height, they are tried like the rest
+internal void GrowBotBoard(Bot *bot, int height)
+{
+    if (height <= bot->settings.height) return;
+
+    bot->untriedCount += (height - bot->settings.height)*bot->settings.width;
+    bot->settings.height = height;
+}
+
+// Own input relayed in a step, answers the oldest action sent like a result: inputs the server
+// dropped are skipped
+internal void AnswerBotLockstepInput(Bot *bot, GameAction action, BotThreadResult *result, double now)
+{
+    while (bot->pendingCount > 0)
+    {
+        unsigned int sequence = bot->answered++;
+        --bot->pendingCount;
+        GameAction sent = bot->sent[sequence%BOT_MAX_PENDING_ACTIONS];
+        if ((sent.type == action.type) && (sent.x == action.x) && (sent.y == action.y))
+        {
+            RecordBotRoundTrip(result, now - bot->sendTimes[sequence%BOT_MAX_PENDING_ACTIONS]);
+            return;
+        }
+        ++result->droppedCount;
+    }
+}
+
+// Inputs of a step: applied to the shared boards if no bot of the thread did yet, then the state
+// hash of the step is reported as a client would
+internal void HandleBotLockstepStep(Bot *bot, NetReader *payload, BotThreadResult *result, double now)
+{
+    BotLockstepMatch *match = bot->lockstep;
+    int step = (int)NetReadU32(payload);
+    int count = (int)NetReadU8(payload);
+    if (payload->overflow || (match == NULL) || (step > match->step)) return;
+
+    bool apply = (step == match->step);
+    for (int i = 0; i < count; ++i)
+    {
+        int index = (int)NetReadU8(payload);
+        GameAction action = { 0 };
+        action.tick = step*NET_LOCKSTEP_STEP_TICKS;
+        action.type = (GameActionType)NetReadU8(payload);
+        action.x = (int)NetReadU8(payload);
+        action.y = (int)NetReadU8(payload);
+        if (payload->overflow || (index >= match->playerCount)) break;
+
+        if ((index == bot->player) && (action.type != ACTION_GARBAGE)) AnswerBotLockstepInput(bot, action, result, now);
+        if (!apply) continue;
+
+        GameState *board = &match->boards[index];
+        board->tick = action.tick;
+        if (!ApplyGameAction(board, action)) continue;
+        match->hashStale[index] = true;
+        ++match->changes[index];
+        if (action.type != ACTION_GARBAGE) ++match->accepted[index];
+    }
+
+    if (apply)
+    {
+        for (int i = 0; i < match->playerCount; ++i)
+        {
+            if (match->hashStale[i]) match->boardHashes[i] = GetGameStateHash(&match->boards[i]);
+            match->hashStale[i] = false;
+        }
+        match->hashes[step%BOT_LOCKSTEP_HASH_HISTORY] = GetLockstepHash(match->boardHashes, match->playerCount);
+        ++match->step;
+    }
+
+    if (match->step - step <= BOT_LOCKSTEP_HASH_HISTORY)
+    {
+        NetWriter writer = { bot->output, BOT_OUTPUT_SIZE, bot->outputSize, 0, false };
+        BeginNetMessage(&writer, MSG_LOCKSTEP_HASH);
+        NetWriteU32(&writer, (unsigned int)step);
+        NetWriteU32(&writer, match->hashes[step%BOT_LOCKSTEP_HASH_HISTORY]);
+        SendBotMessage(bot, &writer);
+    }
+
+    // NOTE: The shared boards may be a few steps ahead of what this bot received, it plays on them anyway
+    if (bot->lockstepChanges != match->changes[bot->player])
+    {
+        bot->view = match->boards[bot->player];
+        bot->lockstepChanges = match->changes[bot->player];
+        GrowBotBoard(bot, bot->view.height);
+    }
+    result->acceptedCount += match->accepted[bot->player] - bot->lockstepAccepted;
+    bot->lockstepAccepted = match->accepted[bot->player];
+}
+
+internal void HandleBotMessage(Bot *bot, NetMessageType type, NetReader *payload, BotLockstepList *lockstep, BotThreadResult *result, double now)
+{
+    switch (type)
+    {
+        case MSG_MATCH_START:
+        {
+            unsigned int id = NetReadU32(payload);
+            bot->player = (int)NetReadU8(payload);
+            int count = (int)NetReadU8(payload);
+            bot->settings = NetReadGameSettings(payload);
+            bot->settings.seed = NetReadU32(payload);
+            MatchMode mode = (MatchMode)NetReadU8(payload);
+            if (payload->overflow || (bot->settings.width > maxBoardWidth) || (bot->settings.height > maxBoardHeight) || (bot->player >= count)) break;
+
+            memset(bot->tried, BOT_TILE_UNTRIED, sizeof(bot->tried));
+            bot->untriedCount = bot->settings.width*bot->settings.height;
+            bot->solverStart = 0;
+
+            // NOTE: A race board is never sent, it is generated and opened here as on the server
+            if (mode == MATCH_MODE_RACE)
+            {
+                InitGame(&bot->view, bot->settings);
+                OpenGame(&bot->view);
+                InitBoardSync(&bot->sync, &bot->view);
+            }
+            else if ((mode == MATCH_MODE_LOCKSTEP) && (bot->lockstep == NULL))
+            {
+                bot->lockstep = JoinBotLockstepMatch(lockstep, id, count, bot->settings);
+                bot->view = bot->lockstep->boards[bot->player];
+                bot->lockstepChanges = bot->lockstep->changes[bot->player];
+                bot->lockstepAccepted = bot->lockstep->accepted[bot->player];
+            }
+            else ResetBoardSync(&bot->sync, bot->settings.width, bot->settings.height);
+            bot->state = BOT_PLAYING;
+            bot->nextActionTime = now;
+        } break;
+        case MSG_ACTION_RESULT:
+        {
+            unsigned int sequence = NetReadU32(payload);
+            bool accepted = (NetReadU8(payload) != 0);
+            if (payload->overflow || (sequence < bot->answered) || (sequence >= bot->sequence)) break;
+
+            // NOTE: The server drops actions when the match queue is full, they are never answered
+            int skipped = (int)(sequence - bot->answered);
+            result->droppedCount += skipped;
+            bot->pendingCount -= skipped + 1;
+            bot->answered = sequence + 1;
+
+            RecordBotRoundTrip(result, now - bot->sendTimes[sequence%BOT_MAX_PENDING_ACTIONS]);
+            if (accepted) ++result->acceptedCount;
+        } break;
+        case MSG_PLAYER_STATUS:
+        {
+            int player = (int)NetReadU8(payload);
+            PlayerStatus status = (PlayerStatus)NetReadU8(payload);
+            if (!payload->overflow && (player == bot->player))
+            {
+                bot->status = status;
+                if (bot->state == BOT_PLAYING) bot->state = BOT_FINISHED;
+            }
+        } break;
+        case MSG_BOARD_DELTA:
+        {
+            ++result->deltaCount;
+            if (!ReadBoardDelta(&bot->sync, &bot->view, payload))
+            {
+                ++result->syncErrorCount;
+
+                NetWriter writer = { bot->output, BOT_OUTPUT_SIZE, bot->outputSize, 0, false };
+                BeginNetMessage(&writer, MSG_SYNC_REQUEST);
+                NetWriteU8(&writer, (unsigned int)bot->player);
+                SendBotMessage(bot, &writer);
+            }
+        } break;
+        case MSG_OPPONENT_DELTA: ++result->opponentDeltaCount; break;
+        case MSG_GARBAGE:
+        {
+            // NOTE: Only the own board is received, the same hidden rows are added to it before the next delta
+            int board = (int)NetReadU8(payload);
+            NetReadU32(payload);
+            int rows = (int)NetReadU8(payload);
+            NetReadU8(payload);
+            if (payload->overflow || (board != bot->player) || (bot->sync.height + rows > maxBoardHeight)) break;
+
+            InsertViewRows(&bot->sync, &bot->view, bot->sync.height, rows);
+            GrowBotBoard(bot, bot->sync.height);
+        } break;
+        case MSG_LOCKSTEP_STEP: HandleBotLockstepStep(bot, payload, result, now); break;
+        case MSG_LOCKSTEP_DESYNC: ++result->desyncCount; break;
+        case MSG_MATCH_END:
+        {
+            int winner = (int)NetReadU8(payload);
+            bot->won = (winner == bot->player);
+            bot->state = BOT_FINISHED;
+            CloseBot(bot, result);
+        } break;
+        default: break;
+    }
+}
+
+internal void MarkBotTile(Bot *bot, int x, int y, BotTile tile)
+{
+    if (bot->tried[y][x] == BOT_TILE_UNTRIED) --bot->untriedCount;
+    bot->tried[y][x] = (unsigned char)tile;
+}
+
+// Random tile not tried yet and still hidden on the received board
+internal bool FindRandomReveal(Bot *bot, GameAction *action)
+{
+    while (bot->untriedCount > 0)
+    {
+        int index = (int)(GetBotRandom(bot)%(unsigned int)(bot->settings.width*bot->settings.height));
+        int x = index%bot->settings.width;
+        int y = index/bot->settings.width;
+        if (bot->tried[y][x] != BOT_TILE_UNTRIED) continue;
+
+        MarkBotTile(bot, x, y, BOT_TILE_SAFE);
+        if (bot->view.boardMask[y][x] != 1) continue;     // Revealed or flagged already
+
+        action->type = ACTION_REVEAL;
+        action->x = x;
+        action->y = y;
+        return true;
+    }
+
+    return false;
+}
+
+// First clue of the received board that proves its untried neighbors are all mines (flag one)
+// or all safe (chord it), flags sent count as placed
+internal bool FindSolverAction(Bot *bot, GameAction *action)
+{
+    const GameState *view = &bot->view;
+    int tileCount = bot->settings.width*bot->settings.height;
+    for (int i = 0; i < tileCount; ++i)
+    {
+        int index = (bot->solverStart + i)%tileCount;
+        int x = index%bot->settings.width;
+        int y = index/bot->settings.width;
+        if ((view->boardMask[y][x] != 0) || (view->board[y][x] <= 0)) continue;
+
+        int mines = 0;
+        int untried = 0;
+        int untriedX = 0;
+        int untriedY = 0;
+        for (int neighborY = y - 1; neighborY <= y + 1; ++neighborY)
+        {
+            for (int neighborX = x - 1; neighborX <= x + 1; ++neighborX)
+            {
+                if ((neighborX < 0) || (neighborX >= bot->settings.width) || (neighborY < 0) || (neighborY >= bot->settings.height)) continue;
+
+                signed char mask = view->boardMask[neighborY][neighborX];
+                unsigned char tried = bot->tried[neighborY][neighborX];
+                if ((mask == 2) || ((mask == 0) && (view->board[neighborY][neighborX] < 0)) || ((mask == 1) && (tried == BOT_TILE_MINE))) ++mines;
+                else if ((mask == 1) && (tried == BOT_TILE_UNTRIED))
+                {
+                    ++untried;
+                    untriedX = neighborX;
+                    untriedY = neighborY;
+                }
+            }
+        }
+        if (untried == 0) continue;
+
+        if (view->board[y][x] - mines == untried)
+        {
+            MarkBotTile(bot, untriedX, untriedY, BOT_TILE_MINE);
+            action->type = ACTION_FLAG;
+            action->x = untriedX;
+            action->y = untriedY;
+        }
+        else if (view->board[y][x] == mines)
+        {
+            for (int neighborY = y - 1; neighborY <= y + 1; ++neighborY)
+            {
+                for (int neighborX = x - 1; neighborX <= x + 1; ++neighborX)
+                {
+                    if ((neighborX < 0) || (neighborX >= bot->settings.width) || (neighborY < 0) || (neighborY >= bot->settings.height)) continue;
+                    if ((view->boardMask[neighborY][neighborX] == 1) && (bot->tried[neighborY][neighborX] == BOT_TILE_UNTRIED)) MarkBotTile(bot, neighborX, neighborY, BOT_TILE_SAFE);
+                }
+            }
+            action->type = ACTION_CHORD;
+            action->x = x;
+            action->y = y;
+        }
+        else continue;
+
+        bot->solverStart = index;
+        return true;
+    }
+
+    return false;
+}
+
+internal void UpdateBot(Bot *bot, bool readable, float actionsPerSecond, BotPolicy policy, BotLockstepList *lockstep, BotThreadResult *result, double now)
+{
+    if (readable)
+    {
+        int received = ReceiveSocket(bot->socket, bot->input + bot->inputSize, (int)sizeof(bot->input) - bot->inputSize);
+        if (received < 0)
+        {
+            CloseBot(bot, result);
+            return;
+        }
+        bot->inputSize += received;
+        result->bytesReceived += received;
+
+        int offset = 0;
+        for (;;)
+        {
+            NetMessageType type = (NetMessageType)0;
+            NetReader payload = { 0 };
+            int size = ReadNetMessage(bot->input + offset, bot->inputSize - offset, &type, &payload);
+            if (size < 0)
+            {
+                CloseBot(bot, result);
+                return;
+            }
+            if (size == 0) break;
+
+            HandleBotMessage(bot, type, &payload, lockstep, result, now);
+            if (bot->state == BOT_DONE) return;
+            offset += size;
+        }
+
+        memmove(bot->input, bot->input + offset, bot->inputSize - offset);
+        bot->inputSize -= offset;
+    }
+
+    if ((bot->state == BOT_WAITING) && (now - bot->joinTime > BOT_CONNECT_TIMEOUT))
+    {
+        CloseBot(bot, result);
+        return;
+    }
+
+    // Actions dropped last are not followed by any result
+    while ((bot->pendingCount > 0) && (now - bot->sendTimes[bot->answered%BOT_MAX_PENDING_ACTIONS] > BOT_ACTION_TIMEOUT))
+    {
+        ++result->droppedCount;
+        --bot->pendingCount;
+        ++bot->answered;
+    }
+
+    while ((bot->state == BOT_PLAYING) && (now >= bot->nextActionTime) && (bot->pendingCount < BOT_MAX_PENDING_ACTIONS) &&
+           (bot->outputSize + BOT_ACTION_SIZE <= BOT_OUTPUT_SIZE))
+    {
+        GameAction action = { 0 };
+        bool found = (policy == BOT_POLICY_SOLVER) && FindSolverAction(bot, &action);
+        if (!found) found = FindRandomReveal(bot, &action);
+        if (!found) break;
+
+        NetWriter writer = { bot->output, BOT_OUTPUT_SIZE, bot->outputSize, 0, false };
+        BeginNetMessage(&writer, MSG_ACTION);
+        NetWriteU32(&writer, bot->sequence);
+        NetWriteU8(&writer, (unsigned int)action.type);
+        NetWriteU8(&writer, (unsigned int)action.x);
+        NetWriteU8(&writer, (unsigned int)action.y);
+        SendBotMessage(bot, &writer);
+
+        bot->sendTimes[bot->sequence%BOT_MAX_PENDING_ACTIONS] = now;
+        bot->sent[bot->sequence%BOT_MAX_PENDING_ACTIONS] = action;
+        ++bot->sequence;
+        ++bot->pendingCount;
+        ++result->actionCount;
+        bot->nextActionTime += 1.0/actionsPerSecond;
+    }
+
+    if (bot->outputSize > 0)
+    {
+        int sent = SendSocket(bot->socket, bot->output, bot->outputSize);
+        if (sent < 0)
+        {
+            CloseBot(bot, result);
+            return;
+        }
+        memmove(bot->output, bot->output + sent, bot->outputSize - sent);
+        bot->outputSize -= sent;
+    }
+}
+
+internal void BotThread(BotSettings settings, int firstBot, int botCount, BotThreadResult *result)
+{
+    Bot *bots = (Bot *)calloc(botCount, sizeof(Bot));
+    NetPollEntry *entries = (NetPollEntry *)calloc(botCount, sizeof(NetPollEntry));
+    int *polled = (int *)calloc(botCount, sizeof(int));
+    BotLockstepList lockstep = { 0 };
+
+    for (int i = 0; i < botCount; ++i)
+    {
+        Bot *bot = &bots[i];
+        bot->random = 2463534242u ^ ((unsigned int)(firstBot + i + 1)*2654435761u);
+        bot->player = NET_NO_PLAYER;
+        bot->socket = ConnectSocket(settings.host, settings.port);
+        bot->joinTime = GetSeconds();
+        if (bot->socket == NET_INVALID_SOCKET)
+        {
+            bot->state = BOT_DONE;
+            ++result->failedCount;
+            continue;
+        }
+
+        NetWriter writer = { bot->output, BOT_OUTPUT_SIZE, 0, 0, false };
+        BeginNetMessage(&writer, MSG_JOIN);
+        NetWriteU8(&writer, NET_PROTOCOL_VERSION);
+        NetWriteU16(&writer, (unsigned int)(NET_DEFAULT_RATING - settings.ratingSpread/2 + (int)(bot->random%(settings.ratingSpread + 1))));
+        NetWriteGameSettings(&writer, GameSettings{ 0 });   // The server board
+        SendBotMessage(bot, &writer);
+    }
+
+    while (botsRunning)
+    {
+        int count = 0;
+        for (int i = 0; i < botCount; ++i)
+        {
+            if (bots[i].state == BOT_DONE) continue;
+            entries[count].socket = bots[i].socket;
+            polled[count++] = i;
+        }
+        if (count == 0) break;
+
+        PollSockets(entries, count, BOT_POLL_TIMEOUT);
+
+        double now = GetSeconds();
+        for (int i = 0; i < count; ++i)
+        {
+            UpdateBot(&bots[polled[i]], entries[i].readable || entries[i].closed, settings.actionsPerSecond, settings.policy, &lockstep, result, now);
+        }
+    }
+
+    for (int i = 0; i < botCount; ++i) CloseBot(&bots[i], result);
+    for (int i = 0; i < lockstep.count; ++i) FreeBotLockstepMatch(lockstep.matches[i]);
+    free(lockstep.matches);
+    free(polled);
+    free(entries);
+    free(bots);
+}
+
+//----------------------------------------------------------------------------------
+// Bot Clients Functions Definition
+//----------------------------------------------------------------------------------
+BotSettings GetDefaultBotSettings(void)
+{
+    BotSettings settings = { 0 };
+    settings.host = "127.0.0.1";
+    settings.port = SERVER_DEFAULT_PORT;
+    settings.botCount = SERVER_MAX_PLAYERS;
+    settings.actionsPerSecond = 4.0f;
+    settings.policy = BOT_POLICY_RANDOM;
+    settings.ratingSpread = 0;
+
+    return settings;
+}
+
+BotPolicy GetBotPolicy(const char *name)
+{
+    return ((name != NULL) && (strcmp(name, "solver") == 0))? BOT_POLICY_SOLVER : BOT_POLICY_RANDOM;
+}
+
+int RunBotClients(BotSettings settings)
+{
+    if (!InitNetwork())
+    {
+        printf("bots: network initialization failed\n");
+        return 1;
+    }
+    if (settings.botCount < 1) settings.botCount = 1;
+    if (settings.actionsPerSecond <= 0.0f) settings.actionsPerSecond = 1.0f;
+    int botCount = settings.botCount;
+
+    botsRunning = true;
+    signal(SIGINT, StopBots);
+
+    int threadCount = (botCount + BOT_THREAD_BOTS - 1)/BOT_THREAD_BOTS;
+    std::thread *threads = new std::thread[threadCount];
+    BotThreadResult *results = (BotThreadResult *)calloc(threadCount, sizeof(BotThreadResult));
+
+    printf("bots: %i %s bots on %s:%i, %.1f actions/s each, %i threads\n", botCount, (settings.policy == BOT_POLICY_SOLVER)? "solver" : "random",
+           settings.host, settings.port, settings.actionsPerSecond, threadCount);
+    double startTime = GetSeconds();
+
+    for (int i = 0; i < threadCount; ++i)
+    {
+        int firstBot = i*BOT_THREAD_BOTS;
+        int count = (botCount - firstBot < BOT_THREAD_BOTS)? botCount - firstBot : BOT_THREAD_BOTS;
+        threads[i] = std::thread(BotThread, settings, firstBot, count, &results[i]);
+    }
+    for (int i = 0; i < threadCount; ++i) threads[i].join();
+
+    double endTime = GetSeconds();
+
+    // Merge every thread results
+    BotThreadResult total = { 0 };
+    for (int i = 0; i < threadCount; ++i) total.roundTripCount += results[i].roundTripCount;
+    total.roundTrips = (float *)malloc((total.roundTripCount + 1)*sizeof(float));
+    total.roundTripCount = 0;
+    for (int i = 0; i < threadCount; ++i)
+    {
+        memcpy(total.roundTrips + total.roundTripCount, results[i].roundTrips, results[i].roundTripCount*sizeof(float));
+        total.roundTripCount += results[i].roundTripCount;
+        total.actionCount += results[i].actionCount;
+        total.acceptedCount += results[i].acceptedCount;
+        total.droppedCount += results[i].droppedCount;
+        total.wonCount += results[i].wonCount;
+        total.clearedCount += results[i].clearedCount;
+        total.lostCount += results[i].lostCount;
+        total.failedCount += results[i].failedCount;
+        total.deltaCount += results[i].deltaCount;
+        total.syncErrorCount += results[i].syncErrorCount;
+        total.opponentDeltaCount += results[i].opponentDeltaCount;
+        total.desyncCount += results[i].desyncCount;
+        total.bytesReceived += results[i].bytesReceived;
+        free(results[i].roundTrips);
+    }
+    qsort(total.roundTrips, total.roundTripCount, sizeof(float), CompareFloats);
+
+    printf("bots: done in %.3fs, %i actions (%i accepted, %i answered, %i dropped)\n", endTime - startTime,
+           total.actionCount, total.acceptedCount, total.roundTripCount, total.droppedCount);
+    printf("bots: %i match wins, %i boards cleared, %i boards lost, %i failed\n",
+           total.wonCount, total.clearedCount, total.lostCount, total.failedCount);
+    printf("bots: %i board deltas, %i checksum mismatches, %i opponent deltas, %i lockstep desyncs, %.2f KB/s received per bot\n", total.deltaCount,
+           total.syncErrorCount, total.opponentDeltaCount, total.desyncCount, total.bytesReceived/1024.0/(endTime - startTime)/botCount);
+    if (total.roundTripCount > 0)
+    {
+        float *rtt = total.roundTrips;
+        int n = total.roundTripCount;
+        printf("bots: action round trip p50 %.2fms, p90 %.2fms, p99 %.2fms, max %.2fms\n",
+               rtt[n*50/100], rtt[n*90/100], rtt[n*99/100], rtt[n - 1]);
+    }
+
+    free(total.roundTrips);
+    free(results);
+    delete[] threads;
+    CloseNetwork();
+
+    return ((total.failedCount == 0) && (total.syncErrorCount == 0) && (total.desyncCount == 0))? 0 : 1;
+}
+
+int RunLoadTest(ServerSettings server, BotSettings bots)
+{
+    server.port = BOT_LOAD_TEST_PORT;
+    bots.host = "127.0.0.1";
+    bots.port = server.port;
+
+    std::thread serverThread(RunMatchServer, server);
+    double waitStart = GetSeconds();
+    while (!IsMatchServerRunning() && (GetSeconds() - waitStart < BOT_CONNECT_TIMEOUT)) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    if (!IsMatchServerRunning())
+    {
+        printf("load test: server did not start\n");
+        StopMatchServer();
+        serverThread.join();
+        return 2;
+    }
+
+    // NOTE: Bots take over Ctrl+C, the server is stopped once they are done
+    ResetServerLoadStats();
+    int result = RunBotClients(bots);
+    ServerLoadStats stats = GetServerLoadStats();
+    StopMatchServer();
+    serverThread.join();
+
+    long long players = (stats.playersJoined > 0)? stats.playersJoined : 1;
+    printf("load test: %lli players in %.1fs, %lli worker frames\n", stats.playersJoined, stats.seconds, stats.ticks);
+    printf("load test: worker frame p50 %.2fms, p90 %.2fms, p99 %.2fms, max %.2fms (%.2fms per frame at %i Hz)\n",
+           stats.tickP50, stats.tickP90, stats.tickP99, stats.tickMax, 1000.0/SERVER_FRAME_RATE, SERVER_FRAME_RATE);
+    printf("load test: %lli worker frames over the %.1fms tick budget, longest match update %.2fms, %lli matches moved between workers\n",
+           stats.tickOverruns, server.tickBudget, stats.matchCostMax, stats.matchesMoved);
+    printf("load test: match queue depth mean %.2f, max %i (%i events per match), %.2fs waited for a match on average\n",
+           stats.queueDepthMean, stats.queueDepthMax, SERVER_EVENT_QUEUE_SIZE, stats.queueWaitMean);
+    printf("load test: %lli actions received, %lli applied, %lli dropped by the server\n", stats.actionsReceived, stats.actionsApplied, stats.actionsDropped);
+    printf("load test: %.1f KB sent per player, %.2f KB/s per player\n", stats.bytesSent/1024.0/players,
+           (stats.seconds > 0.0)? stats.bytesSent/1024.0/stats.seconds/players : 0.0);
+
+    return result;
+}
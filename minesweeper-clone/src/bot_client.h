@@ -0,0 +1,70 @@
+/**********************************************************************************************
+*
+*   Minesweeper Clone - Bot Clients
+*
+*   Scripted players for the match server: each bot connects, queues for a match with its own
+*   rating (spread around NET_DEFAULT_RATING) and plays at a fixed rate until its board is over,
+*   then leaves once the match ends. A race board is generated from the match seed and opened
+*   as the server does, only its deltas are received. In a lockstep match the bots of a thread
+*   playing in it share one copy of every board: the first to get a step applies its inputs,
+*   each bot reports the state hash of every step as a client does. Bots are spread
+*   over a few threads polling their sockets, a summary (results, action round trips,
+*   actions the server never answered) is printed when every bot is done.
+*
+*   Policies:
+*       BOT_POLICY_RANDOM   reveal random tiles still hidden on the received board
+*       BOT_POLICY_SOLVER   flag and chord what single clues prove, random reveal otherwise,
+*                           boards last longer and take every kind of action
+*
+*   A load test runs a match server on its own threads and bots against it over loopback,
+*   then reports the server side of the run: worker frame time percentiles and frames over the
+*   tick budget, match costs and moves between workers, match queue depths, time spent waiting
+*   for a match, bytes sent per player and dropped actions.
+*
+*   Copyright (c) 2024 (DoughnutDude)
+*
+**********************************************************************************************/
+
+#ifndef BOT_CLIENT_H
+#define BOT_CLIENT_H
+
+#include "game_server.h"    // Required for: ServerSettings
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define BOT_THREAD_BOTS             256     // Bots driven by a single thread
+#define BOT_MAX_PENDING_ACTIONS     32      // Actions sent and not answered yet before a bot waits
+#define BOT_CONNECT_TIMEOUT         30.0    // Seconds a bot waits for its match to start
+#define BOT_ACTION_TIMEOUT          2.0     // Seconds before an unanswered action is counted dropped
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum BotPolicy {
+    BOT_POLICY_RANDOM = 0,
+    BOT_POLICY_SOLVER,
+} BotPolicy;
+
+typedef struct BotSettings {
+    const char *host;           // IPv4 address
+    int port;
+    int botCount;
+    float actionsPerSecond;     // Per bot
+    BotPolicy policy;
+    int ratingSpread;           // Bot ratings are spread over NET_DEFAULT_RATING +/- ratingSpread/2
+} BotSettings;
+
+//----------------------------------------------------------------------------------
+// Bot Clients Functions Declaration
+//----------------------------------------------------------------------------------
+BotSettings GetDefaultBotSettings(void);    // Localhost, default server port, a full match of random bots of the same rating
+BotPolicy GetBotPolicy(const char *name);   // "solver" or "random" (default)
+
+// Run bots against a server until they all finished their match (or Ctrl+C), returns the process exit code
+int RunBotClients(BotSettings settings);
+
+// Run a server and bots against it in this process, bots.host and bots.port are ignored
+int RunLoadTest(ServerSettings server, BotSettings bots);
+
+#endif // BOT_CLIENT_H
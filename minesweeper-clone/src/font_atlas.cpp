@@ -0,0 +1,203 @@
+/**********************************************************************************************
+*
+*   Minesweeper Clone - Font Atlases
+*
+*   Glyph atlases baked at build time for every text size the game uses.
+*
+*   Copyright (c) 2024 (DoughnutDude)
+*
+**********************************************************************************************/
+
+#include "font_atlas.h"
+
+#include <stdio.h>          // Required for: FILE, fopen(), fwrite(), fclose()
+#include <stdlib.h>         // Required for: malloc(), calloc(), free() (RL_MALLOC, RL_CALLOC, RL_FREE)
+#include <string.h>         // Required for: memcmp(), memset()
+
+#define internal static
+
+#define FONT_ATLAS_HEADER_SIZE  12
+#define FONT_ATLAS_INFO_SIZE    20
+#define FONT_ATLAS_GLYPH_SIZE   32
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions Definition
+//----------------------------------------------------------------------------------
+internal bool WriteI32(FILE *file, int value)
+{
+    unsigned char bytes[4];
+    for (int i = 0; i < 4; ++i) bytes[i] = (unsigned char)((unsigned int)value >> (8*i));
+    return (fwrite(bytes, 1, 4, file) == 4);
+}
+
+internal int ReadI32(const unsigned char *data)
+{
+    return (int)((unsigned int)data[0] | ((unsigned int)data[1] << 8) | ((unsigned int)data[2] << 16) | ((unsigned int)data[3] << 24));
+}
+
+internal bool WriteFontAtlas(FILE *file, const unsigned char *ttfData, int ttfSize, int fontSize)
+{
+    GlyphInfo *glyphs = LoadFontData(ttfData, ttfSize, fontSize, NULL, FONT_ATLAS_GLYPHS, FONT_DEFAULT);
+    if (glyphs == NULL) return false;
+
+    Rectangle *recs = NULL;
+    Image atlas = GenImageFontAtlas(glyphs, &recs, FONT_ATLAS_GLYPHS, fontSize, FONT_ATLAS_PADDING, 0);
+    bool result = (atlas.data != NULL) && (atlas.format == PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA);
+
+    int info[5] = { fontSize, FONT_ATLAS_GLYPHS, FONT_ATLAS_PADDING, atlas.width, atlas.height };
+    for (int i = 0; result && (i < 5); ++i) result = WriteI32(file, info[i]);
+
+    for (int i = 0; result && (i < FONT_ATLAS_GLYPHS); ++i)
+    {
+        int glyph[8] = { glyphs[i].value, glyphs[i].offsetX, glyphs[i].offsetY, glyphs[i].advanceX,
+                         (int)recs[i].x, (int)recs[i].y, (int)recs[i].width, (int)recs[i].height };
+        for (int j = 0; result && (j < 8); ++j) result = WriteI32(file, glyph[j]);
+    }
+
+    size_t pixelsSize = (size_t)atlas.width*atlas.height*2;
+    if (result) result = (fwrite(atlas.data, 1, pixelsSize, file) == pixelsSize);
+
+    UnloadImage(atlas);
+    RL_FREE(recs);
+    UnloadFontData(glyphs, FONT_ATLAS_GLYPHS);
+
+    return result;
+}
+
+//----------------------------------------------------------------------------------
+// Font Atlas Functions Definition
+//----------------------------------------------------------------------------------
+bool BakeFontAtlases(const char *ttfFileName, const char *fileName)
+{
+    const int sizes[] = FONT_ATLAS_SIZES;
+    const int sizeCount = (int)(sizeof(sizes)/sizeof(sizes[0]));
+
+    int ttfSize = 0;
+    unsigned char *ttfData = LoadFileData(ttfFileName, &ttfSize);
+    FILE *file = fopen(fileName, "wb");
+    bool result = (ttfData != NULL) && (file != NULL);
+
+    if (result) result = (fwrite("MSFA", 1, 4, file) == 4) && WriteI32(file, FONT_ATLAS_VERSION) && WriteI32(file, sizeCount);
+    for (int i = 0; result && (i < sizeCount); ++i) result = WriteFontAtlas(file, ttfData, ttfSize, sizes[i]);
+
+    if (file != NULL) result = (fclose(file) == 0) && result;
+    UnloadFileData(ttfData);
+
+    return result;
+}
+
+bool DecodeFontAtlasSet(FontAtlasSet *set, const unsigned char *data, int dataSize)
+{
+    memset(set, 0, sizeof(FontAtlasSet));
+    if ((data == NULL) || (dataSize < FONT_ATLAS_HEADER_SIZE) || (memcmp(data, "MSFA", 4) != 0) ||
+        (ReadI32(data + 4) != FONT_ATLAS_VERSION)) return false;
+
+    int atlasCount = ReadI32(data + 8);
+    int offset = FONT_ATLAS_HEADER_SIZE;
+    bool result = (atlasCount > 0) && (atlasCount <= FONT_ATLAS_MAX_SIZES);
+
+    for (int i = 0; result && (i < atlasCount); ++i)
+    {
+        result = (dataSize - offset >= FONT_ATLAS_INFO_SIZE);
+        if (!result) break;
+
+        const unsigned char *info = data + offset;
+        int glyphCount = ReadI32(info + 4);
+        int width = ReadI32(info + 12);
+        int height = ReadI32(info + 16);
+        result = (glyphCount > 0) && (glyphCount <= 0xffff) && (width > 0) && (height > 0) && (width <= 8192) && (height <= 8192) &&
+                 ((long long)dataSize - offset - FONT_ATLAS_INFO_SIZE >= (long long)glyphCount*FONT_ATLAS_GLYPH_SIZE + (long long)width*height*2);
+        if (!result) break;
+
+        Font *font = &set->fonts[i];
+        font->baseSize = ReadI32(info);
+        font->glyphCount = glyphCount;
+        font->glyphPadding = ReadI32(info + 8);
+        font->glyphs = (GlyphInfo *)RL_CALLOC(glyphCount, sizeof(GlyphInfo));
+        font->recs = (Rectangle *)RL_MALLOC(glyphCount*sizeof(Rectangle));
+        ++set->count;
+
+        const unsigned char *glyph = info + FONT_ATLAS_INFO_SIZE;
+        for (int j = 0; j < glyphCount; ++j, glyph += FONT_ATLAS_GLYPH_SIZE)
+        {
+            // NOTE: Glyph images are left empty, they are only needed by ImageDrawText()
+            font->glyphs[j].value = ReadI32(glyph);
+            font->glyphs[j].offsetX = ReadI32(glyph + 4);
+            font->glyphs[j].offsetY = ReadI32(glyph + 8);
+            font->glyphs[j].advanceX = ReadI32(glyph + 12);
+            font->recs[j] = { (float)ReadI32(glyph + 16), (float)ReadI32(glyph + 20), (float)ReadI32(glyph + 24), (float)ReadI32(glyph + 28) };
+        }
+
+        // Pixels are uploaded straight from the baked data, no copy
+        set->atlases[i] = { (void *)glyph, width, height, 1, PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA };
+        offset += FONT_ATLAS_INFO_SIZE + glyphCount*FONT_ATLAS_GLYPH_SIZE + width*height*2;
+    }
+
+    // Baked sizes must be sorted for GetFontForSize()
+    for (int i = 1; result && (i < set->count); ++i) result = (set->fonts[i - 1].baseSize < set->fonts[i].baseSize);
+
+    if (!result) UnloadFontAtlasSet(set);
+    return result;
+}
+
+bool DecodeFontAtlasSetTTF(FontAtlasSet *set, const unsigned char *data, int dataSize)
+{
+    memset(set, 0, sizeof(FontAtlasSet));
+    if (data == NULL) return false;
+
+    Font *font = &set->fonts[0];
+    font->glyphs = LoadFontData(data, dataSize, FONT_ATLAS_BASE_SIZE, NULL, FONT_ATLAS_GLYPHS, FONT_DEFAULT);
+    if (font->glyphs == NULL) return false;
+
+    font->baseSize = FONT_ATLAS_BASE_SIZE;
+    font->glyphCount = FONT_ATLAS_GLYPHS;
+    font->glyphPadding = FONT_ATLAS_PADDING;
+    set->atlases[0] = GenImageFontAtlas(font->glyphs, &font->recs, FONT_ATLAS_GLYPHS, FONT_ATLAS_BASE_SIZE, FONT_ATLAS_PADDING, 0);
+    set->atlasOwned[0] = true;
+    set->count = 1;
+
+    return true;
+}
+
+bool UploadFontAtlas(FontAtlasSet *set)
+{
+    if (set->uploaded < set->count)
+    {
+        int index = set->uploaded;
+        set->fonts[index].texture = LoadTextureFromImage(set->atlases[index]);
+
+        if (set->atlasOwned[index]) UnloadImage(set->atlases[index]);
+        set->atlases[index] = { 0 };
+        set->atlasOwned[index] = false;
+        ++set->uploaded;
+    }
+
+    return (set->uploaded == set->count);
+}
+
+void UnloadFontAtlasSet(FontAtlasSet *set)
+{
+    for (int i = 0; i < set->count; ++i)
+    {
+        if (i < set->uploaded) UnloadFont(set->fonts[i]);
+        else
+        {
+            UnloadFontData(set->fonts[i].glyphs, set->fonts[i].glyphCount);
+            RL_FREE(set->fonts[i].recs);
+            if (set->atlasOwned[i]) UnloadImage(set->atlases[i]);
+        }
+    }
+    memset(set, 0, sizeof(FontAtlasSet));
+}
+
+Font GetFontForSize(const FontAtlasSet *set, float fontSize)
+{
+    if (set->uploaded == 0) return GetFontDefault();
+
+    for (int i = 0; i < set->uploaded; ++i)
+    {
+        if ((float)set->fonts[i].baseSize >= fontSize) return set->fonts[i];
+    }
+
+    return set->fonts[set->uploaded - 1];
+}
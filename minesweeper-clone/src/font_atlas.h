@@ -0,0 +1,56 @@
+/**********************************************************************************************
+*
+*   Minesweeper Clone - Font Atlases
+*
+*   Glyph atlases baked at build time (--bake-fonts) for every text size the game uses, so
+*   startup only uploads textures instead of rasterizing a TTF, and text is drawn from the
+*   atlas closest to its size on screen instead of scaling a single one.
+*
+*   Baked file format (little-endian):
+*       "MSFA", u32 version, u32 atlas count
+*       per atlas: u32 base size, glyph count, glyph padding, width, height
+*                  glyphs: i32 value, offsetX, offsetY, advanceX, rec x, y, width, height
+*                  pixels: width*height GRAY_ALPHA
+*
+*   Copyright (c) 2024 (DoughnutDude)
+*
+**********************************************************************************************/
+
+#ifndef FONT_ATLAS_H
+#define FONT_ATLAS_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define FONT_ATLAS_VERSION      1
+#define FONT_ATLAS_MAX_SIZES    8
+#define FONT_ATLAS_SIZES        { 16, 20, 24, 32, 48, 64 }      // Pixel sizes baked: UI text and board digits from 0.5x to 2x zoom
+#define FONT_ATLAS_BASE_SIZE    32                              // Size of the default game font
+#define FONT_ATLAS_GLYPHS       95                              // ASCII 32..126
+#define FONT_ATLAS_PADDING      4                               // Same padding LoadFont() uses for TTF
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+// NOTE: Decoding only touches CPU memory (any thread), uploading needs the main thread
+typedef struct FontAtlasSet {
+    Font fonts[FONT_ATLAS_MAX_SIZES];   // Sorted by base size
+    Image atlases[FONT_ATLAS_MAX_SIZES];        // Decoded atlases waiting for upload
+    bool atlasOwned[FONT_ATLAS_MAX_SIZES];      // Atlas pixels allocated (rasterized), not pointing into baked data
+    int count;
+    int uploaded;                       // fonts[0..uploaded) have their texture
+} FontAtlasSet;
+
+//----------------------------------------------------------------------------------
+// Font Atlas Functions Declaration
+//----------------------------------------------------------------------------------
+bool BakeFontAtlases(const char *ttfFileName, const char *fileName);    // Build step, rasterize FONT_ATLAS_SIZES into a baked file
+bool DecodeFontAtlasSet(FontAtlasSet *set, const unsigned char *data, int dataSize);    // Read baked file data, pixels keep pointing into it
+bool DecodeFontAtlasSetTTF(FontAtlasSet *set, const unsigned char *data, int dataSize); // Rasterize a TTF at FONT_ATLAS_BASE_SIZE (fallback)
+bool UploadFontAtlas(FontAtlasSet *set);                                // Upload next decoded atlas, returns true once all are uploaded
+void UnloadFontAtlasSet(FontAtlasSet *set);
+Font GetFontForSize(const FontAtlasSet *set, float fontSize);           // Smallest uploaded atlas at least fontSize, the largest otherwise
+
+#endif // FONT_ATLAS_H
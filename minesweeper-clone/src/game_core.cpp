@@ -0,0 +1,651 @@
+/**********************************************************************************************
+*
+*   Minesweeper Clone - Game Core
+*
+*   Board state and rules (generation, reveal, flag, chord, win/lose), driven only by
+*   tick-stamped actions so the same actions always produce the same game.
+*
+*   Copyright (c) 2024 (DoughnutDude)
+*
+**********************************************************************************************/
+
+#include "game_core.h"
+
+#include <string.h>         // Required for: memmove(), memset()
+
+#define internal static
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions Definition
+//----------------------------------------------------------------------------------
+// Get a random value between min and max (both included), same range semantics as raylib GetRandomValue()
+// NOTE: splitmix64, only integer operations so every platform generates the same board from a seed
+internal int GetRandomValueFromState(unsigned long long *state, int min, int max)
+{
+    *state += 0x9e3779b97f4a7c15ULL;
+    unsigned long long value = *state;
+    value = (value ^ (value >> 30))*0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27))*0x94d049bb133111ebULL;
+    value = value ^ (value >> 31);
+
+    return min + (int)(value%(unsigned long long)(max - min + 1));
+}
+
+internal int GetGameRandomValue(GameState *game, int min, int max)
+{
+    return GetRandomValueFromState(&game->randomState, min, max);
+}
+
+internal bool IsTileOnBoard(const GameState *game, int x, int y)
+{
+    return ((x < game->width) && (x >= 0) && (y < game->height) && (y >= 0));
+}
+
+internal void RevealTile(GameState *game, int x, int y)
+{
+    if (game->boardMask[y][x] != 0)
+    {
+        if (game->board[y][x] >= 0) --game->hiddenSafeTiles;
+        game->boardMask[y][x] = 0;
+    }
+}
+
+internal int DetectMinesTouchingTile(GameState *game, int x, int y)
+{
+    int result = 0;
+    for (int offsetY = -1; offsetY < 2; ++offsetY)
+    {
+        for (int offsetX = -1; offsetX < 2; ++offsetX)
+        {
+            if (!((offsetX == 0) && (offsetY == 0)))
+            {
+                int neighborX = x + offsetX;
+                int neighborY = y + offsetY;
+                if (IsTileOnBoard(game, neighborX, neighborY) &&
+                    game->board[neighborY][neighborX] < 0)
+                {
+                    ++result;
+                }
+            }
+        }
+    }
+    return result;
+}
+
+// Increment the clue count of each adjacent tile to let them know that they are touching a mine (board[y][x]).
+internal void PingTilesTouchingMine(GameState *game, int x, int y)
+{
+    for (int offsetY = -1; offsetY < 2; ++offsetY)
+    {
+        for (int offsetX = -1; offsetX < 2; ++offsetX)
+        {
+            if (!((offsetX == 0) && (offsetY == 0)))
+            {
+                int neighborX = x + offsetX;
+                int neighborY = y + offsetY;
+                if (IsTileOnBoard(game, neighborX, neighborY) &&
+                    game->board[neighborY][neighborX] >= 0)
+                {
+                    ++game->board[neighborY][neighborX];
+                }
+            }
+        }
+    }
+}
+
+internal void GenerateMinesRecursively(GameState *game, int x, int y)
+{
+    if (game->board[y][x] < 0 || game->mineCount >= game->maxMines)
+    {
+        return;
+    }
+    game->board[y][x] = -1;
+    ++game->mineCount;
+    PingTilesTouchingMine(game, x, y);
+    int offsetX = GetGameRandomValue(game, -1, 2);
+    int offsetY = GetGameRandomValue(game, -1, 2);
+    while (((offsetX == 0) && (offsetY == 0)))
+    {
+        offsetX = GetGameRandomValue(game, -1, 2);
+        offsetY = GetGameRandomValue(game, -1, 2);
+    }
+    int neighborX = x + offsetX;
+    int neighborY = y + offsetY;
+    if (IsTileOnBoard(game, neighborX, neighborY))
+    {
+        GenerateMinesRecursively(game, neighborX, neighborY);
+    }
+}
+
+internal void FloodFillClearTilesRecursively(GameState *game, int x, int y) //TODO: non-recursive solution. Currently fails for boards that are large + sparse.
+{
+    if (IsTileOnBoard(game, x, y) && (game->board[y][x] >= 0) && (game->boardMask[y][x] == 1))
+    {
+        RevealTile(game, x, y);
+
+        if (game->board[y][x] > 0) return;
+
+        for (int offsetY = -1; offsetY < 2; ++offsetY)
+        {
+            for (int offsetX = -1; offsetX < 2; ++offsetX)
+            {
+                if (!((offsetX == 0) && (offsetY == 0)))
+                {
+                    int neighborX = x + offsetX;
+                    int neighborY = y + offsetY;
+                    if (IsTileOnBoard(game, neighborX, neighborY) &&
+                        (game->boardMask[neighborY][neighborX] == 1 || (game->board[neighborY][neighborX] >= 0)))
+                    {
+                        FloodFillClearTilesRecursively(game, neighborX, neighborY);
+                    }
+                }
+            }
+        }
+    }
+}
+
+internal void FloodFillClearTiles(GameState *game, int x, int y)
+{
+    PROFILE_FUNCTION();
+
+    FloodFillClearTilesRecursively(game, x, y);
+}
+
+internal void AttemptTileReveal(GameState *game, int x, int y)
+{
+    if (game->boardMask[y][x] == 1)
+    {
+        switch (game->board[y][x])
+        {
+        case -1:
+            --game->hp;
+            game->board[y][x] = -2; // The mine has now been clicked/stepped on.
+        case 0:
+            // If a tile is touching 0 mines, then it clears tiles until mines are detected.
+            FloodFillClearTiles(game, x, y);
+        default:
+            RevealTile(game, x, y);
+        }
+    }
+}
+
+// Move mines away from the first click and its adjacent tiles.
+internal void ClearMinesAroundTile(GameState *game, int x, int y)
+{
+    PROFILE_FUNCTION();
+
+    for (int offsetY = -1; offsetY < 2; ++offsetY)
+    {
+        for (int offsetX = -1; offsetX < 2; ++offsetX)
+        {
+            int neighborX = x + offsetX;
+            int neighborY = y + offsetY;
+            if (IsTileOnBoard(game, neighborX, neighborY) &&
+                game->board[neighborY][neighborX] < 0)
+            {
+                bool mineMovedSuccessfully = false;
+                int iter = 0;
+                while (!mineMovedSuccessfully && (iter < 300))
+                {
+                    ++iter;
+                    int newX = GetGameRandomValue(game, 0, game->width - 1);
+                    int newY = GetGameRandomValue(game, 0, game->height - 1);
+                    // Make sure new random tile is not in neighborhood
+                    if (!((newX <= x + 1) && (newX >= x - 1) &&
+                        (newY <= y + 1) && (newY >= y - 1)) &&
+                        game->board[newY][newX] != -1)
+                    {
+                        game->board[neighborY][neighborX] = DetectMinesTouchingTile(game, neighborX, neighborY);
+                        for (int offsetY2 = -1; offsetY2 < 2; ++offsetY2)
+                        {
+                            for (int offsetX2 = -1; offsetX2 < 2; ++offsetX2)
+                            {
+                                if (!((offsetX2 == 0) && (offsetY2 == 0)))
+                                {
+                                    int neighborX2 = neighborX + offsetX2;
+                                    int neighborY2 = neighborY + offsetY2;
+                                    if (IsTileOnBoard(game, neighborX2, neighborY2) &&
+                                        game->board[neighborY2][neighborX2] > 0)
+                                    {
+                                        --game->board[neighborY2][neighborX2];
+                                    }
+                                }
+                            }
+                        }
+                        game->board[newY][newX] = -1;
+                        PingTilesTouchingMine(game, newX, newY);
+                        mineMovedSuccessfully = true;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// [Chording]: reveal all neighbors once the number of adjacent flagged/mine-havin tiles
+//is the same as the number in the clicked tile's value.
+internal bool ChordTile(GameState *game, int x, int y)
+{
+    int numOfAdjacentFlags = 0;
+    for (int offsetY = -1; offsetY < 2; ++offsetY)
+    {
+        for (int offsetX = -1; offsetX < 2; ++offsetX)
+        {
+            if (!((offsetX == 0) && (offsetY == 0)))
+            {
+                int neighborX = x + offsetX;
+                int neighborY = y + offsetY;
+                if (IsTileOnBoard(game, neighborX, neighborY) &&
+                    (game->boardMask[neighborY][neighborX] == 2 || (game->board[neighborY][neighborX] == -2) ||
+                    (game->boardMask[neighborY][neighborX] == 0 && game->board[neighborY][neighborX] == -1)))
+                {
+                    ++numOfAdjacentFlags;
+                }
+            }
+        }
+    }
+    if (numOfAdjacentFlags != game->board[y][x]) return false;
+
+    for (int offsetY = -1; offsetY < 2; ++offsetY)
+    {
+        for (int offsetX = -1; offsetX < 2; ++offsetX)
+        {
+            if (!((offsetX == 0) && (offsetY == 0)))
+            {
+                int neighborX = x + offsetX;
+                int neighborY = y + offsetY;
+                if (IsTileOnBoard(game, neighborX, neighborY))
+                {
+                    AttemptTileReveal(game, neighborX, neighborY);
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// A mine there would change a clue the player already sees
+internal bool IsNextToRevealedTile(const GameState *game, int x, int y)
+{
+    for (int offsetY = -1; offsetY < 2; ++offsetY)
+    {
+        for (int offsetX = -1; offsetX < 2; ++offsetX)
+        {
+            int neighborX = x + offsetX;
+            int neighborY = y + offsetY;
+            if (IsTileOnBoard(game, neighborX, neighborY) && (game->boardMask[neighborY][neighborX] == 0)) return true;
+        }
+    }
+    return false;
+}
+
+// Turn a hidden safe tile into a mine, only its neighbors get their clue patched
+internal void PlaceMine(GameState *game, int x, int y)
+{
+    game->board[y][x] = -1;
+    ++game->mineCount;
+    ++game->maxMines;
+    --game->hiddenSafeTiles;
+    PingTilesTouchingMine(game, x, y);
+}
+
+// Safe tile a mine can go on without changing a tile the player sees
+internal bool IsMineCandidate(const GameState *game, int x, int y)
+{
+    return (game->board[y][x] >= 0) && !IsNextToRevealedTile(game, x, y);
+}
+
+// Mines on candidate tiles of rows firstRow to lastRow - 1, keeping keep hidden safe tiles on the
+// board: random tiles first, then the next candidates from a random tile for the rest, so as many
+// as there is room for are placed whatever the board. Returns how many were placed.
+internal int PlaceRandomMines(GameState *game, int firstRow, int lastRow, int count, int keep, unsigned long long seed)
+{
+    int width = game->width;
+    int tileCount = (lastRow - firstRow)*width;
+    int candidates = 0;
+    for (int i = 0; i < tileCount; ++i) if (IsMineCandidate(game, i%width, firstRow + i/width)) ++candidates;
+    if (count > candidates) count = candidates;
+    if (count > game->hiddenSafeTiles - keep) count = game->hiddenSafeTiles - keep;
+    if (count <= 0) return 0;
+
+    unsigned long long state = seed;
+    int placed = 0;
+    for (int attempt = 0; (placed < count) && (attempt < 4*count); ++attempt)
+    {
+        int index = GetRandomValueFromState(&state, 0, tileCount - 1);
+        int x = index%width;
+        int y = firstRow + index/width;
+        if (!IsMineCandidate(game, x, y)) continue;
+
+        PlaceMine(game, x, y);
+        ++placed;
+    }
+
+    // NOTE: Crowded rows miss most random tiles, the scan is bounded by the rows size
+    int start = GetRandomValueFromState(&state, 0, tileCount - 1);
+    for (int i = 0; (i < tileCount) && (placed < count); ++i)
+    {
+        int index = (start + i)%tileCount;
+        int x = index%width;
+        int y = firstRow + index/width;
+        if (!IsMineCandidate(game, x, y)) continue;
+
+        PlaceMine(game, x, y);
+        ++placed;
+    }
+
+    return placed;
+}
+
+// If all non-mine spaces have been revealed and the player has health remaining, the game is won.
+internal bool CheckWinCondition(const GameState *game)
+{
+    return ((game->hp > 0) && (game->hiddenSafeTiles <= 0));
+}
+
+// When game is done, regardless of win or lose, all mines should be revealed.
+internal void RevealEndOfGameBoard(GameState *game)
+{
+    for (int y = 0; y < game->height; ++y)
+    {
+        for (int x = 0; x < game->width; ++x)
+        {
+            if ((game->board[y][x] < 0) && (game->boardMask[y][x] != 2))
+            {
+                game->boardMask[y][x] = 0;
+            }
+            else if ((game->board[y][x] >= 0) && game->boardMask[y][x] == 2)
+            {
+                // All incorrectly flagged spaces should also be revealed.
+                game->boardMask[y][x] = -1;
+            }
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------
+// Game Core Functions Definition
+//----------------------------------------------------------------------------------
+void InitGame(GameState *game, GameSettings settings)
+{
+    PROFILE_FUNCTION();
+
+    game->width = settings.width;
+    game->height = settings.height;
+    game->hp = settings.startingHP;
+    game->actionCount = 0;
+    game->winCon = false;
+    game->tick = 0;
+    game->startTick = -1;
+    game->endTick = -1;
+    game->randomState = settings.seed;
+
+    game->mineCount = 0;
+    if (!settings.mineGenMode)
+    {
+        // NOTE: Every float step is stored so targets with wider intermediates round the same, a
+        // seed must generate the same board everywhere (replays, clients of a race match)
+        float density = (float)settings.mineDensity/100.0f;
+        float mines = density*(float)(game->width * game->height);
+        game->maxMines = (int)mines;
+    }
+    else
+    {
+        game->maxMines = settings.minesDesired;
+    }
+    if (game->maxMines >= game->width * game->height)
+    {
+        game->maxMines = game->width * game->height - 1;
+    }
+
+    for (int y = 0; y < game->height; ++y)
+    {
+        for (int x = 0; x < game->width; ++x)
+        {
+            game->board[y][x] = 0;     // Clear board every time we load in.
+            game->boardMask[y][x] = 1; // Set this to 0 to start with board revealed.
+        }
+    }
+
+    int x = GetGameRandomValue(game, 0, game->width - 1);
+    int y = GetGameRandomValue(game, 0, game->height - 1);
+    GenerateMinesRecursively(game, x, y);
+    while (game->mineCount < game->maxMines)
+    {
+        x = GetGameRandomValue(game, 0, game->width - 1);
+        y = GetGameRandomValue(game, 0, game->height - 1);
+        if (game->board[y][x] >= 0)
+        {
+            game->board[y][x] = -1;
+            ++game->mineCount;
+            PingTilesTouchingMine(game, x, y);
+        }
+    }
+    game->hiddenSafeTiles = game->width*game->height - game->mineCount;
+}
+
+void TickGame(GameState *game, GameActionQueue *queue)
+{
+    ++game->tick;
+    ApplyDueGameActions(game, queue);
+}
+
+void ApplyDueGameActions(GameState *game, GameActionQueue *queue)
+{
+    while ((queue->count > 0) && (queue->actions[queue->head].tick <= game->tick))
+    {
+        GameAction action = { 0 };
+        PopGameAction(queue, &action);
+        ApplyGameAction(game, action);
+    }
+}
+
+bool ApplyGameAction(GameState *game, GameAction action)
+{
+    if (IsGameOver(game)) return false;
+    if ((action.type != ACTION_GARBAGE) && !IsTileOnBoard(game, action.x, action.y)) return false;
+
+    int x = action.x;
+    int y = action.y;
+    bool accepted = false;
+
+    switch (action.type)
+    {
+        case ACTION_REVEAL:
+        {
+            if (game->boardMask[y][x] == 1)
+            {
+                if (game->startTick < 0) game->startTick = action.tick;
+                ++game->actionCount;
+                if (game->actionCount == 1) ClearMinesAroundTile(game, x, y);
+                AttemptTileReveal(game, x, y);
+                accepted = true;
+            }
+        } break;
+        case ACTION_FLAG:
+        {
+            if (game->boardMask[y][x] == 1)
+            {
+                game->boardMask[y][x] = 2;
+                accepted = true;
+            }
+            else if (game->boardMask[y][x] == 2)
+            {
+                game->boardMask[y][x] = 1;
+                accepted = true;
+            }
+        } break;
+        case ACTION_CHORD:
+        {
+            if ((game->boardMask[y][x] == 0) && ChordTile(game, x, y))
+            {
+                ++game->actionCount;
+                accepted = true;
+            }
+        } break;
+        case ACTION_REVEAL_ALL:
+        {
+            for (int tileY = 0; tileY < game->height; ++tileY)
+            {
+                for (int tileX = 0; tileX < game->width; ++tileX)
+                {
+                    game->boardMask[tileY][tileX] = 0;
+                }
+            }
+            game->hiddenSafeTiles = 0;
+            accepted = true;
+        } break;
+        case ACTION_GARBAGE:
+        {
+            // NOTE: Seeded from the action and the board size, every copy of the board gets the same garbage
+            unsigned long long seed = ((unsigned long long)action.tick << 32) ^ ((unsigned long long)game->height << 24) ^
+                                      ((unsigned long long)game->mineCount << 16) ^ ((unsigned long long)x << 8) ^ (unsigned long long)y;
+            if (game->height + x <= maxBoardHeight) accepted = InsertGameRows(game, game->height, x, y, seed);
+            else accepted = (InjectGameMines(game, y, seed) > 0);
+        } break;
+        default: break;
+    }
+
+    // Rejected actions change nothing on the board
+    if (!accepted) return false;
+
+    // Check for win condition after every action.
+    {
+        PROFILE_SCOPE("CheckWinCondition");
+
+        game->winCon = CheckWinCondition(game);
+        if (IsGameOver(game))
+        {
+            game->endTick = action.tick;
+            RevealEndOfGameBoard(game);
+        }
+    }
+
+    return true;
+}
+
+// NOTE: The first reveal moves mines away from the clicked tile, opening every copy of a seeded
+// board on the same tile keeps them the same board whatever each player clicks next
+void OpenGame(GameState *game)
+{
+    GameAction action = { 0 };
+    action.type = ACTION_REVEAL;
+    action.x = GetGameRandomValue(game, 0, game->width - 1);
+    action.y = GetGameRandomValue(game, 0, game->height - 1);
+    action.tick = game->tick;
+    ApplyGameAction(game, action);
+}
+
+// NOTE: Rows below move down (a row copy each), clues are only computed again on the inserted
+// rows and the two rows around them: the cost follows the rows affected, not the board size.
+// Those two rows lose the neighbors they had across the insert point, so inside the board the
+// insert is refused while either has a revealed tile: a clue the player sees never changes
+bool InsertGameRows(GameState *game, int row, int count, int mines, unsigned long long seed)
+{
+    PROFILE_FUNCTION();
+
+    if ((count <= 0) || (row < 0) || (row > game->height) || (count > maxBoardHeight - game->height)) return false;
+
+    for (int y = row - 1; (row < game->height) && (y <= row); ++y)
+    {
+        if (y < 0) continue;
+
+        for (int x = 0; x < game->width; ++x) if (game->boardMask[y][x] == 0) return false;
+    }
+
+    int width = game->width;
+    for (int y = game->height - 1; y >= row; --y)
+    {
+        memmove(game->board[y + count], game->board[y], width);
+        memmove(game->boardMask[y + count], game->boardMask[y], width);
+    }
+    for (int y = row; y < row + count; ++y)
+    {
+        memset(game->board[y], 0, width);
+        memset(game->boardMask[y], 1, width);
+    }
+    game->height += count;
+    game->hiddenSafeTiles += count*width;
+
+    // Rows around the inserted ones lost the neighbors they had across, inserted rows start from the mines next to them
+    for (int y = row - 1; y <= row + count; ++y)
+    {
+        if ((y < 0) || (y >= game->height)) continue;
+
+        for (int x = 0; x < width; ++x) if (game->board[y][x] >= 0) game->board[y][x] = (signed char)DetectMinesTouchingTile(game, x, y);
+    }
+
+    // Mines are kept away from revealed tiles, a tile the player sees never changes under it
+    PlaceRandomMines(game, row, row + count, mines, 0, seed);
+
+    return true;
+}
+
+int InjectGameMines(GameState *game, int count, unsigned long long seed)
+{
+    PROFILE_FUNCTION();
+
+    // NOTE: One hidden safe tile is always left, the board can still be cleared
+    return PlaceRandomMines(game, 0, game->height, count, 1, seed);
+}
+
+bool IsGameOver(const GameState *game)
+{
+    return ((game->hp <= 0) || game->winCon);
+}
+
+float GetGameTimer(const GameState *game)
+{
+    if (game->startTick < 0) return 0.0f;
+
+    int lastTick = (game->endTick >= 0)? game->endTick : game->tick;
+    float result = (float)((lastTick - game->startTick)*SIM_TICK_TIME);
+    if (result > MAX_GAME_TIME) result = MAX_GAME_TIME;
+
+    return result;
+}
+
+unsigned long long GetGameStateHash(const GameState *game)
+{
+    // FNV-1a 64-bit over every value that can change with actions
+    unsigned long long hash = 0xcbf29ce484222325ULL;
+    int values[8] = { game->width, game->height, game->mineCount, game->hp, game->actionCount,
+                      game->winCon, game->startTick, game->endTick };
+
+    for (int i = 0; i < 8; ++i) hash = (hash ^ (unsigned int)values[i])*0x100000001b3ULL;
+    for (int y = 0; y < game->height; ++y)
+    {
+        for (int x = 0; x < game->width; ++x)
+        {
+            hash = (hash ^ (unsigned int)game->board[y][x])*0x100000001b3ULL;
+            hash = (hash ^ (unsigned int)game->boardMask[y][x])*0x100000001b3ULL;
+        }
+    }
+
+    return hash;
+}
+
+bool PushGameAction(GameActionQueue *queue, GameAction action)
+{
+    if (queue->count >= MAX_QUEUED_ACTIONS) return false;
+
+    queue->actions[(queue->head + queue->count) % MAX_QUEUED_ACTIONS] = action;
+    ++queue->count;
+    return true;
+}
+
+bool PopGameAction(GameActionQueue *queue, GameAction *action)
+{
+    if (queue->count <= 0) return false;
+
+    *action = queue->actions[queue->head];
+    queue->head = (queue->head + 1) % MAX_QUEUED_ACTIONS;
+    --queue->count;
+    return true;
+}
+
+void ClearGameActions(GameActionQueue *queue)
+{
+    queue->head = 0;
+    queue->count = 0;
+}
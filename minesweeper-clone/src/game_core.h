@@ -0,0 +1,115 @@
+/**********************************************************************************************
+*
+*   Minesweeper Clone - Game Core
+*
+*   Board state and rules (generation, reveal, flag, chord, win/lose), driven only by
+*   a seed and tick-stamped actions so the same seed and actions always produce the same game.
+*   No raylib dependency, it can run headless (replay verification, tools).
+*
+*   Boards are generated with splitmix64 and integer tile picks. The density mine count stays in
+*   float to keep old replay boards, every float step stored to a named variable so it rounds the
+*   same everywhere: the same settings and seed give the same board on every platform, a match
+*   can send a seed instead of a board.
+*
+*   Boards can grow while played (multiplayer garbage): hidden rows inserted or appended, mines
+*   injected in hidden areas. Only the rows involved are touched, clues and counters are patched
+*   around them instead of computed again, and no mine ever lands next to a revealed tile.
+*
+*   Copyright (c) 2024 (DoughnutDude)
+*
+**********************************************************************************************/
+
+#ifndef GAME_CORE_H
+#define GAME_CORE_H
+
+#include "profiler.h"
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define maxBoardHeight 99
+#define maxBoardWidth 99
+
+#define SIM_TICK_RATE       120                     // Fixed simulation ticks per second, independent of render rate
+#define SIM_TICK_TIME       (1.0/SIM_TICK_RATE)     // Seconds simulated by one tick
+#define SIM_MAX_FRAME_TIME  1.5                     // Longest frame the simulation catches up on (idle waits can last ~1s)
+
+#define MAX_GAME_TIME       10000                   // Timer stops counting at this many seconds
+#define MAX_QUEUED_ACTIONS  256                     // Maximum number of actions waiting for their tick
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum GameActionType {
+    ACTION_NONE = 0,
+    ACTION_REVEAL,          // Reveal a hidden tile (left click)
+    ACTION_FLAG,            // Toggle a flag on a hidden tile (right click)
+    ACTION_CHORD,           // Reveal neighbors of a satisfied clue (middle click)
+    ACTION_REVEAL_ALL,      // Reveal the entire board (DEBUG)
+    ACTION_GARBAGE,         // Sent by an opponent: x hidden rows holding y mines appended, y mines injected once the board is maxBoardHeight tall
+} GameActionType;
+
+typedef struct GameAction {
+    int tick;               // Simulation tick the action happened on
+    GameActionType type;
+    int x;
+    int y;
+} GameAction;
+
+typedef struct GameSettings {
+    int width;
+    int height;
+    int mineDensity;        // Percentage of tiles that are mines (mineGenMode = 0)
+    int minesDesired;       // Number of mines (mineGenMode = 1)
+    bool mineGenMode;       // 0 = by density, 1 = til minesDesired
+    int startingHP;
+    unsigned int seed;      // Board generation seed
+} GameSettings;
+
+typedef struct GameState {
+    int width;
+    int height;
+    int maxMines;
+    int mineCount;
+    int hp;
+    int actionCount;
+    bool winCon;
+    int hiddenSafeTiles;    // Non-mine tiles still to reveal, the game is won at 0
+
+    unsigned long long randomState;     // Board generation random state, seeded from GameSettings
+
+    int tick;               // Simulation ticks elapsed since the board was generated
+    int startTick;          // Tick of the first reveal, -1 while the timer has not started
+    int endTick;            // Tick the game was won or lost, -1 while still playing
+
+    // NOTE: Tiles are stored as bytes, a match server keeps one board per player
+    signed char board[maxBoardHeight][maxBoardWidth];     // -2 = mine(clicked on), -1 = mine, non-negative = number of adjacent mines
+    signed char boardMask[maxBoardHeight][maxBoardWidth]; // 0 = revealed, 1 = hidden, 2 = flagged, -1 = incorrectly flagged (only used for game lose screen)
+} GameState;
+
+// Actions waiting for their tick, in the order they happened
+typedef struct GameActionQueue {
+    GameAction actions[MAX_QUEUED_ACTIONS];
+    int head;
+    int count;
+} GameActionQueue;
+
+//----------------------------------------------------------------------------------
+// Game Core Functions Declaration
+//----------------------------------------------------------------------------------
+void InitGame(GameState *game, GameSettings settings);          // Generate a new board
+void TickGame(GameState *game, GameActionQueue *queue);         // Advance one tick and apply the actions that are due
+void ApplyDueGameActions(GameState *game, GameActionQueue *queue); // Apply queued actions stamped up to the current tick
+bool ApplyGameAction(GameState *game, GameAction action);       // Apply a single action, returns true if it was accepted
+void OpenGame(GameState *game);                                 // First reveal on a tile picked from the seed (race start)
+bool InsertGameRows(GameState *game, int row, int count, int mines, unsigned long long seed);  // Hidden rows before row (height appends), mines placed in them, refused inside the board next to revealed tiles
+int InjectGameMines(GameState *game, int count, unsigned long long seed);  // Mines on hidden tiles with no revealed neighbor (one safe tile left), returns how many were placed
+bool IsGameOver(const GameState *game);
+float GetGameTimer(const GameState *game);                      // Seconds elapsed since the first reveal
+unsigned long long GetGameStateHash(const GameState *game);     // Hash of the board and game progress (tick excluded)
+
+bool PushGameAction(GameActionQueue *queue, GameAction action);
+bool PopGameAction(GameActionQueue *queue, GameAction *action);
+void ClearGameActions(GameActionQueue *queue);
+
+#endif // GAME_CORE_H
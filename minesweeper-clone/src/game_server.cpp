@@ -0,0 +1,1983 @@
+/**********************************************************************************************
+*
+*   Minesweeper Clone - Match Server
+*
+*   Network thread matching queued players, worker pool updating matches through lock-free queues,
+*   matches handed between workers to keep their frames within the tick budget.
+*
+*   Copyright (c) 2024 (DoughnutDude)
+*
+**********************************************************************************************/
+
+#include "game_server.h"
+#include "net.h"
+#include "net_protocol.h"
+#include "board_sync.h"
+
+#include <stdio.h>          // Required for: printf()
+#include <stdlib.h>         // Required for: malloc(), realloc(), free()
+#include <string.h>         // Required for: memcpy(), memmove(), memset()
+#include <math.h>           // Required for: fabsf()
+#include <signal.h>         // Required for: signal(), SIGINT
+#include <time.h>           // Required for: time()
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <chrono>
+
+#define internal static
+#define global_var static
+
+#define SERVER_FRAME_TIME       (1.0/SERVER_FRAME_RATE)
+#define SERVER_POLL_TIMEOUT     10      // Milliseconds the network thread waits for socket activity
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+// NOTE: Owned by the network thread and, once joined, by the match worker too: the last one
+// to let go closes the socket, so a socket number is never reused while a thread still uses it
+typedef struct ServerConnection {
+    NetSocket socket;
+    std::atomic<int> references;
+
+    // Network thread only
+    int match;                  // Match joined, -1 before
+    int player;                 // -1 for a spectator
+    bool queued;                // Sent MSG_JOIN, waiting in the lobby queue for a match
+    bool spectator;             // Sent MSG_SPECTATE, watching the match instead of playing
+    unsigned char input[NET_MESSAGE_HEADER_SIZE + NET_MAX_MESSAGE_SIZE];
+    int inputSize;
+
+    // Match worker only
+    unsigned char output[SERVER_OUTPUT_SIZE];
+    int outputSize;
+    bool failed;                // Output overflow or send error, disconnected
+} ServerConnection;
+
+typedef enum ServerEventType {
+    SERVER_EVENT_JOIN = 0,      // Player joined, the match worker takes a connection reference
+    SERVER_EVENT_START,         // No more players, boards are generated
+    SERVER_EVENT_ACTION,
+    SERVER_EVENT_LEAVE,         // Player disconnected, the match worker drops its connection reference
+    SERVER_EVENT_SYNC_REQUEST,  // Player copy of a board is wrong, a keyframe is sent (spectators: player -1)
+    SERVER_EVENT_SPECTATE,      // Spectator joined, the match worker takes a connection reference
+    SERVER_EVENT_UNSPECTATE,    // Spectator disconnected, the match worker drops its connection reference
+    SERVER_EVENT_LOCKSTEP_HASH, // Lockstep player state hash of a step
+} ServerEventType;
+
+typedef struct ServerEvent {
+    ServerEventType type;
+    int player;
+    ServerConnection *connection;   // SERVER_EVENT_JOIN, spectator events
+    unsigned int match;             // SERVER_EVENT_SPECTATE, id of the match watched (the slot may hold a newer one)
+    unsigned int sequence;          // SERVER_EVENT_ACTION, echoed in the result (SERVER_EVENT_LOCKSTEP_HASH: step)
+    unsigned int hash;              // SERVER_EVENT_LOCKSTEP_HASH
+    int board;                      // SERVER_EVENT_SYNC_REQUEST, player index of the board
+    GameAction action;              // SERVER_EVENT_ACTION, tick is stamped by the server
+} ServerEvent;
+
+// Same turn scheme as the logger queue: 2*lap = free for the producer of that lap, 2*lap + 1 = written
+typedef struct ServerEventSlot {
+    std::atomic<unsigned long long> turn;
+    ServerEvent event;
+} ServerEventSlot;
+
+// NOTE: Immutable once published, shared by every spectator of the match sending it (worker only).
+// Delta frames are chained in publish order, each one holding a reference to the next; a keyframe
+// is not part of the chain, it links to the first delta frame published after it.
+typedef struct SpectatorFrame {
+    int references;
+    long long sequence;             // Delta frames published before this one
+    struct SpectatorFrame *next;    // Next delta frame, NULL until published
+    int size;
+    unsigned char *data;            // Messages, allocated with the frame
+} SpectatorFrame;
+
+typedef struct ServerSpectator {
+    ServerConnection *connection;
+    SpectatorFrame *frame;          // Frame being sent (a reference), NULL until the first keyframe
+    int offset;                     // Bytes of it already sent
+    bool resync;                    // Asked to start again from the latest keyframe
+    bool closing;                   // Stream sent to the end, socket shut down
+} ServerSpectator;
+
+typedef struct ServerPlayer {
+    ServerConnection *connection;   // NULL once released
+    GameState *game;                // Allocated when the match starts
+    BoardSync *sync;                // Board as the player has it, allocated with game
+    bool syncPending;               // Board changed since the last delta
+    double keyframeTime;            // Next periodic keyframe, brought forward by a sync request
+    double syncResetTime;           // Last keyframe, requests wait SERVER_SYNC_REQUEST_TIME after it
+    BoardSync *wallSync;            // Board as the opponents have it, allocated with game
+    bool wallPending;               // Board changed since the last opponent delta
+    int wallStart;                  // Opponent deltas of this board in the match wall buffer
+    int wallEnd;
+    bool wallKeyframes[SERVER_MAX_PLAYERS];     // Opponent boards this player needs a keyframe of
+    unsigned long long lockstepHash;    // GetGameStateHash() of game, lockstep matches
+    bool lockstepChanged;           // Inputs of the current step changed game, its hash is stale
+    bool desynced;                  // Reported a wrong state hash, not checked any more
+    int garbageTiles;               // Safe tiles revealed towards the next garbage row sent
+    int spectatorHeight;            // Board height in published spectator frames, garbage still staged not counted
+    PlayerStatus status;
+    bool joined;
+} ServerPlayer;
+
+typedef enum MatchState {
+    MATCH_FREE = 0,
+    MATCH_ACTIVE,               // Running, updated by its worker
+} MatchState;
+
+typedef struct ServerMatch {
+    std::atomic<int> state;
+    unsigned int id;            // Written by the network thread before the match is activated
+    GameSettings settings;
+    MatchMode mode;
+    bool garbage;
+
+    // NOTE: Set by the network thread before the match is activated, then only by the worker it
+    // names: the release store hands the match over, the new worker acquires it before updating
+    std::atomic<int> worker;
+    float cost;                 // Worker only, smoothed update time, microseconds
+
+    ServerEventSlot events[SERVER_EVENT_QUEUE_SIZE];
+    std::atomic<unsigned long long> eventWrite;
+    unsigned long long eventRead;   // Worker only
+
+    // Worker only
+    ServerPlayer players[SERVER_MAX_PLAYERS];
+    int playerCount;
+    int winner;
+    bool started;
+    bool ended;
+    bool lingerExpired;
+    double startTime;
+    double endTime;
+    double wallTime;            // Next opponent board update
+    int wallFirst;              // Board encoded first, rotates so a full buffer does not always delay the same ones
+    unsigned char wallBuffer[SERVER_WALL_BUFFER_SIZE];
+
+    // Worker only, lockstep matches
+    int lockstepStep;           // Step the inputs received now apply on
+    double lockstepTime;        // When that step is sent
+    unsigned char lockstepInputs[4*NET_LOCKSTEP_MAX_INPUTS];    // As in MSG_LOCKSTEP_STEP
+    int lockstepInputCount;
+    unsigned int lockstepHashes[SERVER_LOCKSTEP_HASH_HISTORY];  // State hash of the last steps sent, by step%SERVER_LOCKSTEP_HASH_HISTORY
+
+    // Worker only, frames are only made while someone watches
+    ServerSpectator *spectators;
+    int spectatorCount;
+    int spectatorCapacity;
+    SpectatorFrame *spectatorKeyframe;  // Latest keyframe, where spectators start
+    SpectatorFrame *spectatorTail;      // Latest delta frame, the next one is linked to it
+    long long spectatorSequence;        // Delta frames published
+    double spectatorKeyframeTime;       // Next keyframe
+    bool spectatorStreamEnded;          // Match over and everything published
+    unsigned char spectatorMessages[SERVER_SPECTATOR_MESSAGE_SIZE];    // Statuses and match end for the next frame
+    int spectatorMessageSize;
+} ServerMatch;
+
+// Counters when the load statistics were last reset, they are reported relative to it
+typedef struct ServerLoadBaseline {
+    double time;
+    long long tickHistogram[SERVER_TICK_BUCKETS];
+    long long ticks;
+    long long queueDepthSum;
+    long long queueDepthSamples;
+    long long playersJoined;
+    long long actionsReceived;
+    long long actionsDropped;
+    long long actionsApplied;
+    long long bytesSent;
+    long long tickOverruns;
+    long long matchesMoved;
+    long long queueWaitSum;
+    long long queueWaitSamples;
+} ServerLoadBaseline;
+
+// NOTE: Written by its worker every frame, read by the network thread to place new matches and by
+// the other workers to find where to hand one over
+typedef struct ServerWorker {
+    std::atomic<int> load;          // Cost of its matches per frame, microseconds
+    std::atomic<int> matchCount;    // Matches it updates, counting the ones just placed on it
+    double rebalanceTime;           // Worker only, next time it may hand a match over
+} ServerWorker;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+global_var ServerMatch *matches = NULL;
+global_var int workerCount = 1;
+global_var ServerWorker *serverWorkers = NULL;
+global_var int tickBudget = 0;                      // Microseconds
+global_var std::atomic<bool> serverRunning(false);
+
+// Statistics, any thread
+global_var std::atomic<long long> actionsReceived(0);
+global_var std::atomic<long long> actionsDropped(0);
+global_var std::atomic<long long> actionsApplied(0);
+global_var std::atomic<long long> bytesSent(0);
+global_var std::atomic<int> matchesStarted(0);
+global_var std::atomic<int> matchesFinished(0);
+global_var std::atomic<long long> playersJoined(0);
+global_var std::atomic<int> spectatorsWatching(0);
+global_var std::atomic<long long> lockstepDesyncs(0);
+global_var std::atomic<int> workerFrameMax(0);      // Longest worker frame since the last statistics line, microseconds
+global_var std::atomic<long long> tickOverruns(0);  // Worker frames over the tick budget
+global_var std::atomic<long long> matchesMoved(0);  // Handed to another worker
+
+// Load statistics, any thread, never reset: see ServerLoadBaseline
+global_var std::atomic<long long> tickHistogram[SERVER_TICK_BUCKETS];
+global_var std::atomic<long long> tickCount(0);
+global_var std::atomic<long long> queueDepthSum(0);
+global_var std::atomic<long long> queueDepthSamples(0);
+global_var std::atomic<int> tickMax(0);             // Since the last reset, microseconds
+global_var std::atomic<int> matchCostMax(0);        // Longest single match update since the last reset, microseconds
+global_var std::atomic<long long> queueWaitSum(0);  // Milliseconds players waited in the lobby queue
+global_var std::atomic<long long> queueWaitSamples(0);
+global_var std::atomic<int> queueDepthMax(0);       // Since the last reset
+global_var std::atomic<int> queueDepthWindowMax(0); // Since the last statistics line
+global_var std::mutex loadBaselineMutex;
+global_var ServerLoadBaseline loadBaseline = { };
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions Definition
+//----------------------------------------------------------------------------------
+internal double GetSeconds(void)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+internal void SleepSeconds(double seconds)
+{
+    // NOTE: raylib WaitTime() relies on GetTime(), which needs a window
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+}
+
+internal void StopServer(int signalId)
+{
+    (void)signalId;
+    serverRunning = false;
+}
+
+internal void RecordMax(std::atomic<int> *value, int sample)
+{
+    int current = *value;
+    while ((sample > current) && !value->compare_exchange_weak(current, sample)) { }
+}
+
+// Upper bound of the bucket holding the percent-th frame of histogram, milliseconds
+internal float GetTickPercentile(const long long *histogram, long long count, int percent)
+{
+    long long seen = 0;
+    for (int i = 0; i < SERVER_TICK_BUCKETS; ++i)
+    {
+        seen += histogram[i];
+        if ((seen > 0) && (seen*100 >= count*percent)) return (float)((i + 1)*SERVER_TICK_BUCKET_TIME);
+    }
+    return 0.0f;
+}
+
+internal void ReleaseConnection(ServerConnection *connection)
+{
+    if (--connection->references == 0)
+    {
+        CloseSocket(connection->socket);
+        delete connection;
+    }
+}
+
+// Frames nobody holds any more are freed, with the delta frames only they held after them
+internal void ReleaseSpectatorFrame(SpectatorFrame *frame)
+{
+    while ((frame != NULL) && (--frame->references == 0))
+    {
+        SpectatorFrame *next = frame->next;
+        free(frame);
+        frame = next;
+    }
+}
+
+// Any thread may push (network thread today), never waits: false if the queue is full
+internal bool PushServerEvent(ServerMatch *match, const ServerEvent *event)
+{
+    unsigned long long position = match->eventWrite.load(std::memory_order_relaxed);
+    ServerEventSlot *slot = NULL;
+    for (;;)
+    {
+        slot = &match->events[position%SERVER_EVENT_QUEUE_SIZE];
+        long long diff = (long long)(slot->turn.load(std::memory_order_acquire) - 2*(position/SERVER_EVENT_QUEUE_SIZE));
+
+        if (diff == 0)
+        {
+            if (match->eventWrite.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+        }
+        else if (diff < 0) return false;
+        else position = match->eventWrite.load(std::memory_order_relaxed);
+    }
+
+    slot->event = *event;
+    slot->turn.store(2*(position/SERVER_EVENT_QUEUE_SIZE) + 1, std::memory_order_release);
+    return true;
+}
+
+// Match worker only
+internal bool PopServerEvent(ServerMatch *match, ServerEvent *event)
+{
+    ServerEventSlot *slot = &match->events[match->eventRead%SERVER_EVENT_QUEUE_SIZE];
+    unsigned long long lap = match->eventRead/SERVER_EVENT_QUEUE_SIZE;
+    if (slot->turn.load(std::memory_order_acquire) != 2*lap + 1) return false;
+
+    *event = slot->event;
+    slot->turn.store(2*(lap + 1), std::memory_order_release);
+    ++match->eventRead;
+    return true;
+}
+
+//----------------------------------------------------------------------------------
+// Match worker
+//----------------------------------------------------------------------------------
+internal NetWriter BeginPlayerMessage(ServerConnection *connection, NetMessageType type)
+{
+    NetWriter writer = { connection->output, SERVER_OUTPUT_SIZE, connection->outputSize, 0, false };
+    BeginNetMessage(&writer, type);
+    return writer;
+}
+
+// A player too slow to read its messages is disconnected, the network thread then reports it left
+internal void EndPlayerMessage(ServerConnection *connection, NetWriter *writer)
+{
+    if (connection->failed) return;
+
+    if (EndNetMessage(writer)) connection->outputSize = writer->size;
+    else
+    {
+        connection->failed = true;
+        ShutdownSocket(connection->socket, true);
+    }
+}
+
+internal void FlushPlayerOutput(ServerConnection *connection)
+{
+    if (connection->failed || (connection->outputSize == 0)) return;
+
+    int sent = SendSocket(connection->socket, connection->output, connection->outputSize);
+    if (sent < 0)
+    {
+        connection->failed = true;
+        ShutdownSocket(connection->socket, true);
+    }
+    else if (sent > 0)
+    {
+        memmove(connection->output, connection->output + sent, connection->outputSize - sent);
+        connection->outputSize -= sent;
+        bytesSent += sent;
+    }
+}
+
+// Statuses and the match end go out with the next spectator frame
+internal NetWriter BeginSpectatorMessage(ServerMatch *match, NetMessageType type)
+{
+    NetWriter writer = { match->spectatorMessages, SERVER_SPECTATOR_MESSAGE_SIZE, match->spectatorMessageSize, 0, false };
+    BeginNetMessage(&writer, type);
+    return writer;
+}
+
+// NOTE: Only kept while someone watches, a keyframe made later carries the same
+internal bool EndSpectatorMessage(ServerMatch *match, NetWriter *writer)
+{
+    if ((match->spectatorKeyframe == NULL) || !EndNetMessage(writer)) return false;
+
+    match->spectatorMessageSize = writer->size;
+    return true;
+}
+
+internal void WritePlayerStatus(NetWriter *writer, const ServerMatch *match, int player)
+{
+    const ServerPlayer *status = &match->players[player];
+    int hiddenSafeTiles = (status->game != NULL)? status->game->hiddenSafeTiles : 0;
+
+    NetWriteU8(writer, (unsigned int)player);
+    NetWriteU8(writer, (unsigned int)status->status);
+    NetWriteU16(writer, (unsigned int)hiddenSafeTiles);
+}
+
+internal void BroadcastPlayerStatus(ServerMatch *match, int player)
+{
+    for (int i = 0; i < match->playerCount; ++i)
+    {
+        ServerConnection *connection = match->players[i].connection;
+        if (connection == NULL) continue;
+
+        NetWriter writer = BeginPlayerMessage(connection, MSG_PLAYER_STATUS);
+        WritePlayerStatus(&writer, match, player);
+        EndPlayerMessage(connection, &writer);
+    }
+
+    NetWriter writer = BeginSpectatorMessage(match, MSG_PLAYER_STATUS);
+    WritePlayerStatus(&writer, match, player);
+    EndSpectatorMessage(match, &writer);
+}
+
+internal void WriteGarbage(NetWriter *writer, int player, GameAction garbage)
+{
+    NetWriteU8(writer, (unsigned int)player);
+    NetWriteU32(writer, (unsigned int)garbage.tick);
+    NetWriteU8(writer, (unsigned int)garbage.x);
+    NetWriteU8(writer, (unsigned int)garbage.y);
+}
+
+// Garbage applied on a board: its copies get the same new rows before any later delta, players
+// are told unless they run the boards themselves (lockstep), spectators with the next frame
+internal void ShareGarbage(ServerMatch *match, int index, GameAction garbage, int height)
+{
+    ServerPlayer *player = &match->players[index];
+    int rows = player->game->height - height;
+    InsertBoardSyncRows(player->sync, height, rows);
+    InsertBoardSyncRows(player->wallSync, height, rows);
+    player->syncPending = true;
+    player->wallPending = true;
+
+    for (int i = 0; (i < match->playerCount) && (match->mode != MATCH_MODE_LOCKSTEP); ++i)
+    {
+        ServerConnection *connection = match->players[i].connection;
+        if (connection == NULL) continue;
+
+        NetWriter writer = BeginPlayerMessage(connection, MSG_GARBAGE);
+        WriteGarbage(&writer, index, garbage);
+        EndPlayerMessage(connection, &writer);
+    }
+
+    NetWriter writer = BeginSpectatorMessage(match, MSG_GARBAGE);
+    WriteGarbage(&writer, index, garbage);
+    if (!EndSpectatorMessage(match, &writer)) player->spectatorHeight = player->game->height;
+}
+
+// Charge the attack of a player with the safe tiles it just revealed, returns the opponent the
+// garbage it sends goes to (next one still playing), -1 if none
+internal int TakeGarbageAttack(ServerMatch *match, int from, int revealed, int tick, GameAction *garbage)
+{
+    ServerPlayer *player = &match->players[from];
+    if (!match->garbage || (revealed <= 0)) return -1;
+
+    player->garbageTiles += revealed;
+    int rows = player->garbageTiles/SERVER_GARBAGE_TILES;
+    if (rows == 0) return -1;
+    player->garbageTiles %= SERVER_GARBAGE_TILES;
+
+    for (int i = 1; i < match->playerCount; ++i)
+    {
+        int index = (from + i)%match->playerCount;
+        const GameState *game = match->players[index].game;
+        if (match->players[index].status != PLAYER_STATUS_PLAYING) continue;
+
+        // Mines at the density of the board, at least one a row
+        if (rows > maxBoardHeight) rows = maxBoardHeight;
+        int mines = rows*((game->maxMines + game->height - 1)/game->height);
+        if (mines > 255) mines = 255;
+
+        garbage->tick = tick;
+        garbage->type = ACTION_GARBAGE;
+        garbage->x = rows;
+        garbage->y = (mines > 0)? mines : rows;
+        return index;
+    }
+    return -1;
+}
+
+internal void StartServerMatch(ServerMatch *match, double now)
+{
+    match->started = true;
+    match->startTime = now;
+    match->wallTime = now;
+    match->wallFirst = 0;
+    match->lockstepStep = 0;
+    match->lockstepTime = now + SERVER_LOCKSTEP_STEP_TIME;
+    match->lockstepInputCount = 0;
+    ++matchesStarted;
+
+    const GameState *generated = NULL;
+    bool race = (match->mode == MATCH_MODE_RACE);
+    bool lockstep = (match->mode == MATCH_MODE_LOCKSTEP);
+    for (int i = 0; i < match->playerCount; ++i)
+    {
+        // NOTE: Lockstep clients run a board for every player, even one that left before the start
+        ServerPlayer *player = &match->players[i];
+        if ((player->status != PLAYER_STATUS_PLAYING) && !lockstep) continue;
+
+        // Every player gets its own board, a race gives them all the same one already opened
+        GameSettings settings = match->settings;
+        if (!race) settings.seed = GetMatchBoardSeed(match->settings.seed, i);
+        player->game = (GameState *)malloc(sizeof(GameState));
+        if (race && (generated != NULL)) memcpy(player->game, generated, sizeof(GameState));
+        else
+        {
+            InitGame(player->game, settings);
+            if (race) OpenGame(player->game);
+        }
+        generated = player->game;
+        player->keyframeTime = now + SERVER_KEYFRAME_TIME;
+        player->syncResetTime = now;
+
+        // NOTE: Race clients open the seeded board the same way, no keyframe to send them
+        player->sync = (BoardSync *)malloc(sizeof(BoardSync));
+        player->wallSync = (BoardSync *)malloc(sizeof(BoardSync));
+        if (race)
+        {
+            InitBoardSync(player->sync, player->game);
+            InitBoardSync(player->wallSync, player->game);
+        }
+        else
+        {
+            ResetBoardSync(player->sync, settings.width, settings.height);
+            ResetBoardSync(player->wallSync, settings.width, settings.height);
+        }
+        player->syncPending = !race && !lockstep;
+        player->wallPending = !race;
+        player->lockstepHash = GetGameStateHash(player->game);
+        player->lockstepChanged = false;
+        player->desynced = false;
+        player->garbageTiles = 0;
+        player->spectatorHeight = settings.height;
+        if (player->connection == NULL) continue;
+
+        NetWriter writer = BeginPlayerMessage(player->connection, MSG_MATCH_START);
+        NetWriteU32(&writer, match->id);
+        NetWriteU8(&writer, (unsigned int)i);
+        NetWriteU8(&writer, (unsigned int)match->playerCount);
+        NetWriteGameSettings(&writer, match->settings);
+        NetWriteU32(&writer, lockstep? match->settings.seed : settings.seed);
+        NetWriteU8(&writer, (unsigned int)match->mode);
+        EndPlayerMessage(player->connection, &writer);
+    }
+}
+
+internal void ApplyServerAction(ServerMatch *match, const ServerEvent *event, double now)
+{
+    ServerPlayer *player = &match->players[event->player];
+    GameState *game = player->game;
+    bool accepted = false;
+    int tick = (int)((now - match->startTime)/SIM_TICK_TIME);
+    int hiddenSafeTiles = (game != NULL)? game->hiddenSafeTiles : 0;
+
+    // NOTE: Actions are stamped with the server tick they are applied on, the debug reveal and garbage are not allowed
+    if (match->started && !match->ended && (player->status == PLAYER_STATUS_PLAYING) && (event->action.type < ACTION_REVEAL_ALL))
+    {
+        GameAction action = event->action;
+        action.tick = tick;
+        game->tick = tick;
+        accepted = ApplyGameAction(game, action);
+        if (accepted)
+        {
+            player->syncPending = true;
+            player->wallPending = true;
+            ++actionsApplied;
+        }
+    }
+
+    if (player->connection != NULL)
+    {
+        NetWriter writer = BeginPlayerMessage(player->connection, MSG_ACTION_RESULT);
+        NetWriteU32(&writer, event->sequence);
+        NetWriteU8(&writer, accepted? 1 : 0);
+        NetWriteU8(&writer, (game != NULL)? (unsigned int)game->hp : 0);
+        NetWriteU16(&writer, (game != NULL)? (unsigned int)game->hiddenSafeTiles : 0);
+        NetWriteU32(&writer, (unsigned int)tick);
+        EndPlayerMessage(player->connection, &writer);
+    }
+
+    if (accepted && IsGameOver(game))
+    {
+        player->status = game->winCon? PLAYER_STATUS_WON : PLAYER_STATUS_LOST;
+        if (game->winCon && (match->winner == NET_NO_PLAYER)) match->winner = event->player;
+        BroadcastPlayerStatus(match, event->player);
+    }
+
+    GameAction garbage = { 0 };
+    int target = accepted? TakeGarbageAttack(match, event->player, hiddenSafeTiles - game->hiddenSafeTiles, tick, &garbage) : -1;
+    if (target >= 0)
+    {
+        GameState *targetGame = match->players[target].game;
+        int height = targetGame->height;
+        targetGame->tick = tick;
+        if (ApplyGameAction(targetGame, garbage)) ShareGarbage(match, target, garbage, height);
+    }
+}
+
+// Lockstep: the input is applied on the tick of the step being gathered and relayed with it,
+// refused or not, every client refuses it the same way. Garbage it sends is an input of the same step.
+internal void ApplyLockstepInput(ServerMatch *match, int index, GameAction action)
+{
+    ServerPlayer *player = &match->players[index];
+    GameState *game = player->game;
+    if (match->lockstepInputCount >= NET_LOCKSTEP_MAX_INPUTS)
+    {
+        ++actionsDropped;
+        return;
+    }
+
+    unsigned char *input = &match->lockstepInputs[4*match->lockstepInputCount++];
+    input[0] = (unsigned char)index;
+    input[1] = (unsigned char)action.type;
+    input[2] = (unsigned char)action.x;
+    input[3] = (unsigned char)action.y;
+
+    int hiddenSafeTiles = game->hiddenSafeTiles;
+    int height = game->height;
+    action.tick = match->lockstepStep*NET_LOCKSTEP_STEP_TICKS;
+    game->tick = action.tick;
+    if (!ApplyGameAction(game, action)) return;
+
+    player->wallPending = true;
+    player->lockstepChanged = true;
+    if (action.type == ACTION_GARBAGE)
+    {
+        ShareGarbage(match, index, action, height);
+        return;
+    }
+    ++actionsApplied;
+
+    if (IsGameOver(game))
+    {
+        player->status = game->winCon? PLAYER_STATUS_WON : PLAYER_STATUS_LOST;
+        if (game->winCon && (match->winner == NET_NO_PLAYER)) match->winner = index;
+        BroadcastPlayerStatus(match, index);
+    }
+
+    GameAction garbage = { 0 };
+    int target = TakeGarbageAttack(match, index, hiddenSafeTiles - game->hiddenSafeTiles, action.tick, &garbage);
+    if (target >= 0) ApplyLockstepInput(match, target, garbage);
+}
+
+internal void ApplyLockstepAction(ServerMatch *match, const ServerEvent *event)
+{
+    const ServerPlayer *player = &match->players[event->player];
+    if (!match->started || match->ended || (player->status != PLAYER_STATUS_PLAYING) || (event->action.type >= ACTION_REVEAL_ALL)) return;
+
+    ApplyLockstepInput(match, event->player, event->action);
+}
+
+// Send the inputs of the step to every player and keep the state hash they must reach with them
+// NOTE: Only boards the step changed are hashed again, a quiet match costs the message alone.
+// The last step goes right away, clients see the end of the match with its last inputs applied.
+internal void SendLockstepStep(ServerMatch *match, double now, bool last)
+{
+    if ((match->mode != MATCH_MODE_LOCKSTEP) || match->ended || ((now < match->lockstepTime) && !last)) return;
+
+    unsigned long long boardHashes[SERVER_MAX_PLAYERS];
+    for (int i = 0; i < match->playerCount; ++i)
+    {
+        ServerPlayer *player = &match->players[i];
+        if (player->lockstepChanged) player->lockstepHash = GetGameStateHash(player->game);
+        player->lockstepChanged = false;
+        boardHashes[i] = player->lockstepHash;
+    }
+    match->lockstepHashes[match->lockstepStep%SERVER_LOCKSTEP_HASH_HISTORY] = GetLockstepHash(boardHashes, match->playerCount);
+
+    unsigned char message[NET_MESSAGE_HEADER_SIZE + NET_MAX_MESSAGE_SIZE];
+    NetWriter step = { message, (int)sizeof(message), 0, 0, false };
+    BeginNetMessage(&step, MSG_LOCKSTEP_STEP);
+    NetWriteU32(&step, (unsigned int)match->lockstepStep);
+    NetWriteU8(&step, (unsigned int)match->lockstepInputCount);
+    for (int i = 0; i < 4*match->lockstepInputCount; ++i) NetWriteU8(&step, match->lockstepInputs[i]);
+    EndNetMessage(&step);
+
+    // A player missing a step can not go on, it is cut off like one not taking its results
+    for (int i = 0; i < match->playerCount; ++i)
+    {
+        ServerConnection *connection = match->players[i].connection;
+        if ((connection == NULL) || connection->failed) continue;
+
+        if (connection->outputSize + step.size <= SERVER_OUTPUT_SIZE)
+        {
+            memcpy(connection->output + connection->outputSize, message, step.size);
+            connection->outputSize += step.size;
+        }
+        else
+        {
+            connection->failed = true;
+            ShutdownSocket(connection->socket, true);
+        }
+    }
+
+    ++match->lockstepStep;
+    match->lockstepInputCount = 0;
+    match->lockstepTime += SERVER_LOCKSTEP_STEP_TIME;
+    if (match->lockstepTime < now) match->lockstepTime = now + SERVER_LOCKSTEP_STEP_TIME;     // Late steps are not caught up
+}
+
+internal void CheckLockstepHash(ServerMatch *match, const ServerEvent *event)
+{
+    ServerPlayer *player = &match->players[event->player];
+    int step = (int)event->sequence;
+    bool kept = (step >= 0) && (step < match->lockstepStep) && (step >= match->lockstepStep - SERVER_LOCKSTEP_HASH_HISTORY);
+    if ((match->mode != MATCH_MODE_LOCKSTEP) || player->desynced || !kept) return;      // Too late to tell
+    if (event->hash == match->lockstepHashes[step%SERVER_LOCKSTEP_HASH_HISTORY]) return;
+
+    player->desynced = true;
+    ++lockstepDesyncs;
+    if (player->connection != NULL)
+    {
+        NetWriter writer = BeginPlayerMessage(player->connection, MSG_LOCKSTEP_DESYNC);
+        NetWriteU32(&writer, (unsigned int)step);
+        EndPlayerMessage(player->connection, &writer);
+    }
+}
+
+// Send every player the changes to its board, what does not fit in its output waits for the next frame
+internal void SyncPlayerBoards(ServerMatch *match, double now)
+{
+    if (match->mode == MATCH_MODE_LOCKSTEP) return;     // Clients run the boards themselves
+
+    int tick = (int)((now - match->startTime)/SIM_TICK_TIME);
+    for (int i = 0; i < match->playerCount; ++i)
+    {
+        ServerPlayer *player = &match->players[i];
+        if ((player->game == NULL) || (player->connection == NULL) || player->connection->failed) continue;
+
+        if (now >= player->keyframeTime)
+        {
+            ResetBoardSync(player->sync, player->game->width, player->game->height);
+            player->keyframeTime = now + SERVER_KEYFRAME_TIME;
+            player->syncResetTime = now;
+        }
+        if (!player->syncPending && !player->sync->keyframe) continue;
+
+        ServerConnection *connection = player->connection;
+        if (connection->outputSize >= SERVER_DELTA_OUTPUT_SIZE) continue;
+
+        // NOTE: Deltas leave room for results and statuses, a player is only cut off if those do not fit
+        NetWriter writer = { connection->output, SERVER_DELTA_OUTPUT_SIZE, connection->outputSize, 0, false };
+        player->syncPending = !WriteBoardDelta(player->sync, player->game, &writer, tick);
+        connection->outputSize = writer.size;
+    }
+}
+
+// The wall deltas of this update and the messages staged since the last one make the next delta frame
+internal void PublishSpectatorFrame(ServerMatch *match, int wallSize)
+{
+    if (match->spectatorKeyframe == NULL) return;      // Nobody watching
+
+    int size = match->spectatorMessageSize + wallSize;
+    if (size == 0)
+    {
+        if (match->ended) match->spectatorStreamEnded = true;
+        return;
+    }
+
+    SpectatorFrame *frame = (SpectatorFrame *)malloc(sizeof(SpectatorFrame) + size);
+    frame->references = 1;      // Held as the tail
+    frame->sequence = match->spectatorSequence++;
+    frame->next = NULL;
+    frame->size = size;
+    frame->data = (unsigned char *)(frame + 1);
+    memcpy(frame->data, match->spectatorMessages, match->spectatorMessageSize);
+    memcpy(frame->data + match->spectatorMessageSize, match->wallBuffer, wallSize);
+    match->spectatorMessageSize = 0;
+    for (int i = 0; i < match->playerCount; ++i) if (match->players[i].game != NULL) match->players[i].spectatorHeight = match->players[i].game->height;
+
+    SpectatorFrame *keyframe = match->spectatorKeyframe;
+    if ((keyframe->next == NULL) && (keyframe->sequence == frame->sequence))
+    {
+        keyframe->next = frame;
+        ++frame->references;
+    }
+    if (match->spectatorTail != NULL)
+    {
+        match->spectatorTail->next = frame;
+        ++frame->references;
+        ReleaseSpectatorFrame(match->spectatorTail);
+    }
+    match->spectatorTail = frame;
+}
+
+// Send every player the changes to the boards of its opponents, encoded once for the whole match
+internal void SyncOpponentBoards(ServerMatch *match, double now)
+{
+    // NOTE: Lockstep clients run every board, the wall is only encoded for spectators
+    bool lockstep = (match->mode == MATCH_MODE_LOCKSTEP);
+    if ((now < match->wallTime) || (lockstep && (match->spectatorKeyframe == NULL))) return;
+    match->wallTime = now + SERVER_WALL_TIME;
+
+    int tick = (int)((now - match->startTime)/SIM_TICK_TIME);
+    NetWriter wall = { match->wallBuffer, SERVER_WALL_BUFFER_SIZE, 0, 0, false };
+    for (int i = 0; i < match->playerCount; ++i)
+    {
+        int index = (match->wallFirst + i)%match->playerCount;
+        ServerPlayer *player = &match->players[index];
+        player->wallStart = wall.size;
+        if ((player->game != NULL) && (player->wallPending || player->wallSync->keyframe))
+        {
+            player->wallPending = !WriteOpponentDelta(player->wallSync, player->game, &wall, tick, index);
+        }
+        player->wallEnd = wall.size;
+    }
+    match->wallFirst = (match->wallFirst + 1)%match->playerCount;
+    PublishSpectatorFrame(match, wall.size);
+    if (lockstep) return;
+
+    for (int i = 0; i < match->playerCount; ++i)
+    {
+        ServerPlayer *player = &match->players[i];
+        ServerConnection *connection = player->connection;
+        if ((connection == NULL) || connection->failed) continue;
+
+        // Everything but its own board, or nothing: missing a delta means a keyframe of that board
+        int size = wall.size - (player->wallEnd - player->wallStart);
+        if (connection->outputSize + size <= SERVER_WALL_OUTPUT_SIZE)
+        {
+            memcpy(connection->output + connection->outputSize, match->wallBuffer, player->wallStart);
+            connection->outputSize += player->wallStart;
+            memcpy(connection->output + connection->outputSize, match->wallBuffer + player->wallEnd, wall.size - player->wallEnd);
+            connection->outputSize += wall.size - player->wallEnd;
+        }
+        else
+        {
+            for (int j = 0; j < match->playerCount; ++j) if ((j != i) && (match->players[j].game != NULL)) player->wallKeyframes[j] = true;
+        }
+
+        // NOTE: Only boards the opponents are up to date with, later deltas apply on top of the keyframe
+        for (int j = 0; (j < match->playerCount) && (connection->outputSize < SERVER_WALL_OUTPUT_SIZE); ++j)
+        {
+            const ServerPlayer *opponent = &match->players[j];
+            if (!player->wallKeyframes[j] || opponent->wallPending) continue;
+
+            BoardSync keyframe;
+            ResetBoardSync(&keyframe, opponent->game->width, opponent->game->height);
+            NetWriter writer = { connection->output, SERVER_WALL_OUTPUT_SIZE, connection->outputSize, 0, false };
+            if (!WriteOpponentDelta(&keyframe, opponent->game, &writer, tick, j)) break;      // Partial keyframe dropped
+
+            connection->outputSize = writer.size;
+            player->wallKeyframes[j] = false;
+        }
+    }
+}
+
+internal void EndServerMatch(ServerMatch *match, double now)
+{
+    match->ended = true;
+    match->endTime = now;
+
+    for (int i = 0; i < match->playerCount; ++i)
+    {
+        ServerConnection *connection = match->players[i].connection;
+        if (connection == NULL) continue;
+
+        NetWriter writer = BeginPlayerMessage(connection, MSG_MATCH_END);
+        NetWriteU8(&writer, (unsigned int)match->winner);
+        EndPlayerMessage(connection, &writer);
+    }
+
+    NetWriter writer = BeginSpectatorMessage(match, MSG_MATCH_END);
+    NetWriteU8(&writer, (unsigned int)match->winner);
+    EndSpectatorMessage(match, &writer);
+}
+
+// The whole match as spectators see it: start, statuses and every board as its opponents have it
+// NOTE: Boards are taken from what the wall sent so far (wallSync, revealed tiles never change
+// afterwards), the delta frames published after the keyframe apply on top of it
+internal SpectatorFrame *MakeSpectatorKeyframe(ServerMatch *match, int tick)
+{
+    GameState *shown = (GameState *)malloc(sizeof(GameState));
+    BoardSync *sync = (BoardSync *)malloc(sizeof(BoardSync));
+    SpectatorFrame *frame = NULL;
+    for (int capacity = SERVER_SPECTATOR_KEYFRAME_SIZE; frame == NULL; capacity *= 2)
+    {
+        frame = (SpectatorFrame *)malloc(sizeof(SpectatorFrame) + capacity);
+        NetWriter writer = { (unsigned char *)(frame + 1), capacity, 0, 0, false };
+
+        BeginNetMessage(&writer, MSG_SPECTATE_START);
+        NetWriteU32(&writer, match->id);
+        NetWriteU8(&writer, (unsigned int)match->playerCount);
+        NetWriteGameSettings(&writer, match->settings);
+        NetWriteU8(&writer, (unsigned int)match->mode);
+        bool complete = EndNetMessage(&writer);
+
+        for (int i = 0; complete && (i < match->playerCount); ++i)
+        {
+            BeginNetMessage(&writer, MSG_PLAYER_STATUS);
+            WritePlayerStatus(&writer, match, i);
+            complete = EndNetMessage(&writer);
+        }
+        for (int i = 0; complete && (i < match->playerCount); ++i)
+        {
+            // NOTE: Boards grown by garbage are announced at the height published so far, the
+            // garbage still staged is in the next delta frame, its rows are hidden until then
+            const ServerPlayer *player = &match->players[i];
+            if ((player->game != NULL) && (player->spectatorHeight > match->settings.height))
+            {
+                GameAction grown = { tick, ACTION_GARBAGE, player->spectatorHeight - match->settings.height, 0 };
+                BeginNetMessage(&writer, MSG_GARBAGE);
+                WriteGarbage(&writer, i, grown);
+                complete = EndNetMessage(&writer);
+            }
+            if ((player->game == NULL) || player->wallSync->keyframe) continue;    // Its next delta is a keyframe anyway
+
+            shown->width = player->game->width;
+            shown->height = player->spectatorHeight;
+            shown->hp = player->wallSync->hp;
+            for (int y = 0; y < shown->height; ++y)
+            {
+                memcpy(shown->board[y], player->game->board[y], shown->width);
+                memcpy(shown->boardMask[y], player->wallSync->boardMask[y], shown->width);
+            }
+            ResetBoardSync(sync, shown->width, shown->height);
+            complete = WriteOpponentDelta(sync, shown, &writer, tick, i);
+        }
+        if (complete && match->ended)
+        {
+            BeginNetMessage(&writer, MSG_MATCH_END);
+            NetWriteU8(&writer, (unsigned int)match->winner);
+            complete = EndNetMessage(&writer);
+        }
+
+        if (!complete)
+        {
+            free(frame);
+            frame = NULL;
+            continue;
+        }
+
+        frame = (SpectatorFrame *)realloc(frame, sizeof(SpectatorFrame) + writer.size);
+        frame->references = 1;      // Held as the latest keyframe
+        frame->sequence = match->spectatorSequence;
+        frame->next = NULL;
+        frame->size = writer.size;
+        frame->data = (unsigned char *)(frame + 1);
+    }
+    free(shown);
+    free(sync);
+
+    return frame;
+}
+
+// Send a spectator what its socket takes, straight from the shared frames
+internal void FlushSpectator(ServerMatch *match, ServerSpectator *spectator)
+{
+    ServerConnection *connection = spectator->connection;
+    if (connection->failed || spectator->closing) return;
+
+    // Between two frames, a spectator asking for it or too far behind starts again from the latest keyframe
+    SpectatorFrame *frame = spectator->frame;
+    bool between = (frame == NULL) || (spectator->offset == 0) || (spectator->offset == frame->size);
+    long long lag = (frame != NULL)? match->spectatorSequence - frame->sequence : 0;
+    if ((frame == NULL) || (between && (spectator->resync || (lag > SERVER_SPECTATOR_MAX_LAG)) && (frame != match->spectatorKeyframe)))
+    {
+        ReleaseSpectatorFrame(frame);
+        frame = match->spectatorKeyframe;
+        ++frame->references;
+        spectator->frame = frame;
+        spectator->offset = 0;
+        spectator->resync = false;
+    }
+    else if (lag > 2*SERVER_SPECTATOR_MAX_LAG)
+    {
+        connection->failed = true;      // Stuck in the middle of a frame
+        ShutdownSocket(connection->socket, true);
+        return;
+    }
+
+    for (;;)
+    {
+        if (spectator->offset == frame->size)
+        {
+            if (frame->next == NULL) break;
+
+            spectator->frame = frame->next;
+            ++frame->next->references;
+            ReleaseSpectatorFrame(frame);
+            frame = spectator->frame;
+            spectator->offset = 0;
+        }
+
+        int sent = SendSocket(connection->socket, frame->data + spectator->offset, frame->size - spectator->offset);
+        if (sent < 0)
+        {
+            connection->failed = true;
+            ShutdownSocket(connection->socket, true);
+            return;
+        }
+        if (sent == 0) break;
+
+        spectator->offset += sent;
+        bytesSent += sent;
+    }
+
+    // Everything sent, the spectator reads the end of the stream
+    if (match->spectatorStreamEnded && (frame->next == NULL) && (spectator->offset == frame->size))
+    {
+        ShutdownSocket(connection->socket, false);
+        spectator->closing = true;
+    }
+}
+
+internal void UpdateSpectators(ServerMatch *match, double now)
+{
+    if (match->spectatorCount == 0)
+    {
+        ReleaseSpectatorFrame(match->spectatorKeyframe);
+        ReleaseSpectatorFrame(match->spectatorTail);
+        match->spectatorKeyframe = NULL;
+        match->spectatorTail = NULL;
+        match->spectatorMessageSize = 0;
+        for (int i = 0; i < match->playerCount; ++i) if (match->players[i].game != NULL) match->players[i].spectatorHeight = match->players[i].game->height;
+        return;
+    }
+    if (!match->started) return;
+
+    if ((match->spectatorKeyframe == NULL) || ((now >= match->spectatorKeyframeTime) && !match->spectatorStreamEnded))
+    {
+        ReleaseSpectatorFrame(match->spectatorKeyframe);
+        match->spectatorKeyframe = MakeSpectatorKeyframe(match, (int)((now - match->startTime)/SIM_TICK_TIME));
+        match->spectatorKeyframeTime = now + SERVER_SPECTATOR_KEYFRAME_TIME;
+    }
+
+    for (int i = 0; i < match->spectatorCount; ++i) FlushSpectator(match, &match->spectators[i]);
+}
+
+internal ServerSpectator *FindSpectator(ServerMatch *match, const ServerConnection *connection)
+{
+    for (int i = 0; i < match->spectatorCount; ++i) if (match->spectators[i].connection == connection) return &match->spectators[i];
+    return NULL;
+}
+
+// Every player released its connection, the match slot can be filled again
+internal void FreeServerMatch(ServerMatch *match)
+{
+    for (int i = 0; i < match->playerCount; ++i)
+    {
+        free(match->players[i].game);
+        free(match->players[i].sync);
+        free(match->players[i].wallSync);
+    }
+    memset(match->players, 0, sizeof(match->players));
+    match->playerCount = 0;
+    free(match->spectators);
+    match->spectators = NULL;
+    match->spectatorCapacity = 0;
+    match->spectatorSequence = 0;
+    match->spectatorStreamEnded = false;
+    match->started = false;
+    match->ended = false;
+    match->lingerExpired = false;
+    ++matchesFinished;
+
+    match->state.store(MATCH_FREE, std::memory_order_release);
+}
+
+// Returns false once the match is freed, the network thread may already reuse it
+internal bool UpdateServerMatch(ServerMatch *match, double now)
+{
+    ServerEvent event = { };
+    while (PopServerEvent(match, &event))
+    {
+        ServerPlayer *player = (event.player >= 0)? &match->players[event.player] : NULL;
+        switch (event.type)
+        {
+            case SERVER_EVENT_JOIN:
+            {
+                player->connection = event.connection;
+                player->status = PLAYER_STATUS_PLAYING;
+                player->joined = true;
+                if (event.player >= match->playerCount) match->playerCount = event.player + 1;
+                if (match->playerCount == 1) match->winner = NET_NO_PLAYER;
+            } break;
+            case SERVER_EVENT_START: StartServerMatch(match, now); break;
+            case SERVER_EVENT_ACTION:
+            {
+                if (match->mode == MATCH_MODE_LOCKSTEP) ApplyLockstepAction(match, &event);
+                else ApplyServerAction(match, &event, now);
+            } break;
+            case SERVER_EVENT_LOCKSTEP_HASH: CheckLockstepHash(match, &event); break;
+            case SERVER_EVENT_LEAVE:
+            {
+                ReleaseConnection(player->connection);
+                player->connection = NULL;
+                if (player->status == PLAYER_STATUS_PLAYING)
+                {
+                    player->status = PLAYER_STATUS_LEFT;
+                    if (match->started) BroadcastPlayerStatus(match, event.player);
+                }
+            } break;
+            case SERVER_EVENT_SYNC_REQUEST:
+            {
+                if (player == NULL)
+                {
+                    ServerSpectator *spectator = FindSpectator(match, event.connection);
+                    if (spectator != NULL) spectator->resync = true;
+                }
+                else if ((event.board == event.player) && (player->sync != NULL))
+                {
+                    // NOTE: A client failing every delta asks again each time, it gets one keyframe per SERVER_SYNC_REQUEST_TIME
+                    double requestTime = player->syncResetTime + SERVER_SYNC_REQUEST_TIME;
+                    if (requestTime < now) requestTime = now;
+                    if (requestTime < player->keyframeTime) player->keyframeTime = requestTime;
+                }
+                else if ((event.board < match->playerCount) && (match->players[event.board].game != NULL)) player->wallKeyframes[event.board] = true;
+            } break;
+            case SERVER_EVENT_SPECTATE:
+            {
+                // NOTE: The slot may have been freed and filled again since the spectator asked for it
+                if ((event.match != match->id) || (match->spectatorCount >= SERVER_MAX_SPECTATORS))
+                {
+                    ShutdownSocket(event.connection->socket, true);
+                    ReleaseConnection(event.connection);
+                    break;
+                }
+
+                if (match->spectatorCount >= match->spectatorCapacity)
+                {
+                    match->spectatorCapacity = (match->spectatorCapacity > 0)? 2*match->spectatorCapacity : 16;
+                    match->spectators = (ServerSpectator *)realloc(match->spectators, match->spectatorCapacity*sizeof(ServerSpectator));
+                }
+                ServerSpectator *spectator = &match->spectators[match->spectatorCount++];
+                memset(spectator, 0, sizeof(ServerSpectator));
+                spectator->connection = event.connection;
+                ++spectatorsWatching;
+            } break;
+            case SERVER_EVENT_UNSPECTATE:
+            {
+                ServerSpectator *spectator = FindSpectator(match, event.connection);
+                if (spectator == NULL) break;       // Turned away when it joined
+
+                ReleaseSpectatorFrame(spectator->frame);
+                ReleaseConnection(spectator->connection);
+                *spectator = match->spectators[--match->spectatorCount];
+                --spectatorsWatching;
+            } break;
+            default: break;
+        }
+    }
+
+    if (!match->started) return true;
+
+    SyncPlayerBoards(match, now);
+    SyncOpponentBoards(match, now);
+
+    bool playing = false;
+    bool connected = false;
+    for (int i = 0; i < match->playerCount; ++i)
+    {
+        if (match->players[i].status == PLAYER_STATUS_PLAYING) playing = true;
+        if (match->players[i].connection != NULL) connected = true;
+    }
+
+    bool raceWon = (match->mode == MATCH_MODE_RACE) && (match->winner != NET_NO_PLAYER);
+    SendLockstepStep(match, now, !playing || raceWon);
+    if (!match->ended && (!playing || raceWon)) EndServerMatch(match, now);
+    UpdateSpectators(match, now);
+
+    // Players still connected long after the end are cut off, the network thread reports them left
+    if (match->ended && !match->lingerExpired && (now - match->endTime >= SERVER_MATCH_LINGER_TIME))
+    {
+        for (int i = 0; i < match->playerCount; ++i)
+        {
+            if (match->players[i].connection != NULL) ShutdownSocket(match->players[i].connection->socket, true);
+        }
+        for (int i = 0; i < match->spectatorCount; ++i) ShutdownSocket(match->spectators[i].connection->socket, true);
+        match->lingerExpired = true;
+    }
+
+    for (int i = 0; i < match->playerCount; ++i)
+    {
+        if (match->players[i].connection != NULL) FlushPlayerOutput(match->players[i].connection);
+    }
+
+    if (match->ended && !connected && (match->spectatorCount == 0))
+    {
+        FreeServerMatch(match);
+        return false;
+    }
+
+    return true;
+}
+
+// A worker over the tick budget, or further than a fraction of it above the least loaded worker,
+// hands that worker the match bringing them closest, never one costing more than the gap
+internal void RebalanceServerWorker(int worker, double now)
+{
+    ServerWorker *self = &serverWorkers[worker];
+    if ((workerCount < 2) || (now < self->rebalanceTime)) return;
+
+    int target = -1;
+    int targetLoad = 0;
+    for (int i = 0; i < workerCount; ++i)
+    {
+        int load = serverWorkers[i].load.load(std::memory_order_relaxed);
+        if ((i != worker) && ((target < 0) || (load < targetLoad)))
+        {
+            target = i;
+            targetLoad = load;
+        }
+    }
+
+    int load = self->load.load(std::memory_order_relaxed);
+    int gap = load - targetLoad;
+    if ((load <= tickBudget) && (gap <= tickBudget/SERVER_REBALANCE_GAP)) return;
+
+    ServerMatch *moved = NULL;
+    float movedMiss = 0.0f;
+    for (int i = 0; i < SERVER_MAX_MATCHES; ++i)
+    {
+        ServerMatch *match = &matches[i];
+        if (match->state.load(std::memory_order_acquire) != MATCH_ACTIVE) continue;
+        if (match->worker.load(std::memory_order_relaxed) != worker) continue;
+        if ((match->cost <= 0.0f) || (match->cost >= gap)) continue;
+
+        float miss = fabsf(match->cost - 0.5f*gap);
+        if ((moved == NULL) || (miss < movedMiss))
+        {
+            moved = match;
+            movedMiss = miss;
+        }
+    }
+    if (moved == NULL) return;
+
+    // NOTE: Loads are estimates until both workers measured their next frame
+    self->load.fetch_sub((int)moved->cost, std::memory_order_relaxed);
+    self->matchCount.fetch_sub(1, std::memory_order_relaxed);
+    serverWorkers[target].load.fetch_add((int)moved->cost, std::memory_order_relaxed);
+    serverWorkers[target].matchCount.fetch_add(1, std::memory_order_relaxed);
+    moved->worker.store(target, std::memory_order_release);
+    ++matchesMoved;
+    self->rebalanceTime = now + SERVER_REBALANCE_TIME;
+}
+
+internal void ServerWorkerThread(int worker)
+{
+    ServerWorker *self = &serverWorkers[worker];
+    double nextFrameTime = GetSeconds();
+    while (serverRunning)
+    {
+        double now = GetSeconds();
+        long long depthSum = 0;
+        int depthMax = 0;
+        int matchCount = 0;
+        int owned = 0;                  // Still active after their update
+        float load = 0.0f;
+        for (int i = 0; i < SERVER_MAX_MATCHES; ++i)
+        {
+            ServerMatch *match = &matches[i];
+            if (match->state.load(std::memory_order_acquire) != MATCH_ACTIVE) continue;
+            if (match->worker.load(std::memory_order_acquire) != worker) continue;
+
+            int depth = (int)(match->eventWrite.load(std::memory_order_relaxed) - match->eventRead);
+            depthSum += depth;
+            if (depth > depthMax) depthMax = depth;
+            ++matchCount;
+
+            double updateStart = GetSeconds();
+            bool active = UpdateServerMatch(match, now);
+            int cost = (int)((GetSeconds() - updateStart)*1000000.0);
+            RecordMax(&matchCostMax, cost);
+            if (!active) continue;
+
+            // NOTE: Spikes (a flood fill over the whole board) are kept in matchCostMax, the smoothed
+            // cost is what the match takes frame after frame
+            match->cost = (match->cost > 0.0f)? match->cost + SERVER_COST_SMOOTHING*(cost - match->cost) : (float)cost;
+            load += match->cost;
+            ++owned;
+        }
+        self->load.store((int)load, std::memory_order_relaxed);
+        self->matchCount.store(owned, std::memory_order_relaxed);
+
+        double frameEnd = GetSeconds();
+        int frameMicroseconds = (int)((frameEnd - now)*1000000.0);
+        if (frameMicroseconds > tickBudget) ++tickOverruns;
+        int bucket = (int)(frameMicroseconds/(SERVER_TICK_BUCKET_TIME*1000.0));
+        if (bucket >= SERVER_TICK_BUCKETS) bucket = SERVER_TICK_BUCKETS - 1;
+        tickHistogram[bucket].fetch_add(1, std::memory_order_relaxed);
+        ++tickCount;
+        RecordMax(&workerFrameMax, frameMicroseconds);
+        RecordMax(&tickMax, frameMicroseconds);
+        if (matchCount > 0)
+        {
+            queueDepthSum += depthSum;
+            queueDepthSamples += matchCount;
+            RecordMax(&queueDepthMax, depthMax);
+            RecordMax(&queueDepthWindowMax, depthMax);
+        }
+
+        RebalanceServerWorker(worker, frameEnd);
+
+        // Fixed rate, a late frame is not caught up
+        nextFrameTime += SERVER_FRAME_TIME;
+        if (nextFrameTime < frameEnd) nextFrameTime = frameEnd;
+        SleepSeconds(nextFrameTime - frameEnd);
+    }
+}
+
+//----------------------------------------------------------------------------------
+// Network thread
+//----------------------------------------------------------------------------------
+typedef struct QueuedPlayer {
+    ServerConnection *connection;
+    int rating;
+    GameSettings board;         // Board asked for, the server one if it asked for none
+    double joinTime;
+} QueuedPlayer;
+
+typedef struct ServerLobby {
+    ServerSettings settings;
+    QueuedPlayer *queue;        // Players waiting for a match, sorted by board then rating on every update
+    int queueCount;
+    int queueCapacity;
+    int nextMatch;              // Where the search for a free match starts
+    unsigned int matchCount;
+} ServerLobby;
+
+// Boards a client may ask for, anything the game core can generate
+internal bool IsValidBoard(GameSettings board)
+{
+    if ((board.width < 3) || (board.width > maxBoardWidth) || (board.height < 3) || (board.height > maxBoardHeight)) return false;
+    if (board.startingHP < 1) return false;
+
+    // NOTE: The first click clears a 3x3 area
+    if (board.mineGenMode) return (board.minesDesired >= 1) && (board.minesDesired <= board.width*board.height - 9);
+    return (board.mineDensity >= 1) && (board.mineDensity < 100);
+}
+
+internal bool IsSameBoard(const GameSettings *a, const GameSettings *b)
+{
+    if ((a->width != b->width) || (a->height != b->height) || (a->mineGenMode != b->mineGenMode) || (a->startingHP != b->startingHP)) return false;
+    return a->mineGenMode? (a->minesDesired == b->minesDesired) : (a->mineDensity == b->mineDensity);
+}
+
+// Same boards next to each other, by rating then join time within them
+internal int CompareQueuedPlayers(const void *a, const void *b)
+{
+    const QueuedPlayer *first = (const QueuedPlayer *)a;
+    const QueuedPlayer *second = (const QueuedPlayer *)b;
+    const GameSettings *x = &first->board;
+    const GameSettings *y = &second->board;
+
+    int mines[2] = { x->mineGenMode? x->minesDesired : x->mineDensity, y->mineGenMode? y->minesDesired : y->mineDensity };
+    int keys[6][2] = { { x->width, y->width }, { x->height, y->height }, { x->mineGenMode, y->mineGenMode }, { mines[0], mines[1] },
+                       { x->startingHP, y->startingHP }, { first->rating, second->rating } };
+    for (int i = 0; i < 6; ++i) if (keys[i][0] != keys[i][1]) return (keys[i][0] < keys[i][1])? -1 : 1;
+    if (first->joinTime != second->joinTime) return (first->joinTime < second->joinTime)? -1 : 1;
+
+    return 0;
+}
+
+// Rating difference allowed around a player who waited since joinTime
+internal int GetRatingSpread(double joinTime, double now)
+{
+    return SERVER_RATING_SPREAD + (int)((now - joinTime)*SERVER_RATING_SPREAD_GROWTH);
+}
+
+internal void QueueServerPlayer(ServerLobby *lobby, ServerConnection *connection, int rating, GameSettings board)
+{
+    if (lobby->queueCount >= lobby->queueCapacity)
+    {
+        lobby->queueCapacity = (lobby->queueCapacity > 0)? 2*lobby->queueCapacity : 256;
+        lobby->queue = (QueuedPlayer *)realloc(lobby->queue, lobby->queueCapacity*sizeof(QueuedPlayer));
+    }
+
+    QueuedPlayer *queued = &lobby->queue[lobby->queueCount++];
+    queued->connection = connection;
+    queued->rating = rating;
+    queued->board = board;
+    queued->joinTime = GetSeconds();
+    connection->queued = true;
+}
+
+internal void RemoveQueuedPlayer(ServerLobby *lobby, ServerConnection *connection)
+{
+    for (int i = 0; i < lobby->queueCount; ++i)
+    {
+        if (lobby->queue[i].connection != connection) continue;
+
+        memmove(&lobby->queue[i], &lobby->queue[i + 1], (lobby->queueCount - i - 1)*sizeof(QueuedPlayer));
+        --lobby->queueCount;
+        break;
+    }
+    connection->queued = false;
+}
+
+// Least loaded worker, the match placed on it counted at the mean match cost until it is measured
+internal int PlaceServerMatch(void)
+{
+    long long totalLoad = 0;
+    long long totalMatches = 0;
+    int worker = -1;
+    int workerLoad = 0;
+    int workerMatches = 0;
+    for (int i = 0; i < workerCount; ++i)
+    {
+        int load = serverWorkers[i].load.load(std::memory_order_relaxed);
+        int count = serverWorkers[i].matchCount.load(std::memory_order_relaxed);
+        totalLoad += load;
+        totalMatches += count;
+
+        // NOTE: Idle workers all measure nothing, the one with fewer matches gets it
+        if ((worker < 0) || (load < workerLoad) || ((load == workerLoad) && (count < workerMatches)))
+        {
+            worker = i;
+            workerLoad = load;
+            workerMatches = count;
+        }
+    }
+
+    int meanCost = (totalMatches > 0)? (int)(totalLoad/totalMatches) : 0;
+    serverWorkers[worker].load.fetch_add(meanCost, std::memory_order_relaxed);
+    serverWorkers[worker].matchCount.fetch_add(1, std::memory_order_relaxed);
+
+    return worker;
+}
+
+// Start a match with the queued players first to first + count, false if no match is free
+internal bool StartQueuedMatch(ServerLobby *lobby, int first, int count)
+{
+    int index = -1;
+    for (int i = 0; (i < SERVER_MAX_MATCHES) && (index < 0); ++i)
+    {
+        int candidate = (lobby->nextMatch + i)%SERVER_MAX_MATCHES;
+        if (matches[candidate].state.load(std::memory_order_acquire) == MATCH_FREE) index = candidate;
+    }
+    if (index < 0) return false;
+
+    ServerMatch *match = &matches[index];
+    match->id = ++lobby->matchCount;
+    match->settings = lobby->queue[first].board;
+    match->mode = lobby->settings.mode;
+    match->garbage = lobby->settings.garbage && (match->mode != MATCH_MODE_RACE);
+    match->settings.seed = (unsigned int)time(NULL) ^ (match->id*0x9e3779b9u);
+    match->cost = 0.0f;
+    match->worker.store(PlaceServerMatch(), std::memory_order_relaxed);
+    match->state.store(MATCH_ACTIVE, std::memory_order_release);
+    lobby->nextMatch = index + 1;
+
+    // NOTE: A free match queue is empty, every join and the start fit in it
+    double now = GetSeconds();
+    for (int i = 0; i < count; ++i)
+    {
+        QueuedPlayer *queued = &lobby->queue[first + i];
+        ServerEvent event = { };
+        event.type = SERVER_EVENT_JOIN;
+        event.player = i;
+        event.connection = queued->connection;
+        ++queued->connection->references;
+        PushServerEvent(match, &event);
+
+        queued->connection->match = index;
+        queued->connection->player = i;
+        queued->connection->queued = false;
+        ++playersJoined;
+        queueWaitSum += (long long)((now - queued->joinTime)*1000.0);
+        ++queueWaitSamples;
+    }
+
+    ServerEvent event = { };
+    event.type = SERVER_EVENT_START;
+    PushServerEvent(match, &event);
+
+    memmove(&lobby->queue[first], &lobby->queue[first + count], (lobby->queueCount - first - count)*sizeof(QueuedPlayer));
+    lobby->queueCount -= count;
+    return true;
+}
+
+// Active match of that id, for 0 the latest started one, -1 if there is none
+internal int FindServerMatch(unsigned int id)
+{
+    int found = -1;
+    for (int i = 0; i < SERVER_MAX_MATCHES; ++i)
+    {
+        if (matches[i].state.load(std::memory_order_acquire) != MATCH_ACTIVE) continue;
+
+        if (id != 0)
+        {
+            if (matches[i].id == id) return i;
+        }
+        else if ((found < 0) || (matches[i].id > matches[found].id)) found = i;
+    }
+
+    return found;
+}
+
+// Batch queued players into matches: full ones as soon as their ratings are close enough, then
+// smaller ones around each player who waited SERVER_MATCH_FILL_TIME
+internal void UpdateServerLobby(ServerLobby *lobby)
+{
+    if (lobby->queueCount == 0) return;
+
+    double now = GetSeconds();
+    int size = lobby->settings.playersPerMatch;
+    QueuedPlayer *queue = lobby->queue;
+    qsort(queue, lobby->queueCount, sizeof(QueuedPlayer), CompareQueuedPlayers);
+
+    // NOTE: Sorted by rating, a window of size players is the closest batch its first player gets
+    for (int first = 0; first + size <= lobby->queueCount;)
+    {
+        int last = first + size - 1;
+        double joinTime = queue[first].joinTime;
+        for (int i = first + 1; i <= last; ++i) if (queue[i].joinTime < joinTime) joinTime = queue[i].joinTime;
+
+        bool close = IsSameBoard(&queue[first].board, &queue[last].board) && (queue[last].rating - queue[first].rating <= GetRatingSpread(joinTime, now));
+        if (!close) ++first;
+        else if (!StartQueuedMatch(lobby, first, size)) return;     // Server full
+    }
+
+    for (int i = 0; i < lobby->queueCount; ++i)
+    {
+        if (now - queue[i].joinTime < SERVER_MATCH_FILL_TIME) continue;
+
+        // Grow the batch towards the closest rating on either side
+        int spread = GetRatingSpread(queue[i].joinTime, now);
+        int first = i;
+        int last = i;
+        while (last - first + 1 < size)
+        {
+            bool below = (first > 0) && IsSameBoard(&queue[first - 1].board, &queue[i].board) && (queue[i].rating - queue[first - 1].rating <= spread);
+            bool above = (last + 1 < lobby->queueCount) && IsSameBoard(&queue[last + 1].board, &queue[i].board) && (queue[last + 1].rating - queue[i].rating <= spread);
+            if (below && (!above || (queue[i].rating - queue[first - 1].rating <= queue[last + 1].rating - queue[i].rating))) --first;
+            else if (above) ++last;
+            else break;
+        }
+
+        if (!StartQueuedMatch(lobby, first, last - first + 1)) return;
+        i = first - 1;
+    }
+}
+
+// Returns false once the player must be disconnected
+internal bool HandleServerMessage(ServerLobby *lobby, ServerConnection *connection, NetMessageType type, NetReader *payload)
+{
+    switch (type)
+    {
+        case MSG_JOIN:
+        {
+            if ((connection->match >= 0) || connection->queued || (NetReadU8(payload) != NET_PROTOCOL_VERSION)) return false;
+            int rating = (int)NetReadU16(payload);
+            GameSettings board = NetReadGameSettings(payload);
+            if (payload->overflow) return false;
+
+            if (board.width == 0) board = lobby->settings.board;
+            else if (!IsValidBoard(board)) return false;
+            QueueServerPlayer(lobby, connection, rating, board);
+        } break;
+        case MSG_SPECTATE:
+        {
+            if ((connection->match >= 0) || connection->queued || (NetReadU8(payload) != NET_PROTOCOL_VERSION)) return false;
+            unsigned int id = NetReadU32(payload);
+            if (payload->overflow) return false;
+
+            // NOTE: Turned away if there is no such match or its queue is full, it can ask again
+            int index = FindServerMatch(id);
+            if (index < 0) return false;
+
+            ServerEvent event = { };
+            event.type = SERVER_EVENT_SPECTATE;
+            event.player = -1;
+            event.connection = connection;
+            event.match = matches[index].id;
+            ++connection->references;
+            if (!PushServerEvent(&matches[index], &event))
+            {
+                --connection->references;
+                return false;
+            }
+
+            connection->match = index;
+            connection->spectator = true;
+        } break;
+        case MSG_ACTION:
+        {
+            if (connection->spectator) return false;
+
+            ServerEvent event = { };
+            event.type = SERVER_EVENT_ACTION;
+            event.player = connection->player;
+            event.sequence = NetReadU32(payload);
+            event.action.type = (GameActionType)NetReadU8(payload);
+            event.action.x = (int)NetReadU8(payload);
+            event.action.y = (int)NetReadU8(payload);
+            if (payload->overflow) return false;
+
+            ++actionsReceived;
+            if ((connection->match < 0) || !PushServerEvent(&matches[connection->match], &event)) ++actionsDropped;
+        } break;
+        case MSG_LOCKSTEP_HASH:
+        {
+            if (connection->spectator) return false;
+
+            // NOTE: Lost if the queue is full, the next step is checked instead
+            ServerEvent event = { };
+            event.type = SERVER_EVENT_LOCKSTEP_HASH;
+            event.player = connection->player;
+            event.sequence = NetReadU32(payload);
+            event.hash = NetReadU32(payload);
+            if (payload->overflow) return false;
+
+            if (connection->match >= 0) PushServerEvent(&matches[connection->match], &event);
+        } break;
+        case MSG_SYNC_REQUEST:
+        {
+            // NOTE: Lost if the queue is full, the client asks again on its next checksum mismatch
+            ServerEvent event = { };
+            event.type = SERVER_EVENT_SYNC_REQUEST;
+            event.player = connection->player;
+            event.connection = connection;      // Spectators are told apart by it
+            event.board = (int)NetReadU8(payload);
+            if (payload->overflow) return false;
+
+            if (connection->match >= 0) PushServerEvent(&matches[connection->match], &event);
+        } break;
+        default: return false;
+    }
+
+    return !payload->overflow;
+}
+
+// Read what arrived and handle every complete message, false once the player is gone
+internal bool ReadServerConnection(ServerLobby *lobby, ServerConnection *connection)
+{
+    // NOTE: One read per poll, a flooding player can not starve the others
+    int received = ReceiveSocket(connection->socket, connection->input + connection->inputSize, (int)sizeof(connection->input) - connection->inputSize);
+    if (received < 0) return false;
+    connection->inputSize += received;
+
+    int offset = 0;
+    for (;;)
+    {
+        NetMessageType type = (NetMessageType)0;
+        NetReader payload = { 0 };
+        int size = ReadNetMessage(connection->input + offset, connection->inputSize - offset, &type, &payload);
+        if (size < 0) return false;
+        if (size == 0) break;
+
+        if (!HandleServerMessage(lobby, connection, type, &payload)) return false;
+        offset += size;
+    }
+
+    memmove(connection->input, connection->input + offset, connection->inputSize - offset);
+    connection->inputSize -= offset;
+    return true;
+}
+
+// Tell the match the player (or spectator) left, false if its queue is full (retried later)
+internal bool LeaveServerMatch(ServerConnection *connection)
+{
+    if (connection->match < 0) return true;
+
+    ServerEvent event = { };
+    event.type = connection->spectator? SERVER_EVENT_UNSPECTATE : SERVER_EVENT_LEAVE;
+    event.player = connection->player;
+    event.connection = connection;
+    return PushServerEvent(&matches[connection->match], &event);
+}
+
+//----------------------------------------------------------------------------------
+// Match Server Functions Definition
+//----------------------------------------------------------------------------------
+ServerSettings GetDefaultServerSettings(void)
+{
+    ServerSettings settings = { 0 };
+    settings.port = SERVER_DEFAULT_PORT;
+    settings.workerCount = 0;
+    settings.playersPerMatch = SERVER_MAX_PLAYERS;
+    settings.board.width = 16;
+    settings.board.height = 16;
+    settings.board.mineGenMode = true;
+    settings.board.minesDesired = 40;
+    settings.board.startingHP = 3;
+    settings.mode = MATCH_MODE_OWN_BOARDS;
+    settings.garbage = false;
+    settings.tickBudget = SERVER_DEFAULT_TICK_BUDGET;
+
+    return settings;
+}
+
+int RunMatchServer(ServerSettings settings)
+{
+    if (!InitNetwork())
+    {
+        printf("server: network initialization failed\n");
+        return 1;
+    }
+
+    NetSocket listener = OpenListenSocket(settings.port);
+    if (listener == NET_INVALID_SOCKET)
+    {
+        printf("server: can not listen on port %i\n", settings.port);
+        CloseNetwork();
+        return 2;
+    }
+
+    if (settings.playersPerMatch < 1) settings.playersPerMatch = 1;
+    if (settings.playersPerMatch > SERVER_MAX_PLAYERS) settings.playersPerMatch = SERVER_MAX_PLAYERS;
+    workerCount = (settings.workerCount > 0)? settings.workerCount : (int)std::thread::hardware_concurrency();
+    if (workerCount < 1) workerCount = 1;
+    tickBudget = (int)(((settings.tickBudget > 0.0f)? settings.tickBudget : SERVER_DEFAULT_TICK_BUDGET)*1000.0f);
+
+    serverWorkers = new ServerWorker[workerCount];
+    for (int i = 0; i < workerCount; ++i)
+    {
+        serverWorkers[i].load = 0;
+        serverWorkers[i].matchCount = 0;
+        serverWorkers[i].rebalanceTime = 0.0;
+    }
+
+    matches = new ServerMatch[SERVER_MAX_MATCHES];
+    for (int i = 0; i < SERVER_MAX_MATCHES; ++i)
+    {
+        matches[i].state = MATCH_FREE;
+        matches[i].worker = 0;
+        matches[i].cost = 0.0f;
+        matches[i].eventWrite = 0;
+        matches[i].eventRead = 0;
+        for (int j = 0; j < SERVER_EVENT_QUEUE_SIZE; ++j) matches[i].events[j].turn = 0;
+        memset(matches[i].players, 0, sizeof(matches[i].players));
+        matches[i].playerCount = 0;
+        matches[i].started = false;
+        matches[i].ended = false;
+        matches[i].lingerExpired = false;
+        matches[i].lockstepStep = 0;
+        matches[i].lockstepInputCount = 0;
+        matches[i].spectators = NULL;
+        matches[i].spectatorCount = 0;
+        matches[i].spectatorCapacity = 0;
+        matches[i].spectatorKeyframe = NULL;
+        matches[i].spectatorTail = NULL;
+        matches[i].spectatorSequence = 0;
+        matches[i].spectatorStreamEnded = false;
+        matches[i].spectatorMessageSize = 0;
+    }
+
+    ResetServerLoadStats();
+    serverRunning = true;
+    signal(SIGINT, StopServer);
+
+    std::thread *workerThreads = new std::thread[workerCount];
+    for (int i = 0; i < workerCount; ++i) workerThreads[i] = std::thread(ServerWorkerThread, i);
+
+    const char *modeText = (settings.mode == MATCH_MODE_RACE)? ", races" : (settings.mode == MATCH_MODE_LOCKSTEP)? ", lockstep" : "";
+    const char *garbageText = (settings.garbage && (settings.mode != MATCH_MODE_RACE))? ", garbage" : "";
+    printf("server: listening on port %i, %i workers (%.1fms tick budget), up to %i players per match%s%s (Ctrl+C to stop)\n",
+           settings.port, workerCount, tickBudget/1000.0, settings.playersPerMatch, modeText, garbageText);
+
+    ServerLobby lobby = { };
+    lobby.settings = settings;
+
+    ServerConnection **connections = NULL;      // Polled connections
+    int connectionCount = 0;
+    int connectionCapacity = 0;
+    ServerConnection **leaving = NULL;          // Disconnected, their match queue was full
+    int leavingCount = 0;
+    NetPollEntry *entries = NULL;
+
+    double statsTime = GetSeconds() + SERVER_STATS_TIME;
+    long long statsActions = 0;
+    long long statsBytes = 0;
+    long long *statsHistogram = (long long *)calloc(SERVER_TICK_BUCKETS, sizeof(long long));     // Worker frames of the previous lines
+    while (serverRunning)
+    {
+        entries = (NetPollEntry *)realloc(entries, (connectionCount + 1)*sizeof(NetPollEntry));
+        entries[0].socket = listener;
+        for (int i = 0; i < connectionCount; ++i) entries[i + 1].socket = connections[i]->socket;
+
+        PollSockets(entries, connectionCount + 1, SERVER_POLL_TIMEOUT);
+
+        // Handle the sockets polled before appending new connections
+        int polledCount = connectionCount;
+        for (int i = polledCount - 1; i >= 0; --i)
+        {
+            ServerConnection *connection = connections[i];
+            bool open = true;
+            if (entries[i + 1].readable || entries[i + 1].closed) open = ReadServerConnection(&lobby, connection);
+            if (open) continue;
+
+            connections[i] = connections[--connectionCount];
+            if (connection->queued) RemoveQueuedPlayer(&lobby, connection);
+            if (LeaveServerMatch(connection)) ReleaseConnection(connection);
+            else
+            {
+                leaving = (ServerConnection **)realloc(leaving, (leavingCount + 1)*sizeof(ServerConnection *));
+                leaving[leavingCount++] = connection;
+            }
+        }
+
+        for (int i = leavingCount - 1; i >= 0; --i)
+        {
+            if (!LeaveServerMatch(leaving[i])) continue;
+            ReleaseConnection(leaving[i]);
+            leaving[i] = leaving[--leavingCount];
+        }
+
+        if (entries[0].readable)
+        {
+            for (NetSocket socket = AcceptSocket(listener); socket != NET_INVALID_SOCKET; socket = AcceptSocket(listener))
+            {
+                ServerConnection *connection = new ServerConnection();
+                connection->socket = socket;
+                connection->references = 1;
+                connection->match = -1;
+                connection->player = -1;
+                connection->queued = false;
+                connection->spectator = false;
+                connection->inputSize = 0;
+                connection->outputSize = 0;
+                connection->failed = false;
+
+                if (connectionCount >= connectionCapacity)
+                {
+                    connectionCapacity = (connectionCapacity > 0)? 2*connectionCapacity : 256;
+                    connections = (ServerConnection **)realloc(connections, connectionCapacity*sizeof(ServerConnection *));
+                }
+                connections[connectionCount++] = connection;
+            }
+        }
+
+        UpdateServerLobby(&lobby);
+
+        double now = GetSeconds();
+        if (now >= statsTime)
+        {
+            int activeCount = 0;
+            for (int i = 0; i < SERVER_MAX_MATCHES; ++i) if (matches[i].state.load(std::memory_order_relaxed) == MATCH_ACTIVE) ++activeCount;
+
+            long long actions = actionsReceived;
+            long long bytes = bytesSent;
+            double connectionBytes = (connectionCount > 0)? (bytes - statsBytes)/SERVER_STATS_TIME/connectionCount : 0.0;
+
+            long long frames[SERVER_TICK_BUCKETS];
+            long long frameCount = 0;
+            for (int i = 0; i < SERVER_TICK_BUCKETS; ++i)
+            {
+                long long total = tickHistogram[i].load(std::memory_order_relaxed);
+                frames[i] = total - statsHistogram[i];
+                frameCount += frames[i];
+                statsHistogram[i] = total;
+            }
+
+            printf("server: %i players (%i queued), %i spectators, %i matches active (%i started, %i finished, %lli moved), %.0f actions/s, %lli dropped, %lli KB sent (%.2f KB/s per connection), "
+                   "worker frame p50 %.2fms p99 %.2fms max %.2fms, %lli over budget, queue depth max %i, %lli desyncs\n",
+                   connectionCount - (int)spectatorsWatching, lobby.queueCount, (int)spectatorsWatching, activeCount, (int)matchesStarted, (int)matchesFinished, (long long)matchesMoved,
+                   (actions - statsActions)/SERVER_STATS_TIME, (long long)actionsDropped, bytes/1024, connectionBytes/1024.0, GetTickPercentile(frames, frameCount, 50),
+                   GetTickPercentile(frames, frameCount, 99), workerFrameMax.exchange(0)/1000.0, (long long)tickOverruns, queueDepthWindowMax.exchange(0), (long long)lockstepDesyncs);
+            fflush(stdout);
+            statsActions = actions;
+            statsBytes = bytes;
+            statsTime += SERVER_STATS_TIME;
+        }
+    }
+
+    for (int i = 0; i < workerCount; ++i) workerThreads[i].join();
+    delete[] workerThreads;
+
+    // Workers are gone, every reference left is dropped here
+    for (int i = 0; i < SERVER_MAX_MATCHES; ++i)
+    {
+        if (matches[i].state != MATCH_ACTIVE) continue;
+
+        ServerEvent event = { };
+        while (PopServerEvent(&matches[i], &event))
+        {
+            if (event.type == SERVER_EVENT_JOIN) matches[i].players[event.player].connection = event.connection;
+            else if (event.type == SERVER_EVENT_SPECTATE) ReleaseConnection(event.connection);
+        }
+        for (int j = 0; j < matches[i].playerCount; ++j) if (matches[i].players[j].connection != NULL) ReleaseConnection(matches[i].players[j].connection);
+        for (int j = 0; j < matches[i].spectatorCount; ++j)
+        {
+            ReleaseSpectatorFrame(matches[i].spectators[j].frame);
+            ReleaseConnection(matches[i].spectators[j].connection);
+        }
+        ReleaseSpectatorFrame(matches[i].spectatorKeyframe);
+        ReleaseSpectatorFrame(matches[i].spectatorTail);
+        free(matches[i].spectators);
+        for (int j = 0; j < SERVER_MAX_PLAYERS; ++j)
+        {
+            free(matches[i].players[j].game);
+            free(matches[i].players[j].sync);
+            free(matches[i].players[j].wallSync);
+        }
+    }
+    for (int i = 0; i < connectionCount; ++i) ReleaseConnection(connections[i]);
+    for (int i = 0; i < leavingCount; ++i) ReleaseConnection(leaving[i]);
+    free(lobby.queue);
+    free(connections);
+    free(leaving);
+    free(entries);
+    free(statsHistogram);
+    delete[] matches;
+    matches = NULL;
+    delete[] serverWorkers;
+    serverWorkers = NULL;
+
+    CloseSocket(listener);
+    CloseNetwork();
+
+    printf("server: stopped, %i matches played, %lli actions applied\n", (int)matchesFinished, (long long)actionsApplied);
+    return 0;
+}
+
+void StopMatchServer(void)
+{
+    serverRunning = false;
+}
+
+bool IsMatchServerRunning(void)
+{
+    return serverRunning;
+}
+
+ServerLoadStats GetServerLoadStats(void)
+{
+    std::lock_guard<std::mutex> lock(loadBaselineMutex);
+    const ServerLoadBaseline *base = &loadBaseline;
+
+    long long frames[SERVER_TICK_BUCKETS];
+    long long frameCount = 0;
+    for (int i = 0; i < SERVER_TICK_BUCKETS; ++i)
+    {
+        frames[i] = tickHistogram[i].load(std::memory_order_relaxed) - base->tickHistogram[i];
+        frameCount += frames[i];
+    }
+
+    ServerLoadStats stats = { 0 };
+    stats.seconds = GetSeconds() - base->time;
+    stats.ticks = tickCount - base->ticks;
+    stats.tickP50 = GetTickPercentile(frames, frameCount, 50);
+    stats.tickP90 = GetTickPercentile(frames, frameCount, 90);
+    stats.tickP99 = GetTickPercentile(frames, frameCount, 99);
+    stats.tickMax = tickMax/1000.0f;
+    stats.queueDepthMax = queueDepthMax;
+    long long samples = queueDepthSamples - base->queueDepthSamples;
+    stats.queueDepthMean = (samples > 0)? (float)(queueDepthSum - base->queueDepthSum)/samples : 0.0f;
+    stats.playersJoined = playersJoined - base->playersJoined;
+    stats.actionsReceived = actionsReceived - base->actionsReceived;
+    stats.actionsDropped = actionsDropped - base->actionsDropped;
+    stats.actionsApplied = actionsApplied - base->actionsApplied;
+    stats.bytesSent = bytesSent - base->bytesSent;
+    stats.tickOverruns = tickOverruns - base->tickOverruns;
+    stats.matchCostMax = matchCostMax/1000.0f;
+    stats.matchesMoved = matchesMoved - base->matchesMoved;
+    long long waits = queueWaitSamples - base->queueWaitSamples;
+    stats.queueWaitMean = (waits > 0)? (queueWaitSum - base->queueWaitSum)/1000.0f/waits : 0.0f;
+
+    return stats;
+}
+
+void ResetServerLoadStats(void)
+{
+    std::lock_guard<std::mutex> lock(loadBaselineMutex);
+    ServerLoadBaseline *base = &loadBaseline;
+
+    base->time = GetSeconds();
+    for (int i = 0; i < SERVER_TICK_BUCKETS; ++i) base->tickHistogram[i] = tickHistogram[i].load(std::memory_order_relaxed);
+    base->ticks = tickCount;
+    base->queueDepthSum = queueDepthSum;
+    base->queueDepthSamples = queueDepthSamples;
+    base->playersJoined = playersJoined;
+    base->actionsReceived = actionsReceived;
+    base->actionsDropped = actionsDropped;
+    base->actionsApplied = actionsApplied;
+    base->bytesSent = bytesSent;
+    base->tickOverruns = tickOverruns;
+    base->matchesMoved = matchesMoved;
+    base->queueWaitSum = queueWaitSum;
+    base->queueWaitSamples = queueWaitSamples;
+    tickMax = 0;
+    matchCostMax = 0;
+    queueDepthMax = 0;
+}
@@ -0,0 +1,141 @@
+/**********************************************************************************************
+*
+*   Minesweeper Clone - Match Server
+*
+*   Headless authoritative server for the multiplayer mode: hosts many concurrent matches of
+*   up to SERVER_MAX_PLAYERS players, one board per player, all boards on the server.
+*
+*   The network thread accepts players, puts them in matches and turns received messages into
+*   events pushed on the match lock-free inbound queue. A fixed pool of workers updates the
+*   matches SERVER_FRAME_RATE times per second: drain the queue, apply actions through the
+*   game core, send results and board deltas (see board_sync.h). A match belongs to one worker
+*   at a time, its boards never leave that thread.
+*
+*   Joining players wait in a queue, batched by the board they asked for and their rating:
+*   a match starts as soon as enough of them are within SERVER_RATING_SPREAD of each other,
+*   the spread allowed grows the longer the first of them waits, and a player waiting
+*   SERVER_MATCH_FILL_TIME starts with the closest ones there are.
+*
+*   Every match update is timed, a smoothed cost per match (flood fills, chords, encoding)
+*   adds up to the load of its worker. A new match goes to the least loaded worker; a worker
+*   over its tick budget, or far above the least loaded one, hands it the match that evens
+*   them out best (one every SERVER_REBALANCE_TIME). Frames over the budget are counted.
+*
+*   Boards are never sent whole: players get the settings and seed of their board and generate
+*   it themselves, the server checks every action on its own copy. In a race every player of
+*   a match gets the same seed and the board opens on the same tile (see OpenGame()), both
+*   sides start syncing from it: whatever the board size, joining costs the same few bytes.
+*
+*   Every player also sees the boards of its opponents: SERVER_WALL_TIME apart, the changes
+*   of every board are encoded once per match into a shared buffer, then copied to each
+*   player output (its own board left out). A player too slow to take them gets a keyframe
+*   of each opponent board once it has room again.
+*
+*   Spectators (MSG_SPECTATE) watch every board of a match. The same encoded changes, with
+*   the player statuses, are kept as an immutable frame shared by all spectators of the match:
+*   each one is sent straight from the frames, never copied nor encoded again. A keyframe of
+*   the whole match is made every SERVER_SPECTATOR_KEYFRAME_TIME, spectators joining late or
+*   falling behind start from the latest one.
+*
+*   A lockstep match sends no board at all: every SERVER_LOCKSTEP_STEP_TIME each player gets
+*   the inputs of that step (MSG_LOCKSTEP_STEP, sent even when empty), every client runs the
+*   boards of all players from their seeds and those inputs, so what a player receives does not
+*   grow with what happens on the boards. The server applies the same inputs and keeps the state
+*   hash of the last steps, a client reporting a different one is told it desynced.
+*
+*   With garbage on, every SERVER_GARBAGE_TILES safe tiles a player reveals add a hidden row
+*   of mines below the board of the next opponent still playing (mines injected in its hidden
+*   tiles once the board is maxBoardHeight tall). Only the new rows are sent, every copy of the
+*   board grows the same way (see MSG_GARBAGE, InsertGameRows()).
+*
+*   Copyright (c) 2024 (DoughnutDude)
+*
+**********************************************************************************************/
+
+#ifndef GAME_SERVER_H
+#define GAME_SERVER_H
+
+#include "game_core.h"
+#include "net_protocol.h"   // Required for: MatchMode
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define SERVER_DEFAULT_PORT         7777
+#define SERVER_MAX_MATCHES          512
+#define SERVER_MAX_PLAYERS          99      // Players per match, one board each
+#define SERVER_FRAME_RATE           60      // Match updates per second on every worker
+#define SERVER_MATCH_FILL_TIME      3.0     // Seconds a queued player waits before its match starts with fewer players
+#define SERVER_RATING_SPREAD        100     // Rating difference allowed in a match right away
+#define SERVER_RATING_SPREAD_GROWTH 100     // More of it per second the first player of a batch waited
+#define SERVER_MATCH_LINGER_TIME    5.0     // Seconds a finished match waits for its players to disconnect
+#define SERVER_EVENT_QUEUE_SIZE     1024    // Inbound events per match (power of 2), actions past it are dropped
+#define SERVER_OUTPUT_SIZE          16384   // Unsent bytes per player before it is disconnected
+#define SERVER_DELTA_OUTPUT_SIZE    2048    // Unsent bytes board deltas stop at, they wait for the next frame instead
+#define SERVER_WALL_OUTPUT_SIZE     12288   // Unsent bytes opponent deltas stop at, missed ones are sent as keyframes later
+#define SERVER_WALL_BUFFER_SIZE     8192    // Opponent deltas encoded per match and update, the rest waits for the next one
+#define SERVER_WALL_TIME            0.1     // Seconds between two opponent board updates
+#define SERVER_KEYFRAME_TIME        10.0    // Seconds between two board keyframes sent to a player
+#define SERVER_SYNC_REQUEST_TIME    0.5     // Seconds at least between two board keyframes a player asks for
+#define SERVER_MAX_SPECTATORS       1024    // Spectators per match, more are turned away
+#define SERVER_SPECTATOR_KEYFRAME_TIME  5.0 // Seconds between two spectator keyframes, where spectators start
+#define SERVER_SPECTATOR_KEYFRAME_SIZE  65536   // First guess of a spectator keyframe size, grown as needed
+#define SERVER_SPECTATOR_MAX_LAG    100     // Frames a spectator falls behind before it starts again from the latest keyframe
+#define SERVER_SPECTATOR_MESSAGE_SIZE   1024    // Statuses and match end waiting for the next spectator frame
+#define SERVER_LOCKSTEP_STEP_TIME   (NET_LOCKSTEP_STEP_TICKS*SIM_TICK_TIME)    // Seconds between two lockstep steps
+#define SERVER_LOCKSTEP_HASH_HISTORY    64  // Steps a client state hash can come late and still be checked
+#define SERVER_GARBAGE_TILES        30      // Safe tiles a player reveals to send a garbage row
+#define SERVER_STATS_TIME           5.0     // Seconds between statistics lines
+#define SERVER_TICK_BUCKETS         1000    // Worker frame time histogram buckets, the last one takes every longer frame
+#define SERVER_TICK_BUCKET_TIME     0.05    // Milliseconds per bucket
+#define SERVER_DEFAULT_TICK_BUDGET  8.0f    // Milliseconds, half a frame at SERVER_FRAME_RATE
+#define SERVER_REBALANCE_TIME       0.5     // Seconds between two matches a worker hands over
+#define SERVER_REBALANCE_GAP        4       // Workers further apart than budget/gap even out, even under budget
+#define SERVER_COST_SMOOTHING       0.05f   // Weight of the latest update in the cost of a match
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct ServerSettings {
+    int port;
+    int workerCount;        // 0 = one per hardware thread
+    int playersPerMatch;    // Match starts once full, or with fewer once a player waited SERVER_MATCH_FILL_TIME
+    GameSettings board;     // Board of players asking for none, seeds are picked per match and player
+    MatchMode mode;         // MATCH_MODE_RACE: one seed per match, boards are generated once and copied
+                            // MATCH_MODE_LOCKSTEP: clients get inputs instead of board deltas
+    bool garbage;           // Players send garbage rows to their opponents, not in races
+    float tickBudget;       // Milliseconds a worker frame should take, matches move off a worker over it
+} ServerSettings;
+
+// Measured since the server started or the last ResetServerLoadStats()
+typedef struct ServerLoadStats {
+    double seconds;
+    long long ticks;            // Worker frames, every match of the worker updated once
+    float tickP50;              // Worker frame time percentiles, milliseconds (histogram bucket upper bound)
+    float tickP90;
+    float tickP99;
+    float tickMax;
+    int queueDepthMax;          // Events waiting in a match queue when its update started
+    float queueDepthMean;
+    long long playersJoined;
+    long long actionsReceived;
+    long long actionsDropped;   // Match queue full, never answered
+    long long actionsApplied;
+    long long bytesSent;
+    long long tickOverruns;     // Worker frames over the tick budget
+    float matchCostMax;         // Longest update of a single match, milliseconds
+    long long matchesMoved;     // Handed to another worker
+    float queueWaitMean;        // Seconds from joining to the match start
+} ServerLoadStats;
+
+//----------------------------------------------------------------------------------
+// Match Server Functions Declaration
+//----------------------------------------------------------------------------------
+ServerSettings GetDefaultServerSettings(void);
+int RunMatchServer(ServerSettings settings);    // Serve until interrupted (Ctrl+C), returns the process exit code
+void StopMatchServer(void);                     // Any thread, RunMatchServer() returns once its threads are done
+bool IsMatchServerRunning(void);                // Listening and updating matches
+ServerLoadStats GetServerLoadStats(void);       // Any thread
+void ResetServerLoadStats(void);
+
+#endif // GAME_SERVER_H
@@ -0,0 +1,356 @@
+/**********************************************************************************************
+*
+*   Minesweeper Clone - Simulation Thread
+*
+*   Game core on its own thread, lock-free command ring in, snapshot triple buffer out.
+*
+*   Copyright (c) 2024 (DoughnutDude)
+*
+**********************************************************************************************/
+
+#include "raylib.h"         // Required for: GetTime()
+#include "game_sim.h"
+#include "replay.h"
+#include "logger.h"
+
+#include <stddef.h>         // Required for: offsetof()
+#include <string.h>         // Required for: memcpy()
+#include <time.h>           // Required for: time(), localtime(), strftime()
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+#define internal static
+#define global_var static
+
+#define SNAPSHOT_INDEX_MASK     3
+#define SNAPSHOT_NEW            4       // Middle snapshot flag, published and not picked up yet
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum SimCommandType {
+    SIM_COMMAND_ACTION = 0,
+    SIM_COMMAND_START,
+    SIM_COMMAND_STOP,
+} SimCommandType;
+
+typedef struct SimCommand {
+    SimCommandType type;
+    GameAction action;          // SIM_COMMAND_ACTION
+    GameSettings settings;      // SIM_COMMAND_START
+    int boardId;                // SIM_COMMAND_START
+    double startTime;           // SIM_COMMAND_START
+} SimCommand;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+// Command ring, written by the main thread, read by the simulation
+global_var SimCommand commands[SIM_COMMAND_QUEUE_SIZE];
+global_var std::atomic<unsigned int> commandHead(0);
+global_var std::atomic<unsigned int> commandTail(0);
+
+// Snapshot triple buffer
+global_var GameSnapshot snapshots[3];
+global_var std::atomic<int> snapshotMiddle(2);
+global_var int snapshotBack = 1;            // Simulation only
+global_var int snapshotFront = 0;           // Main thread only
+
+// Simulation only
+global_var GameState game = { 0 };
+global_var GameActionQueue actionQueue = { 0 };
+global_var Replay replay = { 0 };
+global_var bool gameActive = false;
+global_var int boardId = 0;
+global_var bool replaySaved = false;
+global_var double gameStartTime = 0.0;
+global_var unsigned int boardVersion = 0;
+global_var int commandsProcessed = 0;
+global_var int actionsProcessed = 0;
+global_var int sfxTriggers[SFX_CATEGORY_COUNT] = { 0 };
+
+// Main thread only
+global_var int commandsSent = 0;
+global_var double mainStartTime = 0.0;      // Start time of the last board sent
+global_var int boardsSent = 0;
+
+global_var std::thread simWorker;
+global_var std::mutex wakeMutex;            // NOTE: Only used to sleep, no data is guarded by it
+global_var std::condition_variable wakeSignal;
+global_var std::atomic<bool> simRunning(false);
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions Definition
+//----------------------------------------------------------------------------------
+internal bool HasSimCommands(void)
+{
+    return (commandHead.load(std::memory_order_relaxed) != commandTail.load(std::memory_order_acquire));
+}
+
+internal bool PushSimCommand(const SimCommand *command)
+{
+    unsigned int tail = commandTail.load(std::memory_order_relaxed);
+    if (tail - commandHead.load(std::memory_order_acquire) >= SIM_COMMAND_QUEUE_SIZE) return false;
+
+    commands[tail & (SIM_COMMAND_QUEUE_SIZE - 1)] = *command;
+    commandTail.store(tail + 1, std::memory_order_release);
+    ++commandsSent;
+
+    // NOTE: Not locking wakeMutex, a wake-up lost to the race is caught up by the next timed wake-up
+    wakeSignal.notify_one();
+    return true;
+}
+
+// Save the replay of the finished game next to screenshots, named after the current date and time
+internal void SaveSimulationReplay(void)
+{
+    EndReplay(&replay, &game);
+
+    char fileName[64] = { 0 };
+    time_t now = time(NULL);
+    strftime(fileName, sizeof(fileName), "replay_%Y%m%d_%H%M%S" REPLAY_FILE_EXTENSION, localtime(&now));
+
+    if (SaveReplay(&replay, fileName)) LOG_MESSAGE(LOG_LEVEL_INFO, LOG_CATEGORY_REPLAY, "[%s] Replay saved (%i actions)", fileName, replay.count);
+    else LOG_MESSAGE(LOG_LEVEL_WARNING, LOG_CATEGORY_REPLAY, "[%s] Failed to save replay", fileName);
+}
+
+// Apply due actions
+// NOTE: Only accepted actions are recorded, a replay never contains an input the board refused
+internal void ApplySimulationActions(void)
+{
+    GameAction action = { 0 };
+    while ((actionQueue.count > 0) && (actionQueue.actions[actionQueue.head].tick <= game.tick))
+    {
+        PopGameAction(&actionQueue, &action);
+        int previousHP = game.hp;
+        if (ApplyGameAction(&game, action))
+        {
+            RecordReplayAction(&replay, action);
+            ++boardVersion;
+
+            if (game.hp < previousHP) ++sfxTriggers[SFX_MINE];
+            else if (action.type == ACTION_REVEAL) ++sfxTriggers[SFX_REVEAL];
+            else if (action.type == ACTION_CHORD) ++sfxTriggers[SFX_CHORD];
+            else if (action.type == ACTION_FLAG) ++sfxTriggers[SFX_FLAG];
+        }
+        ++actionsProcessed;
+    }
+
+    if (gameActive && IsGameOver(&game) && !replaySaved)
+    {
+        SaveSimulationReplay();
+        replaySaved = true;
+    }
+}
+
+internal void ProcessSimCommands(void)
+{
+    unsigned int head = commandHead.load(std::memory_order_relaxed);
+    while (head != commandTail.load(std::memory_order_acquire))
+    {
+        SimCommand command = commands[head & (SIM_COMMAND_QUEUE_SIZE - 1)];
+        commandHead.store(++head, std::memory_order_release);
+
+        switch (command.type)
+        {
+            case SIM_COMMAND_ACTION:
+            {
+                // Stamped on a tick already simulated (late frame): applied on the current one, as recorded
+                if (command.action.tick < game.tick) command.action.tick = game.tick;
+                if (!gameActive || !PushGameAction(&actionQueue, command.action)) ++actionsProcessed;
+            } break;
+            case SIM_COMMAND_START:
+            {
+                InitGame(&game, command.settings);
+                BeginReplay(&replay, command.settings);
+                ClearGameActions(&actionQueue);
+                gameStartTime = command.startTime;
+                boardId = command.boardId;
+                gameActive = true;
+                replaySaved = false;
+                ++boardVersion;
+            } break;
+            case SIM_COMMAND_STOP:
+            {
+                actionsProcessed += actionQueue.count;
+                ClearGameActions(&actionQueue);
+                UnloadReplay(&replay);
+                gameActive = false;
+            } break;
+            default: break;
+        }
+        ++commandsProcessed;
+    }
+}
+
+// Copy the game into the back snapshot and swap it with the middle one
+internal void PublishGameSnapshot(void)
+{
+    GameSnapshot *snapshot = &snapshots[snapshotBack];
+
+    memcpy(&snapshot->state, &game, offsetof(GameState, board));
+    snapshot->boardId = boardId;
+    if (snapshot->boardVersion != boardVersion)
+    {
+        // NOTE: Boards are copied row by row up to their size, an unchanged board is not copied again
+        for (int y = 0; y < game.height; ++y)
+        {
+            memcpy(snapshot->state.board[y], game.board[y], game.width*sizeof(game.board[0][0]));
+            memcpy(snapshot->state.boardMask[y], game.boardMask[y], game.width*sizeof(game.board[0][0]));
+        }
+        snapshot->boardVersion = boardVersion;
+    }
+    snapshot->commandsProcessed = commandsProcessed;
+    snapshot->actionsProcessed = actionsProcessed;
+    memcpy(snapshot->sfxTriggers, sfxTriggers, sizeof(sfxTriggers));
+
+    snapshotBack = snapshotMiddle.exchange(snapshotBack | SNAPSHOT_NEW, std::memory_order_acq_rel) & SNAPSHOT_INDEX_MASK;
+}
+
+// Ticks only change the board while its timer runs, before the first reveal and after the end only actions do
+internal bool IsSimulationTicking(void)
+{
+    return gameActive && (game.startTick >= 0) && !IsGameOver(&game);
+}
+
+// Handle commands and run the ticks due, publish if anything changed
+internal void StepSimulation(void)
+{
+    int previousCommands = commandsProcessed;
+    int previousActions = actionsProcessed;
+    int previousTick = game.tick;
+    bool wasTicking = IsSimulationTicking();
+    ProcessSimCommands();
+
+    if (gameActive)
+    {
+        // Actions of the current tick are applied right away, the rest as their ticks run
+        ApplySimulationActions();
+
+        int dueTick = (int)((GetTime() - gameStartTime)/SIM_TICK_TIME);
+        while (game.tick < dueTick)
+        {
+            if (IsSimulationTicking()) ++game.tick;
+            else
+            {
+                // NOTE: Nothing happens on idle ticks, skip straight to the next queued action
+                int nextTick = (actionQueue.count > 0)? actionQueue.actions[actionQueue.head].tick : dueTick;
+                game.tick = (nextTick < dueTick)? nextTick : dueTick;
+            }
+            ApplySimulationActions();
+        }
+    }
+
+    bool ticked = (game.tick != previousTick) && (wasTicking || IsSimulationTicking());
+    if ((commandsProcessed != previousCommands) || (actionsProcessed != previousActions) || ticked) PublishGameSnapshot();
+}
+
+// Seconds until the simulation has something to do, unless a command comes first
+internal double GetSimulationWaitTime(void)
+{
+    if (IsSimulationTicking()) return gameStartTime + (game.tick + 1)*SIM_TICK_TIME - GetTime();
+    if (gameActive && (actionQueue.count > 0)) return gameStartTime + actionQueue.actions[actionQueue.head].tick*SIM_TICK_TIME - GetTime();
+
+    return SIM_IDLE_WAIT_TIME;
+}
+
+internal void SimulationThread(void)
+{
+    while (simRunning)
+    {
+        StepSimulation();
+
+        double waitTime = GetSimulationWaitTime();
+        if (waitTime > 0.0)
+        {
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wakeSignal.wait_for(lock, std::chrono::duration<double>(waitTime), []{ return !simRunning || HasSimCommands(); });
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------
+// Simulation Functions Definition
+//----------------------------------------------------------------------------------
+void InitSimulation(void)
+{
+#if !defined(PLATFORM_WEB)
+    simRunning = true;
+    simWorker = std::thread(SimulationThread);
+#endif
+}
+
+void CloseSimulation(void)
+{
+    if (simRunning)
+    {
+        simRunning = false;
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+        }
+        wakeSignal.notify_one();
+        simWorker.join();
+    }
+
+    UnloadReplay(&replay);
+    ClearGameActions(&actionQueue);
+    gameActive = false;
+}
+
+int StartSimulationGame(GameSettings settings, double startTime)
+{
+    SimCommand command = { };
+    command.type = SIM_COMMAND_START;
+    command.settings = settings;
+    command.startTime = startTime;
+    command.boardId = ++boardsSent;
+    if (!PushSimCommand(&command)) LOG_MESSAGE(LOG_LEVEL_WARNING, LOG_CATEGORY_GAME, "Simulation command queue full, new board dropped");
+
+    mainStartTime = startTime;
+    return command.boardId;
+}
+
+void StopSimulationGame(void)
+{
+    SimCommand command = { };
+    command.type = SIM_COMMAND_STOP;
+    if (!PushSimCommand(&command)) LOG_MESSAGE(LOG_LEVEL_WARNING, LOG_CATEGORY_GAME, "Simulation command queue full, board not stopped");
+}
+
+bool PushSimulationAction(GameAction action)
+{
+    SimCommand command = { };
+    command.type = SIM_COMMAND_ACTION;
+    command.action = action;
+    return PushSimCommand(&command);
+}
+
+int GetSimulationTick(double time)
+{
+    int tick = (int)((time - mainStartTime)/SIM_TICK_TIME);
+    return (tick > 0)? tick : 0;
+}
+
+const GameSnapshot *GetGameSnapshot(void)
+{
+#if defined(PLATFORM_WEB)
+    // No thread, the simulation catches up here once per call
+    StepSimulation();
+#endif
+
+    if (snapshotMiddle.load(std::memory_order_relaxed) & SNAPSHOT_NEW)
+    {
+        snapshotFront = snapshotMiddle.exchange(snapshotFront, std::memory_order_acq_rel) & SNAPSHOT_INDEX_MASK;
+    }
+
+    return &snapshots[snapshotFront];
+}
+
+bool IsSimulationPending(void)
+{
+    return (snapshots[snapshotFront].commandsProcessed != commandsSent);
+}
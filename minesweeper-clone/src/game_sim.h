@@ -0,0 +1,61 @@
+/**********************************************************************************************
+*
+*   Minesweeper Clone - Simulation Thread
+*
+*   The game core runs on its own thread at SIM_TICK_RATE: board generation, flood fills,
+*   win checks and replay saving never hold up a frame. The main thread only sends commands
+*   (tick-stamped actions, new board) and renders the latest published snapshot.
+*   Before the first reveal and once the game is over it only wakes up for commands.
+*
+*   Both directions are lock-free, single producer/single consumer:
+*       main -> simulation  command ring
+*       simulation -> main  snapshot triple buffer, the simulation publishes into its back
+*                           snapshot and swaps it with the middle one, the main thread picks
+*                           the middle one up when it is newer than its front one
+*   Neither side ever waits for the other, the main thread may skip snapshots.
+*
+*   Copyright (c) 2024 (DoughnutDude)
+*
+**********************************************************************************************/
+
+#ifndef GAME_SIM_H
+#define GAME_SIM_H
+
+#include "game_core.h"
+#include "sfx.h"
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define SIM_COMMAND_QUEUE_SIZE  256     // Commands waiting for the simulation, power of two
+#define SIM_IDLE_WAIT_TIME      0.1     // Seconds the simulation sleeps between command checks while no timer runs
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+// Game state as of a simulation tick, read-only for the main thread
+// NOTE: Only board rows [0, state.height) are copied, rows past it are stale
+typedef struct GameSnapshot {
+    GameState state;
+    int boardId;                            // StartSimulationGame() that generated the board, 0 before the first
+    unsigned int boardVersion;              // Changes every time the board or its mask change
+    int commandsProcessed;                  // Commands handled since InitSimulation()
+    int actionsProcessed;                   // Actions applied or refused since InitSimulation()
+    int sfxTriggers[SFX_CATEGORY_COUNT];    // Sounds triggered by accepted actions since InitSimulation()
+} GameSnapshot;
+
+//----------------------------------------------------------------------------------
+// Simulation Functions Declaration
+//----------------------------------------------------------------------------------
+void InitSimulation(void);                      // Start the simulation thread (none on web, it steps in GetGameSnapshot())
+void CloseSimulation(void);
+
+// Main thread only
+int StartSimulationGame(GameSettings settings, double startTime);   // New board, its tick 0 starts at startTime (GetTime() clock), returns its id
+void StopSimulationGame(void);                  // Discard the board, its queued actions and its replay
+bool PushSimulationAction(GameAction action);   // Queue an action, applied once the simulation reaches its tick
+int GetSimulationTick(double time);             // Tick of the current board a GetTime() time falls in
+const GameSnapshot *GetGameSnapshot(void);      // Latest snapshot, valid until the next call
+bool IsSimulationPending(void);                 // Commands sent are not all reflected by the latest snapshot yet
+
+#endif // GAME_SIM_H
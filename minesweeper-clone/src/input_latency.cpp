@@ -0,0 +1,218 @@
+/**********************************************************************************************
+*
+*   Minesweeper Clone - Input Latency Tracking
+*
+*   Follows every board input from the raylib event to the buffer swap of the frame that
+*   shows its result: event -> game core apply -> draw submit -> swap.
+*   Completed samples feed a percentile overlay (p50/p95/p99) and can be exported as CSV.
+*
+*   Copyright (c) 2024 (DoughnutDude)
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "input_latency.h"
+
+#include <stdio.h>          // Required for: FILE, fopen(), fprintf(), fclose()
+#include <stdlib.h>         // Required for: qsort()
+
+#define internal static
+#define global_var static
+
+#define LATENCY_STAGES 4
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+global_var InputLatencySample pending[MAX_LATENCY_PENDING] = { 0 };
+global_var int pendingCount = 0;
+
+// NOTE: Inputs not tracked while pending is full are still applied in order, they are counted in place
+// so applied counts keep lining up with the tracked ones: before each pending sample, then after the last
+global_var int pendingUntracked[MAX_LATENCY_PENDING] = { 0 };
+global_var int untrackedCount = 0;
+
+global_var InputLatencySample samples[MAX_LATENCY_SAMPLES] = { 0 };
+global_var int samplesHead = 0;         // Next sample slot to write
+global_var int samplesCount = 0;
+global_var int samplesTotal = 0;        // Samples completed since startup
+
+// Percentiles cache, only recomputed when new samples complete
+global_var int percentilesTotal = -1;
+global_var float percentiles[LATENCY_STAGES][3] = { 0 };   // [stage][p50, p95, p99] in milliseconds
+
+global_var const char *stageNames[LATENCY_STAGES] = { "input->apply", "apply->submit", "submit->swap", "input->swap" };
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions Definition
+//----------------------------------------------------------------------------------
+internal float GetStageMilliseconds(const InputLatencySample *sample, int stage)
+{
+    double result = 0.0;
+    switch (stage)
+    {
+        case 0: result = sample->applyTime - sample->eventTime; break;
+        case 1: result = sample->submitTime - sample->applyTime; break;
+        case 2: result = sample->swapTime - sample->submitTime; break;
+        case 3: result = sample->swapTime - sample->eventTime; break;
+        default: break;
+    }
+    return (float)(result*1000.0);
+}
+
+internal int CompareFloats(const void *a, const void *b)
+{
+    float valueA = *(const float *)a;
+    float valueB = *(const float *)b;
+    return (valueA > valueB) - (valueA < valueB);
+}
+
+internal void UpdatePercentiles(void)
+{
+    static float values[MAX_LATENCY_SAMPLES];
+
+    for (int stage = 0; stage < LATENCY_STAGES; ++stage)
+    {
+        for (int i = 0; i < samplesCount; ++i) values[i] = GetStageMilliseconds(&samples[i], stage);
+        qsort(values, samplesCount, sizeof(float), CompareFloats);
+
+        percentiles[stage][0] = values[(samplesCount - 1)*50/100];
+        percentiles[stage][1] = values[(samplesCount - 1)*95/100];
+        percentiles[stage][2] = values[(samplesCount - 1)*99/100];
+    }
+
+    percentilesTotal = samplesTotal;
+}
+
+// Move the oldest pending samples that reached the screen into the completed samples ring
+internal void RetireSwappedSamples(void)
+{
+    int retired = 0;
+    while ((retired < pendingCount) && (pending[retired].swapTime > 0.0))
+    {
+        samples[samplesHead] = pending[retired];
+        samplesHead = (samplesHead + 1)%MAX_LATENCY_SAMPLES;
+        if (samplesCount < MAX_LATENCY_SAMPLES) ++samplesCount;
+        ++samplesTotal;
+        ++retired;
+    }
+
+    for (int i = retired; i < pendingCount; ++i)
+    {
+        pending[i - retired] = pending[i];
+        pendingUntracked[i - retired] = pendingUntracked[i];
+    }
+    pendingCount -= retired;
+}
+
+//----------------------------------------------------------------------------------
+// Input Latency Functions Definition
+//----------------------------------------------------------------------------------
+void BeginInputLatency(double eventTime)
+{
+    if (pendingCount >= MAX_LATENCY_PENDING)
+    {
+        ++untrackedCount;
+        return;
+    }
+
+    InputLatencySample sample = { 0 };
+    sample.eventTime = eventTime;
+    pending[pendingCount] = sample;
+    pendingUntracked[pendingCount] = untrackedCount;
+    untrackedCount = 0;
+    ++pendingCount;
+}
+
+void MarkInputLatencyApplied(int count)
+{
+    if (count <= 0) return;
+
+    double now = GetTime();
+    for (int i = 0; (i < pendingCount) && (count > 0); ++i)
+    {
+        if (pending[i].applyTime == 0.0)
+        {
+            int skipped = (pendingUntracked[i] < count)? pendingUntracked[i] : count;
+            pendingUntracked[i] -= skipped;
+            count -= skipped;
+            if (count == 0) break;
+
+            pending[i].applyTime = now;
+            --count;
+        }
+    }
+    untrackedCount -= (count < untrackedCount)? count : untrackedCount;
+}
+
+void MarkInputLatencySubmitted(void)
+{
+    double now = GetTime();
+    for (int i = 0; i < pendingCount; ++i)
+    {
+        if ((pending[i].applyTime > 0.0) && (pending[i].submitTime == 0.0)) pending[i].submitTime = now;
+    }
+}
+
+void MarkInputLatencySwapped(double swapTime)
+{
+    for (int i = 0; i < pendingCount; ++i)
+    {
+        if ((pending[i].submitTime > 0.0) && (pending[i].swapTime == 0.0)) pending[i].swapTime = swapTime;
+    }
+    RetireSwappedSamples();
+}
+
+void CancelPendingInputLatency(void)
+{
+    int kept = 0;
+    for (int i = 0; i < pendingCount; ++i)
+    {
+        if (pending[i].applyTime > 0.0)
+        {
+            pending[kept] = pending[i];
+            pendingUntracked[kept] = 0;     // Applied, so were the untracked inputs before it
+            ++kept;
+        }
+    }
+    pendingCount = kept;
+    untrackedCount = 0;
+}
+
+void DrawInputLatencyOverlay(int posX, int posY)
+{
+    if ((samplesCount > 0) && (percentilesTotal != samplesTotal)) UpdatePercentiles();
+
+    DrawRectangle(posX, posY, 300, 20 + LATENCY_STAGES*16 + 6, Fade(BLACK, 0.7f));
+    DrawText(TextFormat("latency ms (%i inputs)", samplesCount), posX + 6, posY + 4, 10, RAYWHITE);
+    DrawText("p50", posX + 140, posY + 4, 10, RAYWHITE);
+    DrawText("p95", posX + 190, posY + 4, 10, RAYWHITE);
+    DrawText("p99", posX + 240, posY + 4, 10, RAYWHITE);
+    for (int stage = 0; stage < LATENCY_STAGES; ++stage)
+    {
+        int rowY = posY + 20 + stage*16;
+        Color rowColor = (stage == LATENCY_STAGES - 1)? YELLOW : RAYWHITE;
+        DrawText(stageNames[stage], posX + 6, rowY, 10, rowColor);
+        for (int i = 0; i < 3; ++i) DrawText(TextFormat("%.2f", percentiles[stage][i]), posX + 140 + i*50, rowY, 10, rowColor);
+    }
+}
+
+bool ExportInputLatencyCSV(const char *fileName)
+{
+    FILE *file = fopen(fileName, "wt");
+    if (file == NULL) return false;
+
+    fprintf(file, "event_time,apply_time,submit_time,swap_time,input_to_apply_ms,apply_to_submit_ms,submit_to_swap_ms,input_to_swap_ms\n");
+
+    // Oldest sample first
+    int first = (samplesHead - samplesCount + MAX_LATENCY_SAMPLES)%MAX_LATENCY_SAMPLES;
+    for (int i = 0; i < samplesCount; ++i)
+    {
+        const InputLatencySample *sample = &samples[(first + i)%MAX_LATENCY_SAMPLES];
+        fprintf(file, "%.6f,%.6f,%.6f,%.6f,%.3f,%.3f,%.3f,%.3f\n", sample->eventTime, sample->applyTime, sample->submitTime, sample->swapTime,
+                GetStageMilliseconds(sample, 0), GetStageMilliseconds(sample, 1), GetStageMilliseconds(sample, 2), GetStageMilliseconds(sample, 3));
+    }
+
+    fclose(file);
+    return true;
+}
@@ -0,0 +1,45 @@
+/**********************************************************************************************
+*
+*   Minesweeper Clone - Input Latency Tracking
+*
+*   Follows every board input from the raylib event to the buffer swap of the frame that
+*   shows its result: event -> game core apply -> draw submit -> swap.
+*   Completed samples feed a percentile overlay (p50/p95/p99) and can be exported as CSV.
+*
+*   Copyright (c) 2024 (DoughnutDude)
+*
+**********************************************************************************************/
+
+#ifndef INPUT_LATENCY_H
+#define INPUT_LATENCY_H
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define MAX_LATENCY_PENDING     64      // Inputs still on their way to the screen
+#define MAX_LATENCY_SAMPLES     1024    // Completed samples kept for percentiles and export
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+// All times use the GetTime() clock
+typedef struct InputLatencySample {
+    double eventTime;       // Input event received by raylib
+    double applyTime;       // Game core applied the resulting action
+    double submitTime;      // Frame showing the result submitted for drawing
+    double swapTime;        // Frame buffers swapped
+} InputLatencySample;
+
+//----------------------------------------------------------------------------------
+// Input Latency Functions Declaration
+//----------------------------------------------------------------------------------
+void BeginInputLatency(double eventTime);           // An input was queued as a game action (untracked but counted when too many are pending)
+void MarkInputLatencyApplied(int count);            // The oldest queued inputs were applied by the game core
+void MarkInputLatencySubmitted(void);               // The current frame is about to be submitted
+void MarkInputLatencySwapped(double swapTime);      // The current frame buffers were swapped
+void CancelPendingInputLatency(void);               // Forget inputs whose actions were discarded before applying
+
+void DrawInputLatencyOverlay(int posX, int posY);   // Draw p50/p95/p99 of every stage
+bool ExportInputLatencyCSV(const char *fileName);   // Export completed samples, one row per input
+
+#endif // INPUT_LATENCY_H
@@ -0,0 +1,178 @@
+/**********************************************************************************************
+*
+*   Minesweeper Clone - Logger
+*
+*   Asynchronous logger: any thread pushes messages into a lock-free ring buffer, a background
+*   thread adds timestamp, level and category and does the output.
+*
+*   Copyright (c) 2024 (DoughnutDude)
+*
+**********************************************************************************************/
+
+#include "logger.h"
+
+#include <stdio.h>          // Required for: vsnprintf(), snprintf(), fprintf(), fflush()
+#include <stdlib.h>         // Required for: atexit()
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#define internal static
+#define global_var static
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+// Slot i is used by message positions i, i + LOG_QUEUE_SIZE, ... (one lap each)
+// turn: 2*lap = free for the producer of that lap, 2*lap + 1 = written, ready for output
+typedef struct LogSlot {
+    std::atomic<unsigned long long> turn;
+    LogLevel level;
+    LogCategory category;
+    long long time;         // Nanoseconds since logger start
+    char text[LOG_MESSAGE_SIZE];
+} LogSlot;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+global_var LogSlot slots[LOG_QUEUE_SIZE];
+global_var std::atomic<unsigned long long> writePosition(0);
+global_var unsigned long long readPosition = 0;         // Output thread only
+global_var std::atomic<int> droppedCount(0);
+
+global_var std::thread outputThread;
+global_var std::atomic<bool> outputRunning(false);
+global_var std::atomic<bool> loggerClosed(false);
+
+global_var const std::chrono::steady_clock::time_point loggerStart = std::chrono::steady_clock::now();
+
+global_var const char *levelNames[] = { "DEBUG", "INFO", "WARN", "ERROR" };
+global_var const char *categoryNames[LOG_CATEGORY_COUNT] = { "RAYLIB", "GAME", "REPLAY", "CAPTURE", "LATENCY", "PROFILER" };
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions Definition
+//----------------------------------------------------------------------------------
+internal long long GetLogTime(void)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - loggerStart).count();
+}
+
+internal void WriteLogLine(long long time, LogLevel level, LogCategory category, const char *text)
+{
+    fprintf(stdout, "[%10.4f] %-5s %-8s: %s\n", time/1000000000.0, levelNames[level], categoryNames[category], text);
+}
+
+// Write every message ready in order, returns number of messages written
+internal int FlushLogQueue(void)
+{
+    int count = 0;
+
+    for (;;)
+    {
+        LogSlot *slot = &slots[readPosition%LOG_QUEUE_SIZE];
+        unsigned long long lap = readPosition/LOG_QUEUE_SIZE;
+        if (slot->turn.load(std::memory_order_acquire) != 2*lap + 1) break;
+
+        WriteLogLine(slot->time, slot->level, slot->category, slot->text);
+        slot->turn.store(2*(lap + 1), std::memory_order_release);
+        ++readPosition;
+        ++count;
+    }
+
+    int dropped = droppedCount.exchange(0);
+    if (dropped > 0)
+    {
+        char text[64];
+        snprintf(text, sizeof(text), "Log queue full, %i messages dropped", dropped);
+        WriteLogLine(GetLogTime(), LOG_LEVEL_WARNING, LOG_CATEGORY_GAME, text);
+    }
+    if ((count > 0) || (dropped > 0)) fflush(stdout);
+
+    return count;
+}
+
+internal void RunLogOutput(void)
+{
+    for (;;)
+    {
+        bool stopping = !outputRunning;     // NOTE: Read before flushing so messages pushed before the stop are written
+        if (FlushLogQueue() > 0) continue;
+        if (stopping) break;
+
+        std::this_thread::sleep_for(std::chrono::duration<double>(LOG_FLUSH_TIME));
+    }
+}
+
+//----------------------------------------------------------------------------------
+// Logger Functions Definition
+//----------------------------------------------------------------------------------
+void InitLogger(void)
+{
+    if (outputRunning || loggerClosed) return;
+
+    outputRunning = true;
+    outputThread = std::thread(RunLogOutput);
+    atexit(CloseLogger);    // Also flush on exit() from anywhere (i.e. raylib LOG_FATAL)
+}
+
+void CloseLogger(void)
+{
+    if (!outputRunning) return;
+
+    // NOTE: Close before stopping the thread, so new messages are written directly instead of queued with no reader,
+    // then drain what was queued meanwhile, waiting briefly for writers that claimed a slot but are still formatting
+    loggerClosed = true;
+    outputRunning = false;
+    outputThread.join();
+
+    long long deadline = GetLogTime() + (long long)(LOG_FLUSH_TIME*1000000000.0);
+    do FlushLogQueue();
+    while ((readPosition < writePosition.load()) && (GetLogTime() < deadline));
+}
+
+void LogMessage(LogLevel level, LogCategory category, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    LogMessageV(level, category, format, args);
+    va_end(args);
+}
+
+void LogMessageV(LogLevel level, LogCategory category, const char *format, va_list args)
+{
+    if (loggerClosed)
+    {
+        char text[LOG_MESSAGE_SIZE];
+        vsnprintf(text, sizeof(text), format, args);
+        WriteLogLine(GetLogTime(), level, category, text);
+        return;
+    }
+
+    // Claim the next position if its slot was already written out, never wait for the output thread
+    unsigned long long position = writePosition.load(std::memory_order_relaxed);
+    LogSlot *slot = NULL;
+    for (;;)
+    {
+        slot = &slots[position%LOG_QUEUE_SIZE];
+        long long diff = (long long)(slot->turn.load(std::memory_order_acquire) - 2*(position/LOG_QUEUE_SIZE));
+
+        if (diff == 0)
+        {
+            if (writePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+        }
+        else if (diff < 0)
+        {
+            ++droppedCount;     // Queue full
+            return;
+        }
+        else position = writePosition.load(std::memory_order_relaxed);
+    }
+
+    slot->level = level;
+    slot->category = category;
+    slot->time = GetLogTime();
+    vsnprintf(slot->text, LOG_MESSAGE_SIZE, format, args);
+    slot->turn.store(2*(position/LOG_QUEUE_SIZE) + 1, std::memory_order_release);
+}
@@ -0,0 +1,63 @@
+/**********************************************************************************************
+*
+*   Minesweeper Clone - Logger
+*
+*   Asynchronous logger: any thread pushes messages into a lock-free ring buffer, a background
+*   thread adds timestamp, level and category and does the output.
+*   Debug messages (LOG_DEBUG_MESSAGE) compile to nothing unless _DEBUG is defined.
+*
+*   Copyright (c) 2024 (DoughnutDude)
+*
+**********************************************************************************************/
+
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <stdarg.h>         // Required for: va_list
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define LOG_QUEUE_SIZE          1024    // Messages waiting for output, more are dropped (power of 2)
+#define LOG_MESSAGE_SIZE        256     // Longer messages are truncated
+#define LOG_FLUSH_TIME          0.01    // Seconds the output thread sleeps when the queue is empty
+
+#define LOG_MESSAGE(level, category, ...)   LogMessage(level, category, __VA_ARGS__)
+#if defined(_DEBUG)
+    #define LOG_DEBUG_MESSAGE(category, ...)    LogMessage(LOG_LEVEL_DEBUG, category, __VA_ARGS__)
+#else
+    #define LOG_DEBUG_MESSAGE(category, ...)
+#endif
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum LogLevel {
+    LOG_LEVEL_DEBUG = 0,
+    LOG_LEVEL_INFO,
+    LOG_LEVEL_WARNING,
+    LOG_LEVEL_ERROR,
+} LogLevel;
+
+typedef enum LogCategory {
+    LOG_CATEGORY_RAYLIB = 0,
+    LOG_CATEGORY_GAME,
+    LOG_CATEGORY_REPLAY,
+    LOG_CATEGORY_CAPTURE,
+    LOG_CATEGORY_LATENCY,
+    LOG_CATEGORY_PROFILER,
+    LOG_CATEGORY_COUNT
+} LogCategory;
+
+//----------------------------------------------------------------------------------
+// Logger Functions Declaration
+//----------------------------------------------------------------------------------
+void InitLogger(void);          // Start the output thread, messages logged before are kept in the queue
+void CloseLogger(void);         // Write every queued message and stop the output thread, later messages are written directly
+
+// NOTE: The message is formatted into the queue on the calling thread (arguments may not outlive the call),
+// everything else, including stdout, happens on the output thread
+void LogMessage(LogLevel level, LogCategory category, const char *format, ...);
+void LogMessageV(LogLevel level, LogCategory category, const char *format, va_list args);
+
+#endif // LOGGER_H
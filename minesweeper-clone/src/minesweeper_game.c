@@ -19,7 +19,20 @@
 **********************************************************************************************/
 
 #include "raylib.h"
+#include "rlgl.h"       // Required for: rlSetDrawRenderBatchCallback(), rlGetRenderStats()
 #include "screens.h"    // NOTE: Declares global (extern) variables and screens functions
+#include "input_latency.h"
+#include "perf_overlay.h"
+#include "screen_capture.h"
+#include "replay.h"
+#include "replay_verifier.h"
+#include "asset_pack.h"
+#include "font_atlas.h"
+#include "asset_stream.h"
+#include "game_sim.h"
+#include "game_server.h"
+#include "bot_client.h"
+#include <string.h>         // Required for: strcmp()
 
 #if defined(PLATFORM_WEB)
     #include <emscripten/emscripten.h>
@@ -31,8 +44,10 @@
 //----------------------------------------------------------------------------------
 GameScreen currentScreen = LOGO;
 Font font = { 0 };
+FontAtlasSet fontAtlases = { 0 };
 Music music = { 0 };
 Sound fxCoin = { 0 };
+float simAlpha = 0.0f;
 bool running;
 
 //----------------------------------------------------------------------------------
@@ -48,50 +63,153 @@ global_var bool transFadeOut = false;
 global_var int transFromScreen = -1;
 global_var GameScreen transToScreen = UNKNOWN;
 
+global_var bool showLatencyOverlay = false;
+global_var bool showPerfOverlay = false;
+
+global_var AssetPack assetPack = { 0 };     // NOTE: Mapped until exit, assets loaded from memory may keep pointing into it
+
+// Required variables to run the simulation at a fixed timestep
+global_var double simAccumulator = 0.0;
+global_var double simLastTime = 0.0;
+
 //----------------------------------------------------------------------------------
 // Local Functions Declaration
 //----------------------------------------------------------------------------------
 internal void ChangeToScreen(int screen);     // Change to screen, no transition effect
 
 internal void UpdateDrawFrame(void);          // Update and draw one frame
+internal double GetIdleWaitTime(void);        // Get how long the next frame may sleep waiting for input
+
+internal void CustomLog(int msgType, const char* text, va_list args);  // raylib trace log callback, forwards to the logger
+
+internal int RunReplayPlayer(const char *fileName, int repeat);   // Headless replay verification, no window
+internal int RunFontBaker(const char *ttfFileName, const char *fileName);  // Build step, bake font atlases for every text size
+internal int RunAssetPacker(const char *fileName, const char **inputs, int inputCount);     // Build step, pack resources into one file
+internal bool IsNumberArgument(const char *text);  // Check a command line argument is a number, not a keyword
 
-internal void CustomLog(int msgType, const char* text, va_list args);
 
 //----------------------------------------------------------------------------------
 // Main entry point
 //----------------------------------------------------------------------------------
-int main(void)
+int main(int argc, char *argv[])
 {
     // Initialization
     //---------------------------------------------------------
+    InitLogger();
     SetTraceLogCallback(CustomLog);
 
+    // Command line, headless tools (no window):
+    //   minesweeper_clone --replay <file.msr> [repeat]
+    //   minesweeper_clone --verify-daemon <inbox directory> [workers]
+    //   minesweeper_clone --verify-client <inbox directory> [replays]
+    //   minesweeper_clone --bake-fonts <font.ttf> <output.msfa>
+    //   minesweeper_clone --pack-assets <output pack> <directory or file>...
+    //   minesweeper_clone --server <port> [workers] [race|lockstep] [garbage] [budget <tick budget ms>]
+    //   minesweeper_clone --bots <port> [bots] [actions per second] [random|solver] [rating spread]    (connects to localhost)
+    //   minesweeper_clone --load-test <bots> [actions per second] [random|solver] [workers] [rating spread]
+    // Multiplayer, with a window:
+    //   minesweeper_clone --connect <server address> [port] [rating]
+    //   minesweeper_clone --spectate <server address> [port] [match id]
+    // Window options, may follow any of the above:
+    //   --gif-fps <frames per second>     (GIF recording framerate, default 15)
+    if (argc >= 3)
+    {
+        int count = (argc >= 4)? atoi(argv[3]) : 0;
+        if (strcmp(argv[1], "--replay") == 0) return RunReplayPlayer(argv[2], count);
+        if (strcmp(argv[1], "--verify-daemon") == 0) return RunReplayVerifierDaemon(argv[2], count);
+        if (strcmp(argv[1], "--verify-client") == 0) return RunReplayVerifierClient(argv[2], (count > 0)? count : 1000);
+        if ((strcmp(argv[1], "--bake-fonts") == 0) && (argc >= 4)) return RunFontBaker(argv[2], argv[3]);
+        if ((strcmp(argv[1], "--pack-assets") == 0) && (argc >= 4)) return RunAssetPacker(argv[2], (const char **)argv + 3, argc - 3);
+        if (strcmp(argv[1], "--server") == 0)
+        {
+            ServerSettings settings = GetDefaultServerSettings();
+            settings.port = atoi(argv[2]);
+            int first = 3;
+            if ((argc > first) && IsNumberArgument(argv[first])) settings.workerCount = atoi(argv[first++]);   // Optional, keywords may come right after the port
+            for (int i = first; i < argc; ++i)
+            {
+                if (strcmp(argv[i], "race") == 0) settings.mode = MATCH_MODE_RACE;
+                if (strcmp(argv[i], "lockstep") == 0) settings.mode = MATCH_MODE_LOCKSTEP;
+                if (strcmp(argv[i], "garbage") == 0) settings.garbage = true;
+                if ((strcmp(argv[i], "budget") == 0) && (i + 1 < argc)) settings.tickBudget = (float)atof(argv[++i]);
+            }
+            return RunMatchServer(settings);
+        }
+        if ((strcmp(argv[1], "--bots") == 0) || (strcmp(argv[1], "--load-test") == 0))
+        {
+            bool loadTest = (strcmp(argv[1], "--load-test") == 0);
+            int first = loadTest? 3 : 4;     // Bot count comes before the rest, in place of the port
+            BotSettings bots = GetDefaultBotSettings();
+            bots.port = atoi(argv[2]);
+            bots.botCount = loadTest? atoi(argv[2]) : ((count > 0)? count : SERVER_MAX_PLAYERS);
+            if (argc > first) bots.actionsPerSecond = (float)atof(argv[first]);
+            if (argc > first + 1) bots.policy = GetBotPolicy(argv[first + 1]);
+            int spread = loadTest? first + 3 : first + 2;   // After the worker count of a load test
+            if (argc > spread) bots.ratingSpread = atoi(argv[spread]);
+            if (!loadTest) return RunBotClients(bots);
+
+            ServerSettings server = GetDefaultServerSettings();
+            if (argc > first + 2) server.workerCount = atoi(argv[first + 2]);
+            return RunLoadTest(server, bots);
+        }
+        if ((strcmp(argv[1], "--connect") == 0) || (strcmp(argv[1], "--spectate") == 0))
+        {
+            // NOTE: Positional arguments end at the first window option
+            int positionalCount = 3;
+            while ((positionalCount < argc) && (strncmp(argv[positionalCount], "--", 2) != 0)) ++positionalCount;
+
+            serverAddress = argv[2];
+            serverPort = ((positionalCount > 3) && (count > 0))? count : SERVER_DEFAULT_PORT;
+            serverSpectate = (strcmp(argv[1], "--spectate") == 0);
+            if (serverSpectate) serverMatch = (positionalCount > 4)? (unsigned int)atoi(argv[4]) : 0;
+            else serverRating = (positionalCount > 4)? atoi(argv[4]) : NET_DEFAULT_RATING;
+        }
+    }
+
     InitWindow(screenWidth, screenHeight, "bepis Minesweeper");
     SetExitKey(KEY_KP_0);
+    InitScreenCapture();
+    for (int i = 1; i + 1 < argc; ++i)
+    {
+        if (strcmp(argv[i], "--gif-fps") == 0) SetGifCaptureFramerate(atoi(argv[i + 1]));
+    }
+#if defined(PROFILER_ENABLED)
+    rlSetDrawRenderBatchCallback(ProfileRenderBatchCallback);
+#endif
 
     InitAudioDevice();      // Initialize audio device
 
     // Load global data (assets that must be available in all screens, i.e. font)
+    // NOTE: Assets come from the pack next to the executable, built from src/resources after every build
     ChangeDirectory(GetApplicationDirectory());
-    ChangeDirectory("../../../../../../../src");
-    font = LoadFont("resources/Inconsolata-ExtraBold.ttf");//Inconsolata-VariableFont_wdth,wght.ttf");
-    //music = LoadMusicStream("resources/ambient.ogg");
-    fxCoin = LoadSound("resources/coin.wav");
-    //printf("%s\n%s\n", GetApplicationDirectory(), GetWorkingDirectory());
+    if (!OpenAssetPack(&assetPack, TextFormat("%s%s", GetApplicationDirectory(), ASSET_PACK_FILE)))
+    {
+        LOG_MESSAGE(LOG_LEVEL_ERROR, LOG_CATEGORY_GAME, "Asset pack %s not found or invalid", ASSET_PACK_FILE);
+    }
+
+    // Decoded on the streaming worker, uploaded while the logo screen shows
+    InitAssetStreaming(&assetPack);
+    RequestFontAtlases(ASSET_GROUP_TITLE, "Inconsolata-ExtraBold", &fontAtlases);
+    RequestSound(ASSET_GROUP_TITLE, "coin.wav", &fxCoin);
+
+    InitSimulation();       // NOTE: Game core runs on its own thread, screens only draw its snapshots
+    //music = LoadMusicStreamFromMemory(".ogg", ...ambient.ogg);
     //SetWindowOpacity(0.9f);
-    ChangeDirectory(GetApplicationDirectory());
 
     SetMusicVolume(music, 1.0f);
     PlayMusicStream(music);
 
     // Setup and init first screen
-    currentScreen = TITLE;
-    InitTitleScreen();//InitLogoScreen();
+    currentScreen = LOGO;
+    InitLogoScreen();   // NOTE: Hands off to the title screen as soon as its assets are streamed in
+    simLastTime = GetTime();
 
 #if defined(PLATFORM_WEB)
     emscripten_set_main_loop(UpdateDrawFrame, 60, 1);
 #else
-    SetTargetFPS(60);       // Set our game to run at 60 frames-per-second
+    // Render at the monitor refresh rate, gameplay logic runs at SIM_TICK_RATE regardless
+    int refreshRate = GetMonitorRefreshRate(GetCurrentMonitor());
+    SetTargetFPS((refreshRate > 0)? refreshRate : 60);
     //--------------------------------------------------------------------------------------
 
     // Main game loop
@@ -114,14 +232,27 @@ int main(void)
         default: break;
     }
 
+    CloseSimulation();
+
     // Unload global data loaded
-    UnloadFont(font);
+    CloseAssetStreaming();  // NOTE: Before unloading targets, still decoding assets are dropped
+    UnloadFontAtlasSet(&fontAtlases);     // NOTE: Includes font
     UnloadMusicStream(music);
+    UnloadSoundEffects();   // NOTE: Before fxCoin, voices share its sample data
     UnloadSound(fxCoin);
 
     CloseAudioDevice();     // Close audio context
 
+    CloseScreenCapture();   // Finish pending screenshots/GIF before losing the window
+
+#if defined(PROFILER_ENABLED)
+    ExportProfileTrace(PROFILER_TRACE_FILE);
+#endif
+
     CloseWindow();          // Close window and OpenGL context
+    CloseAssetPack(&assetPack);
+
+    CloseLogger();          // Write out queued messages
     //--------------------------------------------------------------------------------------
 
     return 0;
@@ -161,9 +292,29 @@ internal void ChangeToScreen(GameScreen screen)
 // Update and draw game frame
 internal void UpdateDrawFrame(void)
 {
+    PROFILE_FUNCTION();
+
     // Update
     //----------------------------------------------------------------------------------
     UpdateMusicStream(music);       // NOTE: Music keeps playing between screens
+
+    // Finish streamed assets a few per frame, font gets its base size atlas as soon as it is uploaded
+    if (!IsAssetStreamingDone())
+    {
+        UpdateAssetStreaming(ASSET_UPLOAD_TIME);
+        font = GetFontForSize(&fontAtlases, FONT_ATLAS_BASE_SIZE);
+
+        if (IsAssetStreamingDone()) InitSoundEffects(fxCoin);   // NOTE: Voices are allocated once, here
+    }
+
+    // Consume the real time elapsed since the last frame as fixed steps (camera, screen animations)
+    // NOTE: The game itself ticks on the simulation thread, on its own clock
+    double currentTime = GetTime();
+    double frameTime = currentTime - simLastTime;
+    if (frameTime > SIM_MAX_FRAME_TIME) frameTime = SIM_MAX_FRAME_TIME;
+    simLastTime = currentTime;
+    simAccumulator += frameTime;
+
     int finishResult = 0;
     switch(currentScreen)
     {
@@ -204,6 +355,18 @@ internal void UpdateDrawFrame(void)
         ChangeToScreen((GameScreen)finishResult);
     }
 
+    // Advance the screen in fixed steps
+    PROFILE_BEGIN("ScreenTicks");
+    while (simAccumulator >= SIM_TICK_TIME)
+    {
+        if (currentScreen == GAMEPLAY) TickGameplayScreen();
+        simAccumulator -= SIM_TICK_TIME;
+    }
+    simAlpha = (float)(simAccumulator/SIM_TICK_TIME);
+    PROFILE_END();
+
+    UpdateSoundEffects();           // Start sounds triggered this frame, simulation ones included
+
     if ((IsKeyDown(KEY_LEFT_ALT) || IsKeyDown(KEY_RIGHT_ALT)) && (IsKeyPressed(KEY_ENTER) || IsKeyPressed(KEY_KP_ENTER)))
     {
         if (IsWindowFullscreen())
@@ -220,6 +383,32 @@ internal void UpdateDrawFrame(void)
             ToggleFullscreen();
         }
     }
+
+    // Performance overlay toggle
+    if (IsKeyPressed(KEY_F2)) showPerfOverlay = !showPerfOverlay;
+
+    // Input latency overlay toggle and CSV export
+    if (IsKeyPressed(KEY_F3)) showLatencyOverlay = !showLatencyOverlay;
+    if (IsKeyPressed(KEY_F4))
+    {
+        if (ExportInputLatencyCSV("input_latency.csv")) LOG_MESSAGE(LOG_LEVEL_INFO, LOG_CATEGORY_LATENCY, "Samples exported to input_latency.csv");
+        else LOG_MESSAGE(LOG_LEVEL_WARNING, LOG_CATEGORY_LATENCY, "Failed to export samples");
+    }
+
+#if defined(PROFILER_ENABLED)
+    if (IsKeyPressed(KEY_F5))
+    {
+        if (ExportProfileTrace(PROFILER_TRACE_FILE)) LOG_MESSAGE(LOG_LEVEL_INFO, LOG_CATEGORY_PROFILER, "Trace exported to %s", PROFILER_TRACE_FILE);
+        else LOG_MESSAGE(LOG_LEVEL_WARNING, LOG_CATEGORY_PROFILER, "Failed to export trace");
+    }
+#endif
+
+    // Screen capture, encoding and saving happen on the capture worker
+    if (IsKeyPressed(KEY_F12))
+    {
+        if (IsKeyDown(KEY_LEFT_CONTROL) || IsKeyDown(KEY_RIGHT_CONTROL)) ToggleGifRecording();
+        else RequestScreenshot();
+    }
     //----------------------------------------------------------------------------------
 
     // Draw
@@ -242,29 +431,156 @@ internal void UpdateDrawFrame(void)
 
         //DrawFPS(10, 10);
 
-    EndDrawing();
+        if (showLatencyOverlay) DrawInputLatencyOverlay(10, GetScreenHeight() - 100);
+
+        // NOTE: Stats are taken before the overlay is drawn so it does not count itself
+        rlRenderStats renderStats = rlGetRenderStats();
+        if (showPerfOverlay) DrawPerfOverlay(GetScreenWidth() - PERF_FRAME_HISTORY - 30, 10);
+
+        CaptureScreen();    // NOTE: Overlays drawn after this are not captured
+
+#if !defined(PLATFORM_WEB)
+    // Sleep on input events inside EndDrawing() while nothing on screen is changing by itself
+    double idleWaitTime = GetIdleWaitTime();
+    if (idleWaitTime != 0.0)
+    {
+        SetEventWaitingTimeout(idleWaitTime);
+        EnableEventWaiting();
+    }
+    else DisableEventWaiting();
+#endif
+
+    MarkInputLatencySubmitted();
+    float workTime = (float)(GetTime() - currentTime);
+    PROFILE_BEGIN("EndDrawing");
+    EndDrawing();       // NOTE: Includes last batch flush, buffers swap, input polling/waiting and frame limiting
+    PROFILE_END();
+    RecordPerfFrame(GetFrameTime(), workTime, renderStats);
+    rlResetRenderStats();
+    MarkInputLatencySwapped(GetSwapTime());
+    PROFILE_MARK("SwapScreenBuffer", GetTime() - GetSwapTime());
     //----------------------------------------------------------------------------------
 }
 
+// Get how long the next frame may sleep waiting for input events
+// NOTE: 0 = something is animating, keep polling; < 0 = fully static, wait indefinitely
+internal double GetIdleWaitTime(void)
+{
+    if (onTransition || (currentScreen == LOGO) || IsMusicStreamPlaying(music) || IsGifRecording() || showPerfOverlay) return 0.0;
+
+    if (currentScreen == GAMEPLAY) return GetGameplayIdleWaitTime();
+
+    return -1.0;
+}
+
+// Re-execute a replay through the game core as fast as possible and check its final state hash
+// NOTE: repeat > 1 replays it several times to measure the playback rate
+internal int RunReplayPlayer(const char *fileName, int repeat)
+{
+    local_persist GameState game = { 0 };
+    Replay replay = { 0 };
+
+    if (!LoadReplay(fileName, &replay))
+    {
+        printf("%s: invalid replay file\n", fileName);
+        return 2;
+    }
+    if (repeat < 1) repeat = 1;
+
+    bool match = true;
+    clock_t start = clock();
+    for (int i = 0; i < repeat; ++i) match = PlayReplay(&replay, &game) && match;
+    double seconds = (double)(clock() - start)/CLOCKS_PER_SEC;
+
+    printf("%s: %s\n", fileName, match? "OK" : "HASH MISMATCH");
+    printf("  board %ix%i, seed %u, %i actions, %s at %.2fs, hash %016llx\n",
+           replay.settings.width, replay.settings.height, replay.settings.seed, replay.count,
+           game.winCon? "won" : ((game.hp <= 0)? "lost" : "unfinished"), GetGameTimer(&game), GetGameStateHash(&game));
+    if (seconds > 0.0)
+    {
+        printf("  %i playbacks in %.3fs: %.0f actions/s\n", repeat, seconds, (double)replay.count*repeat/seconds);
+    }
+
+    UnloadReplay(&replay);
+    return match? 0 : 1;
+}
+
+// Bake glyph atlases of a TTF font at every size in FONT_ATLAS_SIZES
+internal int RunFontBaker(const char *ttfFileName, const char *fileName)
+{
+    bool result = BakeFontAtlases(ttfFileName, fileName);
+
+    if (result) printf("%s: font atlases baked from %s\n", fileName, ttfFileName);
+    else printf("%s: failed to bake font atlases from %s\n", fileName, ttfFileName);
+
+    return result? 0 : 1;
+}
+
+// Pack files, and every file of directories (not recursive), into an asset pack
+internal int RunAssetPacker(const char *fileName, const char **inputs, int inputCount)
+{
+    FilePathList directories[8] = { 0 };
+    int directoryCount = 0;
+    int capacity = 0;
+    for (int i = 0; i < inputCount; ++i)
+    {
+        if (IsPathFile(inputs[i])) ++capacity;
+        else if (directoryCount < (int)ARRAYCOUNT(directories))
+        {
+            directories[directoryCount] = LoadDirectoryFiles(inputs[i]);
+            capacity += (int)directories[directoryCount].count;
+            ++directoryCount;
+        }
+    }
+
+    const char **paths = (const char **)malloc((capacity + 1)*sizeof(const char *));
+    int fileCount = 0;
+    for (int i = 0; i < inputCount; ++i) if (IsPathFile(inputs[i])) paths[fileCount++] = inputs[i];
+    for (int i = 0; i < directoryCount; ++i)
+    {
+        for (unsigned int j = 0; j < directories[i].count; ++j)
+        {
+            if (IsPathFile(directories[i].paths[j])) paths[fileCount++] = directories[i].paths[j];     // NOTE: Subdirectories are skipped
+        }
+    }
+    bool result = (fileCount > 0) && BuildAssetPack(fileName, paths, fileCount);
+    free(paths);
+
+    if (result) printf("%s: %i assets packed\n", fileName, fileCount);
+    else printf("%s: failed to pack assets\n", fileName);
+
+    for (int i = 0; i < directoryCount; ++i) UnloadDirectoryFiles(directories[i]);
+    return result? 0 : 1;
+}
+
+internal bool IsNumberArgument(const char *text)
+{
+    if (*text == '-') ++text;
+    if (*text == '\0') return false;
+    for (; *text != '\0'; ++text) if (((*text < '0') || (*text > '9')) && (*text != '.')) return false;
+
+    return true;
+}
+
 // Logger
+// NOTE: Called on the thread that logged, only queues the message
 internal void CustomLog(int msgType, const char* text, va_list args)
 {
-    char timeStr[64] = { 0 };
-    time_t now = time(NULL);
-    struct tm* tm_info = localtime(&now);
-
-    strftime(timeStr, sizeof(timeStr), "%Y-%m-%d %H:%M:%S", tm_info);
-    printf("[%s] ", timeStr);
+    LogLevel level = LOG_LEVEL_INFO;
 
     switch (msgType)
     {
-    case LOG_INFO: printf("[INFO] : "); break;
-    case LOG_ERROR: printf("[ERROR]: "); break;
-    case LOG_WARNING: printf("[WARN] : "); break;
-    case LOG_DEBUG: printf("[DEBUG]: "); break;
+    case LOG_TRACE:
+    case LOG_DEBUG: level = LOG_LEVEL_DEBUG; break;
+    case LOG_WARNING: level = LOG_LEVEL_WARNING; break;
+    case LOG_ERROR:
+    case LOG_FATAL: level = LOG_LEVEL_ERROR; break;
     default: break;
     }
 
-    vprintf(text, args);
-    printf("\n");
+#if !defined(_DEBUG)
+    if (level == LOG_LEVEL_DEBUG) return;
+#endif
+
+    LogMessageV(level, LOG_CATEGORY_RAYLIB, text, args);
 }
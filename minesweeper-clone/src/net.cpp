@@ -0,0 +1,215 @@
+/**********************************************************************************************
+*
+*   Minesweeper Clone - Network Sockets
+*
+*   Thin wrapper over non-blocking TCP sockets.
+*
+*   Copyright (c) 2024 (DoughnutDude)
+*
+**********************************************************************************************/
+
+#include "net.h"
+
+#include <stdlib.h>         // Required for: malloc(), free()
+#include <string.h>         // Required for: memset()
+
+#if defined(_WIN32)
+    // NOTE: winsock2.h is only included here, it collides with raylib.h
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+
+    typedef SOCKET SocketHandle;
+    typedef WSAPOLLFD PollDescriptor;
+    #define poll WSAPoll
+    #define SHUT_WR SD_SEND
+    #define SHUT_RDWR SD_BOTH
+#else
+    #include <sys/socket.h>
+    #include <netinet/in.h>
+    #include <netinet/tcp.h>    // Required for: TCP_NODELAY
+    #include <arpa/inet.h>      // Required for: inet_pton()
+    #include <poll.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <errno.h>
+    #include <signal.h>         // Required for: signal(), SIGPIPE
+
+    typedef int SocketHandle;
+    typedef struct pollfd PollDescriptor;
+#endif
+
+#define internal static
+
+#define NET_LISTEN_BACKLOG      1024
+#define NET_POLL_STACK_ENTRIES  64      // Poll descriptors on the stack, more are allocated
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions Definition
+//----------------------------------------------------------------------------------
+internal bool WouldBlock(void)
+{
+#if defined(_WIN32)
+    return (WSAGetLastError() == WSAEWOULDBLOCK);
+#else
+    return ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR));
+#endif
+}
+
+internal void SetSocketOptions(SocketHandle handle)
+{
+#if defined(_WIN32)
+    u_long nonBlocking = 1;
+    ioctlsocket(handle, FIONBIO, &nonBlocking);
+#else
+    fcntl(handle, F_SETFL, fcntl(handle, F_GETFL, 0) | O_NONBLOCK);
+#endif
+
+    // Small messages go out right away, latency matters more than packet count here
+    int noDelay = 1;
+    setsockopt(handle, IPPROTO_TCP, TCP_NODELAY, (const char *)&noDelay, sizeof(noDelay));
+}
+
+internal void CloseSocketHandle(SocketHandle handle)
+{
+#if defined(_WIN32)
+    closesocket(handle);
+#else
+    close(handle);
+#endif
+}
+
+//----------------------------------------------------------------------------------
+// Network Functions Definition
+//----------------------------------------------------------------------------------
+bool InitNetwork(void)
+{
+#if defined(_WIN32)
+    WSADATA data;
+    return (WSAStartup(MAKEWORD(2, 2), &data) == 0);
+#else
+    signal(SIGPIPE, SIG_IGN);       // Writing to a closed socket is an error, not a crash
+    return true;
+#endif
+}
+
+void CloseNetwork(void)
+{
+#if defined(_WIN32)
+    WSACleanup();
+#endif
+}
+
+NetSocket OpenListenSocket(int port)
+{
+    SocketHandle handle = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (handle == (SocketHandle)-1) return NET_INVALID_SOCKET;
+
+    int reuse = 1;
+    setsockopt(handle, SOL_SOCKET, SO_REUSEADDR, (const char *)&reuse, sizeof(reuse));
+
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons((unsigned short)port);
+
+    if ((bind(handle, (struct sockaddr *)&address, sizeof(address)) != 0) || (listen(handle, NET_LISTEN_BACKLOG) != 0))
+    {
+        CloseSocketHandle(handle);
+        return NET_INVALID_SOCKET;
+    }
+
+    SetSocketOptions(handle);
+    return (NetSocket)handle;
+}
+
+NetSocket AcceptSocket(NetSocket listener)
+{
+    SocketHandle handle = accept((SocketHandle)listener, NULL, NULL);
+    if (handle == (SocketHandle)-1) return NET_INVALID_SOCKET;
+
+    SetSocketOptions(handle);
+    return (NetSocket)handle;
+}
+
+NetSocket ConnectSocket(const char *host, int port)
+{
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons((unsigned short)port);
+    if (inet_pton(AF_INET, host, &address.sin_addr) != 1) return NET_INVALID_SOCKET;
+
+    SocketHandle handle = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (handle == (SocketHandle)-1) return NET_INVALID_SOCKET;
+
+    if (connect(handle, (struct sockaddr *)&address, sizeof(address)) != 0)
+    {
+        CloseSocketHandle(handle);
+        return NET_INVALID_SOCKET;
+    }
+
+    SetSocketOptions(handle);
+    return (NetSocket)handle;
+}
+
+int SendSocket(NetSocket socket, const void *data, int size)
+{
+#if defined(_WIN32)
+    int result = send((SocketHandle)socket, (const char *)data, size, 0);
+#else
+    int result = (int)send((SocketHandle)socket, data, (size_t)size, MSG_NOSIGNAL);
+#endif
+    if (result < 0) return WouldBlock()? 0 : -1;
+
+    return result;
+}
+
+int ReceiveSocket(NetSocket socket, void *buffer, int size)
+{
+#if defined(_WIN32)
+    int result = recv((SocketHandle)socket, (char *)buffer, size, 0);
+#else
+    int result = (int)recv((SocketHandle)socket, buffer, (size_t)size, 0);
+#endif
+    if (result == 0) return -1;     // Orderly shutdown by the peer
+    if (result < 0) return WouldBlock()? 0 : -1;
+
+    return result;
+}
+
+void ShutdownSocket(NetSocket socket, bool receiveToo)
+{
+    shutdown((SocketHandle)socket, receiveToo? SHUT_RDWR : SHUT_WR);
+}
+
+void CloseSocket(NetSocket socket)
+{
+    if (socket != NET_INVALID_SOCKET) CloseSocketHandle((SocketHandle)socket);
+}
+
+int PollSockets(NetPollEntry *entries, int count, int timeoutMs)
+{
+    PollDescriptor stackDescriptors[NET_POLL_STACK_ENTRIES];
+    PollDescriptor *descriptors = (count <= NET_POLL_STACK_ENTRIES)? stackDescriptors : (PollDescriptor *)malloc(count*sizeof(PollDescriptor));
+
+    for (int i = 0; i < count; ++i)
+    {
+        descriptors[i].fd = (SocketHandle)entries[i].socket;
+        descriptors[i].events = POLLIN;
+        descriptors[i].revents = 0;
+    }
+
+    int result = poll(descriptors, count, timeoutMs);
+
+    for (int i = 0; i < count; ++i)
+    {
+        entries[i].readable = ((descriptors[i].revents & POLLIN) != 0);
+        entries[i].closed = ((descriptors[i].revents & (POLLHUP | POLLERR | POLLNVAL)) != 0);
+    }
+
+    if (descriptors != stackDescriptors) free(descriptors);
+    return result;
+}
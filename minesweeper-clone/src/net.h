@@ -0,0 +1,47 @@
+/**********************************************************************************************
+*
+*   Minesweeper Clone - Network Sockets
+*
+*   Thin wrapper over TCP sockets (BSD sockets, Winsock on Windows). Every socket is
+*   non-blocking with Nagle disabled, readiness is checked with PollSockets().
+*
+*   Copyright (c) 2024 (DoughnutDude)
+*
+**********************************************************************************************/
+
+#ifndef NET_H
+#define NET_H
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define NET_INVALID_SOCKET      -1
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef long long NetSocket;        // NOTE: Big enough for a Winsock SOCKET handle
+
+typedef struct NetPollEntry {
+    NetSocket socket;
+    bool readable;          // Data (or a connection to accept) is waiting
+    bool closed;            // Peer hung up or socket error, still readable until the pending data is read
+} NetPollEntry;
+
+//----------------------------------------------------------------------------------
+// Network Functions Declaration
+//----------------------------------------------------------------------------------
+bool InitNetwork(void);
+void CloseNetwork(void);
+
+NetSocket OpenListenSocket(int port);                       // Listen on every interface
+NetSocket AcceptSocket(NetSocket listener);                 // NET_INVALID_SOCKET if none is waiting
+NetSocket ConnectSocket(const char *host, int port);        // Blocks until connected, numeric IPv4 host
+int SendSocket(NetSocket socket, const void *data, int size);   // Bytes sent, 0 if the send buffer is full, -1 on error
+int ReceiveSocket(NetSocket socket, void *buffer, int size);    // Bytes received, 0 if nothing is waiting, -1 once closed or on error
+void ShutdownSocket(NetSocket socket, bool receiveToo);     // Stop sending (the peer reads end of stream), receiving too if asked
+void CloseSocket(NetSocket socket);
+
+int PollSockets(NetPollEntry *entries, int count, int timeoutMs);   // Entries ready, -1 on error
+
+#endif // NET_H
@@ -0,0 +1,674 @@
+/**********************************************************************************************
+*
+*   Minesweeper Clone - Network Client
+*
+*   Match server client with predicted actions.
+*
+*   Copyright (c) 2024 (DoughnutDude)
+*
+**********************************************************************************************/
+
+#include "net_client.h"
+#include "net.h"
+#include "net_protocol.h"
+#include "board_sync.h"
+
+#include <stdlib.h>         // Required for: calloc(), free()
+#include <string.h>         // Required for: memcmp(), memmove(), memset()
+
+#define internal static
+#define global_var static
+
+#define NET_CLIENT_OUTPUT_SIZE      1024
+#define NET_CLIENT_SYNC_RETRY_TIME  1.0     // Seconds before asking for another keyframe
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct PendingAction {
+    unsigned int sequence;
+    GameAction action;
+} PendingAction;
+
+typedef struct OpponentBoard {
+    GameState view;
+    BoardSync sync;
+    PlayerStatus status;
+    bool valid;             // Last delta matched its checksum, a keyframe is asked for otherwise
+    unsigned long long hash;    // Lockstep: GetGameStateHash() of the board (the confirmed one for this player)
+    bool hashStale;             // Lockstep: changed by the step being applied
+} OpponentBoard;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+global_var NetSocket clientSocket = NET_INVALID_SOCKET;
+global_var NetClientState clientState = NET_CLIENT_OFFLINE;
+global_var NetClientStats clientStats = { 0 };
+
+global_var unsigned char input[NET_MESSAGE_HEADER_SIZE + NET_MAX_MESSAGE_SIZE];
+global_var int inputSize = 0;
+global_var unsigned char output[NET_CLIENT_OUTPUT_SIZE];
+global_var int outputSize = 0;
+
+global_var int player = -1;                 // Board watched when spectating
+global_var bool spectating = false;
+global_var int winner = -1;
+global_var MatchMode matchMode = MATCH_MODE_OWN_BOARDS;
+global_var double matchStartTime = 0.0;
+global_var int clientTick = 0;              // Ticks since the match start as seen by this client
+global_var int lockstepStep = 0;            // Next lockstep step expected
+global_var double syncRequestTime = -NET_CLIENT_SYNC_RETRY_TIME;
+global_var double opponentRequestTime = 0.0;
+
+global_var GameState predicted = { 0 };     // Confirmed board and the pending actions, drawn
+global_var GameState confirmed = { 0 };     // Seeded board and the actions the server accepted
+global_var GameState view = { 0 };          // Board received in deltas
+global_var BoardSync viewSync = { 0 };
+global_var unsigned int boardVersion = 0;
+
+global_var PendingAction pending[NET_CLIENT_MAX_PENDING];
+global_var int pendingHead = 0;
+global_var int pendingCount = 0;
+global_var unsigned int nextSequence = 0;
+
+global_var OpponentBoard *opponents = NULL;     // Every player of the match, this player one unused
+global_var int playerCount = 0;
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions Definition
+//----------------------------------------------------------------------------------
+internal void FlushNetClientOutput(void)
+{
+    if (outputSize == 0) return;
+
+    int sent = SendSocket(clientSocket, output, outputSize);
+    if (sent < 0)
+    {
+        CloseSocket(clientSocket);
+        clientSocket = NET_INVALID_SOCKET;
+        clientState = NET_CLIENT_OFFLINE;
+        outputSize = 0;
+        return;
+    }
+
+    memmove(output, output + sent, outputSize - sent);
+    outputSize -= sent;
+}
+
+internal NetWriter BeginNetClientMessage(NetMessageType type)
+{
+    NetWriter writer = { output, NET_CLIENT_OUTPUT_SIZE, outputSize, 0, false };
+    BeginNetMessage(&writer, type);
+    return writer;
+}
+
+internal bool EndNetClientMessage(NetWriter *writer)
+{
+    if (!EndNetMessage(writer)) return false;
+
+    outputSize = writer->size;
+    return true;
+}
+
+// Rebuild the prediction from the confirmed board and the actions still unanswered
+internal void RollbackPrediction(void)
+{
+    predicted = confirmed;
+    for (int i = 0; i < pendingCount; ++i) ApplyGameAction(&predicted, pending[(pendingHead + i)%NET_CLIENT_MAX_PENDING].action);
+    predicted.tick = clientTick;
+
+    ++clientStats.rollbacks;
+    ++boardVersion;
+}
+
+// The view is the server board, does the confirmed board show the same?
+internal bool IsViewConfirmed(void)
+{
+    if (view.hp != confirmed.hp) return false;
+
+    for (int y = 0; y < view.height; ++y)
+    {
+        if (memcmp(view.boardMask[y], confirmed.boardMask[y], view.width) != 0) return false;
+        for (int x = 0; x < view.width; ++x)
+        {
+            if ((view.boardMask[y][x] == 0) && (view.board[y][x] != confirmed.board[y][x])) return false;
+        }
+    }
+
+    return true;
+}
+
+// Take every visible tile of the view as the truth, hidden tiles keep their seeded values
+internal void AdoptServerView(void)
+{
+    confirmed.hiddenSafeTiles = 0;
+    for (int y = 0; y < view.height; ++y)
+    {
+        for (int x = 0; x < view.width; ++x)
+        {
+            confirmed.boardMask[y][x] = view.boardMask[y][x];
+            if (view.boardMask[y][x] == 0) confirmed.board[y][x] = view.board[y][x];
+            else if (confirmed.board[y][x] >= 0) ++confirmed.hiddenSafeTiles;
+        }
+    }
+    confirmed.hp = view.hp;
+    confirmed.winCon = ((confirmed.hp > 0) && (confirmed.hiddenSafeTiles <= 0));
+}
+
+internal void SendSyncRequest(int board)
+{
+    NetWriter writer = BeginNetClientMessage(MSG_SYNC_REQUEST);
+    NetWriteU8(&writer, (unsigned int)board);
+    EndNetClientMessage(&writer);
+}
+
+// Opponents still waiting for a keyframe ask again, in case their request or keyframe was lost
+// NOTE: Spectators get every keyframe in their stream, they only ask on a checksum mismatch
+internal void RetryOpponentRequests(double time)
+{
+    if (spectating || (time - opponentRequestTime < NET_CLIENT_SYNC_RETRY_TIME)) return;
+
+    for (int i = 0; i < playerCount; ++i) if ((i != player) && !opponents[i].valid) SendSyncRequest(i);
+    opponentRequestTime = time;
+}
+
+// Garbage on a received board: the same hidden rows the server copy got (see ACTION_GARBAGE),
+// mines injected in its hidden tiles do not show
+internal void GrowReceivedBoard(BoardSync *sync, GameState *board, int rows)
+{
+    if (sync->height + rows <= maxBoardHeight) InsertViewRows(sync, board, sync->height, rows);
+}
+
+internal void MarkOpponentChanged(OpponentBoard *opponent, BoardRegion region)
+{
+    BoardRegion *changed = &opponent->sync.changed;
+    if (changed->minX >= changed->maxX) *changed = region;
+    else
+    {
+        if (region.minX < changed->minX) changed->minX = region.minX;
+        if (region.minY < changed->minY) changed->minY = region.minY;
+        if (region.maxX > changed->maxX) changed->maxX = region.maxX;
+        if (region.maxY > changed->maxY) changed->maxY = region.maxY;
+    }
+}
+
+// Own input back from the server: confirm it, false if the prediction was wrong
+// NOTE: Inputs come back in the order they were sent, the ones the server dropped are skipped
+internal bool ConfirmLockstepAction(GameAction action)
+{
+    bool sent = false;
+    while ((pendingCount > 0) && !sent)
+    {
+        GameAction predictedAction = pending[pendingHead].action;
+        pendingHead = (pendingHead + 1)%NET_CLIENT_MAX_PENDING;
+        --pendingCount;
+        sent = (predictedAction.type == action.type) && (predictedAction.x == action.x) && (predictedAction.y == action.y);
+    }
+
+    confirmed.tick = action.tick;
+    bool accepted = ApplyGameAction(&confirmed, action);
+    if (accepted) opponents[player].hashStale = true;
+
+    return (sent && accepted);
+}
+
+// Apply the inputs of a step to every board, then report the state hash they lead to
+internal void ApplyLockstepStep(NetReader *payload)
+{
+    int step = (int)NetReadU32(payload);
+    int count = (int)NetReadU8(payload);
+    if (payload->overflow || (matchMode != MATCH_MODE_LOCKSTEP) || spectating || (step != lockstepStep)) return;
+
+    bool predictedRight = true;
+    bool garbage = false;
+    for (int i = 0; i < count; ++i)
+    {
+        int index = (int)NetReadU8(payload);
+        GameAction action = { 0 };
+        action.tick = step*NET_LOCKSTEP_STEP_TICKS;
+        action.type = (GameActionType)NetReadU8(payload);
+        action.x = (int)NetReadU8(payload);
+        action.y = (int)NetReadU8(payload);
+        if (payload->overflow || (index >= playerCount)) break;
+
+        // NOTE: Garbage sent to this player was never predicted, the prediction is rebuilt on top of it
+        if ((index == player) && (action.type == ACTION_GARBAGE))
+        {
+            confirmed.tick = action.tick;
+            if (ApplyGameAction(&confirmed, action)) opponents[player].hashStale = garbage = true;
+            continue;
+        }
+        if (index == player)
+        {
+            if (!ConfirmLockstepAction(action)) predictedRight = false;
+            continue;
+        }
+
+        // A flag only changes its tile, garbage its new rows (injected mines stay hidden), a reveal
+        // can flood anywhere and the end of a board shows every mine
+        OpponentBoard *opponent = &opponents[index];
+        int height = opponent->view.height;
+        opponent->view.tick = action.tick;
+        if (!ApplyGameAction(&opponent->view, action)) continue;
+
+        opponent->hashStale = true;
+        if ((action.type == ACTION_FLAG) && !IsGameOver(&opponent->view)) MarkOpponentChanged(opponent, { action.x, action.y, action.x + 1, action.y + 1 });
+        else if (action.type == ACTION_GARBAGE) MarkOpponentChanged(opponent, { 0, height, opponent->view.width, opponent->view.height });
+        else MarkOpponentChanged(opponent, { 0, 0, opponent->view.width, opponent->view.height });
+    }
+    if (!predictedRight) ++clientStats.mispredictions;
+    if (!predictedRight || garbage) RollbackPrediction();
+
+    unsigned long long boardHashes[NET_NO_PLAYER];
+    for (int i = 0; i < playerCount; ++i)
+    {
+        OpponentBoard *opponent = &opponents[i];
+        if (opponent->hashStale) opponent->hash = GetGameStateHash((i == player)? &confirmed : &opponent->view);
+        opponent->hashStale = false;
+        boardHashes[i] = opponent->hash;
+    }
+
+    NetWriter writer = BeginNetClientMessage(MSG_LOCKSTEP_HASH);
+    NetWriteU32(&writer, (unsigned int)step);
+    NetWriteU32(&writer, GetLockstepHash(boardHashes, playerCount));
+    EndNetClientMessage(&writer);
+    ++lockstepStep;
+}
+
+internal void HandleNetClientMessage(NetMessageType type, NetReader *payload, double time)
+{
+    switch (type)
+    {
+        case MSG_MATCH_START:
+        {
+            NetReadU32(payload);
+            player = (int)NetReadU8(payload);
+            int count = (int)NetReadU8(payload);
+            GameSettings settings = NetReadGameSettings(payload);
+            settings.seed = NetReadU32(payload);
+            MatchMode mode = (MatchMode)NetReadU8(payload);
+            if (payload->overflow || (settings.width > maxBoardWidth) || (settings.height > maxBoardHeight) || (player >= count)) break;
+
+            // Same seed, same board as the server (and every other player of a race)
+            bool race = (mode == MATCH_MODE_RACE);
+            bool lockstep = (mode == MATCH_MODE_LOCKSTEP);
+            unsigned int matchSeed = settings.seed;
+            if (lockstep) settings.seed = GetMatchBoardSeed(matchSeed, player);
+            InitGame(&confirmed, settings);
+            if (race) OpenGame(&confirmed);
+            matchMode = mode;
+            predicted = confirmed;
+            if (race || lockstep)
+            {
+                view = confirmed;
+                InitBoardSync(&viewSync, &view);
+            }
+            else
+            {
+                memset(&view, 0, sizeof(view));
+                ResetBoardSync(&viewSync, settings.width, settings.height);
+            }
+
+            // NOTE: Opponent boards stay hidden until their keyframe arrives, race boards start
+            // as the opened board every player has, lockstep boards are all generated here
+            free(opponents);
+            opponents = (OpponentBoard *)calloc(count, sizeof(OpponentBoard));
+            playerCount = count;
+            for (int i = 0; i < count; ++i)
+            {
+                OpponentBoard *opponent = &opponents[i];
+                if (lockstep)
+                {
+                    settings.seed = GetMatchBoardSeed(matchSeed, i);
+                    if (i != player) InitGame(&opponent->view, settings);
+                    opponent->hash = GetGameStateHash((i == player)? &confirmed : &opponent->view);
+                    opponent->valid = true;
+                    continue;
+                }
+                if (race)
+                {
+                    opponent->view = confirmed;
+                    InitBoardSync(&opponent->sync, &opponent->view);
+                    opponent->valid = true;
+                    continue;
+                }
+                opponent->view.width = settings.width;
+                opponent->view.height = settings.height;
+                for (int y = 0; y < settings.height; ++y) memset(opponent->view.boardMask[y], 1, settings.width);
+                ResetBoardSync(&opponent->sync, settings.width, settings.height);
+            }
+            opponentRequestTime = time;
+
+            matchStartTime = time;
+            clientTick = 0;
+            lockstepStep = 0;
+            clientState = NET_CLIENT_PLAYING;
+            ++boardVersion;
+        } break;
+        case MSG_SPECTATE_START:
+        {
+            // NOTE: Sent again when the server makes this spectator start over from a keyframe
+            NetReadU32(payload);
+            int count = (int)NetReadU8(payload);
+            GameSettings settings = NetReadGameSettings(payload);
+            MatchMode mode = (MatchMode)NetReadU8(payload);
+            if (payload->overflow || !spectating || (count == 0) || (settings.width > maxBoardWidth) || (settings.height > maxBoardHeight)) break;
+
+            // Every board hidden, the keyframes follow
+            free(opponents);
+            opponents = (OpponentBoard *)calloc(count, sizeof(OpponentBoard));
+            playerCount = count;
+            for (int i = 0; i < count; ++i)
+            {
+                OpponentBoard *opponent = &opponents[i];
+                opponent->view.width = settings.width;
+                opponent->view.height = settings.height;
+                for (int y = 0; y < settings.height; ++y) memset(opponent->view.boardMask[y], 1, settings.width);
+                opponent->view.endTick = -1;       // Timer of the watched board runs with the match
+                ResetBoardSync(&opponent->sync, settings.width, settings.height);
+                opponent->valid = true;
+            }
+            if (player >= count) player = 0;
+
+            matchMode = mode;
+            winner = -1;
+            matchStartTime = time;
+            clientState = NET_CLIENT_PLAYING;
+            ++boardVersion;
+        } break;
+        case MSG_ACTION_RESULT:
+        {
+            unsigned int sequence = NetReadU32(payload);
+            bool accepted = (NetReadU8(payload) != 0);
+            NetReadU8(payload);
+            NetReadU16(payload);
+            int tick = (int)NetReadU32(payload);
+            if (payload->overflow || (pendingCount == 0) || (pending[pendingHead].sequence != sequence)) break;
+
+            GameAction action = pending[pendingHead].action;
+            pendingHead = (pendingHead + 1)%NET_CLIENT_MAX_PENDING;
+            --pendingCount;
+
+            // NOTE: The prediction applied every pending action, a refused one means it is wrong
+            bool predictedRight = accepted;
+            if (accepted)
+            {
+                action.tick = tick;
+                confirmed.tick = tick;
+                predictedRight = ApplyGameAction(&confirmed, action);
+            }
+            if (!predictedRight)
+            {
+                ++clientStats.mispredictions;
+                RollbackPrediction();
+            }
+        } break;
+        case MSG_BOARD_DELTA:
+        {
+            if (!ReadBoardDelta(&viewSync, &view, payload))
+            {
+                ++clientStats.syncErrors;
+                if (time - syncRequestTime >= NET_CLIENT_SYNC_RETRY_TIME)
+                {
+                    SendSyncRequest(player);
+                    syncRequestTime = time;
+                }
+                break;
+            }
+
+            // Results of every action the view shows came first, the confirmed board must match
+            if (viewSync.complete && !IsViewConfirmed())
+            {
+                ++clientStats.mispredictions;
+                AdoptServerView();
+                RollbackPrediction();
+            }
+        } break;
+        case MSG_OPPONENT_DELTA:
+        {
+            int board = (int)NetReadU8(payload);
+            if ((board >= playerCount) || (!spectating && (board == player))) break;
+
+            // NOTE: A wrong board keeps taking deltas, the checksum tells once its keyframe made it right
+            OpponentBoard *opponent = &opponents[board];
+            bool valid = ReadBoardDelta(&opponent->sync, &opponent->view, payload);
+            if (!valid)
+            {
+                ++clientStats.opponentSyncErrors;
+                if (opponent->valid) SendSyncRequest(board);
+            }
+            opponent->valid = valid;
+            if (spectating && (board == player)) ++boardVersion;
+        } break;
+        case MSG_PLAYER_STATUS:
+        {
+            int index = (int)NetReadU8(payload);
+            PlayerStatus status = (PlayerStatus)NetReadU8(payload);
+            if (!payload->overflow && (index < playerCount)) opponents[index].status = status;
+        } break;
+        case MSG_GARBAGE:
+        {
+            int board = (int)NetReadU8(payload);
+            GameAction action = { 0 };
+            action.tick = (int)NetReadU32(payload);
+            action.type = ACTION_GARBAGE;
+            action.x = (int)NetReadU8(payload);
+            action.y = (int)NetReadU8(payload);
+            if (payload->overflow || (board >= playerCount)) break;
+
+            // Own board: the confirmed board takes it as the server did (every result before it is
+            // applied), the prediction is rebuilt on top
+            if (!spectating && (board == player))
+            {
+                confirmed.tick = action.tick;
+                ApplyGameAction(&confirmed, action);
+                GrowReceivedBoard(&viewSync, &view, action.x);
+                RollbackPrediction();
+                break;
+            }
+            GrowReceivedBoard(&opponents[board].sync, &opponents[board].view, action.x);
+            if (spectating && (board == player)) ++boardVersion;
+        } break;
+        case MSG_LOCKSTEP_STEP: ApplyLockstepStep(payload); break;
+        case MSG_LOCKSTEP_DESYNC:
+        {
+            NetReadU32(payload);
+            ++clientStats.desyncs;
+        } break;
+        case MSG_MATCH_END:
+        {
+            int winnerIndex = (int)NetReadU8(payload);
+            winner = (winnerIndex == NET_NO_PLAYER)? -1 : winnerIndex;
+            clientState = NET_CLIENT_ENDED;
+        } break;
+        default: break;
+    }
+}
+
+internal bool OpenNetClient(const char *host, int port, bool spectator)
+{
+    CloseNetClient();
+    if (!InitNetwork()) return false;
+
+    clientSocket = ConnectSocket(host, port);
+    if (clientSocket == NET_INVALID_SOCKET)
+    {
+        CloseNetwork();
+        return false;
+    }
+
+    inputSize = 0;
+    outputSize = 0;
+    pendingHead = 0;
+    pendingCount = 0;
+    spectating = spectator;
+    player = spectator? 0 : -1;
+    winner = -1;
+    memset(&clientStats, 0, sizeof(clientStats));
+    memset(&predicted, 0, sizeof(predicted));
+    ++boardVersion;
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------
+// Network Client Functions Definition
+//----------------------------------------------------------------------------------
+bool ConnectNetClient(const char *host, int port, int rating, GameSettings board)
+{
+    if (!OpenNetClient(host, port, false)) return false;
+
+    NetWriter writer = BeginNetClientMessage(MSG_JOIN);
+    NetWriteU8(&writer, NET_PROTOCOL_VERSION);
+    NetWriteU16(&writer, (unsigned int)rating);
+    NetWriteGameSettings(&writer, board);
+    EndNetClientMessage(&writer);
+    clientState = NET_CLIENT_WAITING;
+    FlushNetClientOutput();
+
+    return (clientState != NET_CLIENT_OFFLINE);
+}
+
+bool SpectateNetClient(const char *host, int port, unsigned int match)
+{
+    if (!OpenNetClient(host, port, true)) return false;
+
+    NetWriter writer = BeginNetClientMessage(MSG_SPECTATE);
+    NetWriteU8(&writer, NET_PROTOCOL_VERSION);
+    NetWriteU32(&writer, match);
+    EndNetClientMessage(&writer);
+    clientState = NET_CLIENT_WAITING;
+    FlushNetClientOutput();
+
+    return (clientState != NET_CLIENT_OFFLINE);
+}
+
+void CloseNetClient(void)
+{
+    free(opponents);
+    opponents = NULL;
+    playerCount = 0;
+
+    if (clientSocket == NET_INVALID_SOCKET) return;
+
+    CloseSocket(clientSocket);
+    clientSocket = NET_INVALID_SOCKET;
+    clientState = NET_CLIENT_OFFLINE;
+    CloseNetwork();
+}
+
+void UpdateNetClient(double time)
+{
+    if (clientState == NET_CLIENT_PLAYING)
+    {
+        clientTick = (int)((time - matchStartTime)/SIM_TICK_TIME);
+        predicted.tick = clientTick;
+    }
+    if (clientSocket == NET_INVALID_SOCKET) return;
+
+    // Read everything that arrived, a frame can hold several results and deltas
+    for (;;)
+    {
+        int received = ReceiveSocket(clientSocket, input + inputSize, (int)sizeof(input) - inputSize);
+        if (received < 0)
+        {
+            CloseSocket(clientSocket);
+            clientSocket = NET_INVALID_SOCKET;
+            if (clientState != NET_CLIENT_ENDED) clientState = NET_CLIENT_OFFLINE;
+            return;
+        }
+        if (received == 0) break;
+        inputSize += received;
+
+        int offset = 0;
+        for (;;)
+        {
+            NetMessageType type = (NetMessageType)0;
+            NetReader payload = { 0 };
+            int size = ReadNetMessage(input + offset, inputSize - offset, &type, &payload);
+            if (size < 0)
+            {
+                CloseNetClient();
+                return;
+            }
+            if (size == 0) break;
+
+            HandleNetClientMessage(type, &payload, time);
+            offset += size;
+        }
+
+        memmove(input, input + offset, inputSize - offset);
+        inputSize -= offset;
+    }
+
+    if (clientState == NET_CLIENT_PLAYING) RetryOpponentRequests(time);
+    FlushNetClientOutput();
+}
+
+bool SendNetClientAction(GameAction action)
+{
+    if (spectating || (clientState != NET_CLIENT_PLAYING) || (pendingCount >= NET_CLIENT_MAX_PENDING)) return false;
+    if (outputSize + NET_MESSAGE_HEADER_SIZE + 7 > NET_CLIENT_OUTPUT_SIZE) return false;     // Server not reading
+
+    // Predicted right away, an action refused here would be refused by the server too
+    action.tick = clientTick;
+    if (!ApplyGameAction(&predicted, action)) return false;
+    ++boardVersion;
+
+    PendingAction *slot = &pending[(pendingHead + pendingCount)%NET_CLIENT_MAX_PENDING];
+    slot->sequence = nextSequence++;
+    slot->action = action;
+    ++pendingCount;
+
+    NetWriter writer = BeginNetClientMessage(MSG_ACTION);
+    NetWriteU32(&writer, slot->sequence);
+    NetWriteU8(&writer, (unsigned int)action.type);
+    NetWriteU8(&writer, (unsigned int)action.x);
+    NetWriteU8(&writer, (unsigned int)action.y);
+    EndNetClientMessage(&writer);
+    FlushNetClientOutput();
+    ++clientStats.actionsSent;
+
+    return true;
+}
+
+NetClientState GetNetClientState(void) { return clientState; }
+const GameState *GetNetClientGame(void) { return (spectating && (opponents != NULL))? &opponents[player].view : &predicted; }
+unsigned int GetNetClientBoardVersion(void) { return boardVersion; }
+int GetNetClientWinner(void) { return winner; }
+int GetNetClientPlayer(void) { return player; }
+NetClientStats GetNetClientStats(void) { return clientStats; }
+int GetNetClientPlayerCount(void) { return playerCount; }
+MatchMode GetNetClientMatchMode(void) { return matchMode; }
+bool IsNetClientSpectating(void) { return spectating; }
+
+void SetNetClientWatchedPlayer(int index)
+{
+    if (!spectating || (index < 0) || (index >= playerCount) || (index == player)) return;
+
+    // NOTE: The board watched until now goes back to the opponents, all of it is reported changed
+    opponents[player].sync.changed = { 0, 0, opponents[player].view.width, opponents[player].view.height };
+    player = index;
+    ++boardVersion;
+}
+
+const GameState *GetNetClientOpponent(int index, PlayerStatus *status)
+{
+    if ((index < 0) || (index >= playerCount) || (index == player)) return NULL;
+
+    if (status != NULL) *status = opponents[index].status;
+    return &opponents[index].view;
+}
+
+bool TakeNetClientOpponentChanges(int index, BoardRegion *region)
+{
+    if ((index < 0) || (index >= playerCount) || (index == player)) return false;
+
+    BoardRegion *changed = &opponents[index].sync.changed;
+    if (changed->minX >= changed->maxX) return false;
+
+    *region = *changed;
+    *changed = { 0, 0, 0, 0 };
+    return true;
+}
@@ -0,0 +1,86 @@
+/**********************************************************************************************
+*
+*   Minesweeper Clone - Network Client
+*
+*   Multiplayer side of the gameplay screen: joins a match server and plays the board it is
+*   given, polled from the main thread every frame.
+*
+*   The server sends the board seed with the match start, the client generates the same board
+*   and applies its own reveals, chords and flags right away on a predicted copy instead of
+*   waiting a round trip. Two more copies keep the prediction honest:
+*       confirmed   the seeded board with only the actions the server accepted, in its order
+*       view        the board as received in deltas (see board_sync.h)
+*   An action the server refuses rolls the prediction back: it is rebuilt from the confirmed
+*   board and the actions still unanswered. Each time the deltas bring the view up to date it
+*   is compared with the confirmed board, a mismatch adopts the view and rolls back too.
+*
+*   Opponent boards are only received, never predicted: each keeps the region its deltas
+*   changed until taken (TakeNetClientOpponentChanges()), to draw them without a full redraw.
+*   Garbage from the server (MSG_GARBAGE) grows a board by its new rows only: the confirmed
+*   board applies it like an accepted action, received boards get the same hidden rows.
+*
+*   In a lockstep match nothing is received but the inputs of each step: every board is
+*   generated from the match seed and runs them, the state hash reached is sent back for the
+*   server to check. The own board is still predicted, its inputs coming back confirm it.
+*
+*   A spectator receives every board of a match that way and plays none: the watched board
+*   (SetNetClientWatchedPlayer()) takes the place of the player board, the others are its
+*   opponents.
+*
+*   Copyright (c) 2024 (DoughnutDude)
+*
+**********************************************************************************************/
+
+#ifndef NET_CLIENT_H
+#define NET_CLIENT_H
+
+#include "game_core.h"
+#include "board_sync.h"     // Required for: BoardRegion, PlayerStatus
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define NET_CLIENT_MAX_PENDING      64      // Actions sent and not answered yet, more are not sent
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum NetClientState {
+    NET_CLIENT_OFFLINE = 0,     // Not connected, or disconnected
+    NET_CLIENT_WAITING,         // Joined, waiting for the match to start
+    NET_CLIENT_PLAYING,
+    NET_CLIENT_ENDED,           // Match over, see GetNetClientWinner()
+} NetClientState;
+
+typedef struct NetClientStats {
+    int actionsSent;
+    int mispredictions;         // Refused actions and confirmed boards differing from the view
+    int rollbacks;
+    int syncErrors;             // Deltas failing their checksum, a keyframe was asked for
+    int opponentSyncErrors;     // Same for opponent boards
+    int desyncs;                // Lockstep: the server had another state hash for a step (told once)
+} NetClientStats;
+
+//----------------------------------------------------------------------------------
+// Network Client Functions Declaration
+//----------------------------------------------------------------------------------
+bool ConnectNetClient(const char *host, int port, int rating, GameSettings board);   // Connect and queue for a match, host is an IPv4 address (board.width 0: the server board)
+bool SpectateNetClient(const char *host, int port, unsigned int match);    // Connect and watch a match (0 = the latest one)
+void CloseNetClient(void);
+void UpdateNetClient(double time);                      // Read server messages and reconcile, once per frame
+bool SendNetClientAction(GameAction action);            // Predict and send, false if refused locally (action.tick is ignored)
+
+NetClientState GetNetClientState(void);
+const GameState *GetNetClientGame(void);                // Predicted board, the watched one when spectating
+unsigned int GetNetClientBoardVersion(void);            // Changes every time the predicted board may have changed
+int GetNetClientWinner(void);                           // Winner player index once ended, -1 if nobody
+int GetNetClientPlayer(void);                           // Index of this player in the match, or of the watched one
+int GetNetClientPlayerCount(void);                      // Players of the match, 0 before it starts
+MatchMode GetNetClientMatchMode(void);
+bool IsNetClientSpectating(void);
+void SetNetClientWatchedPlayer(int player);             // Spectator: board returned by GetNetClientGame()
+const GameState *GetNetClientOpponent(int player, PlayerStatus *status);   // Board as received, NULL for this player
+bool TakeNetClientOpponentChanges(int player, BoardRegion *region);        // Tiles changed since the last call, false if none
+NetClientStats GetNetClientStats(void);
+
+#endif // NET_CLIENT_H
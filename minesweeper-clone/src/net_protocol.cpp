@@ -0,0 +1,129 @@
+/**********************************************************************************************
+*
+*   Minesweeper Clone - Network Protocol
+*
+*   Message framing and little-endian encoding.
+*
+*   Copyright (c) 2024 (DoughnutDude)
+*
+**********************************************************************************************/
+
+#include "net_protocol.h"
+
+#define internal static
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions Definition
+//----------------------------------------------------------------------------------
+internal void NetWriteBytes(NetWriter *writer, unsigned int value, int count)
+{
+    if (writer->overflow || (writer->size + count > writer->capacity))
+    {
+        writer->overflow = true;
+        return;
+    }
+
+    for (int i = 0; i < count; ++i) writer->data[writer->size++] = (unsigned char)(value >> (8*i));
+}
+
+internal unsigned int NetReadBytes(NetReader *reader, int count)
+{
+    if (reader->overflow || (reader->position + count > reader->size))
+    {
+        reader->overflow = true;
+        return 0;
+    }
+
+    unsigned int value = 0;
+    for (int i = 0; i < count; ++i) value |= (unsigned int)reader->data[reader->position++] << (8*i);
+    return value;
+}
+
+//----------------------------------------------------------------------------------
+// Network Protocol Functions Definition
+//----------------------------------------------------------------------------------
+void BeginNetMessage(NetWriter *writer, NetMessageType type)
+{
+    writer->messageStart = writer->size;
+    writer->overflow = false;
+    NetWriteBytes(writer, 0, 2);
+    NetWriteBytes(writer, (unsigned int)type, 1);
+}
+
+bool EndNetMessage(NetWriter *writer)
+{
+    int payloadSize = writer->size - writer->messageStart - NET_MESSAGE_HEADER_SIZE;
+    if (writer->overflow || (payloadSize > NET_MAX_MESSAGE_SIZE))
+    {
+        writer->size = writer->messageStart;
+        return false;
+    }
+
+    writer->data[writer->messageStart] = (unsigned char)payloadSize;
+    writer->data[writer->messageStart + 1] = (unsigned char)(payloadSize >> 8);
+    return true;
+}
+
+void NetWriteU8(NetWriter *writer, unsigned int value) { NetWriteBytes(writer, value, 1); }
+void NetWriteU16(NetWriter *writer, unsigned int value) { NetWriteBytes(writer, value, 2); }
+void NetWriteU32(NetWriter *writer, unsigned int value) { NetWriteBytes(writer, value, 4); }
+
+// u8 width, u8 height, u8 mine density, u16 mines desired, u8 mine generation mode, u8 starting hp
+void NetWriteGameSettings(NetWriter *writer, GameSettings settings)
+{
+    NetWriteU8(writer, (unsigned int)settings.width);
+    NetWriteU8(writer, (unsigned int)settings.height);
+    NetWriteU8(writer, (unsigned int)settings.mineDensity);
+    NetWriteU16(writer, (unsigned int)settings.minesDesired);
+    NetWriteU8(writer, settings.mineGenMode? 1 : 0);
+    NetWriteU8(writer, (unsigned int)settings.startingHP);
+}
+
+int ReadNetMessage(const unsigned char *data, int size, NetMessageType *type, NetReader *payload)
+{
+    if (size < NET_MESSAGE_HEADER_SIZE) return 0;
+
+    int payloadSize = (int)data[0] | ((int)data[1] << 8);
+    if (payloadSize > NET_MAX_MESSAGE_SIZE) return -1;
+    if (size < NET_MESSAGE_HEADER_SIZE + payloadSize) return 0;
+
+    *type = (NetMessageType)data[2];
+    payload->data = data + NET_MESSAGE_HEADER_SIZE;
+    payload->size = payloadSize;
+    payload->position = 0;
+    payload->overflow = false;
+
+    return NET_MESSAGE_HEADER_SIZE + payloadSize;
+}
+
+unsigned int NetReadU8(NetReader *reader) { return NetReadBytes(reader, 1); }
+unsigned int NetReadU16(NetReader *reader) { return NetReadBytes(reader, 2); }
+unsigned int NetReadU32(NetReader *reader) { return NetReadBytes(reader, 4); }
+
+GameSettings NetReadGameSettings(NetReader *reader)
+{
+    GameSettings settings = { 0 };
+    settings.width = (int)NetReadU8(reader);
+    settings.height = (int)NetReadU8(reader);
+    settings.mineDensity = (int)NetReadU8(reader);
+    settings.minesDesired = (int)NetReadU16(reader);
+    settings.mineGenMode = (NetReadU8(reader) != 0);
+    settings.startingHP = (int)NetReadU8(reader);
+
+    return settings;
+}
+
+// NOTE: Same derivation on the server and every client, each board of a match is its own
+unsigned int GetMatchBoardSeed(unsigned int matchSeed, int player)
+{
+    return matchSeed ^ ((unsigned int)player*2654435761u);
+}
+
+// FNV-1a 32-bit over the board hashes, folded to 32 bits each
+unsigned int GetLockstepHash(const unsigned long long *boardHashes, int count)
+{
+    unsigned int hash = 2166136261u;
+    for (int i = 0; i < count; ++i) hash = (hash ^ (unsigned int)(boardHashes[i] ^ (boardHashes[i] >> 32)))*16777619u;
+
+    return hash;
+}
@@ -0,0 +1,126 @@
+/**********************************************************************************************
+*
+*   Minesweeper Clone - Network Protocol
+*
+*   Messages between the match server and its clients, over TCP.
+*   Every message (little-endian): u16 payload size, u8 type, payload
+*
+*   Client -> server
+*       MSG_JOIN            u8 protocol version, u16 rating, settings of the board asked for (width 0: the server
+*                           one), players are matched with others asking for the same board and close in rating
+*       MSG_ACTION          u32 sequence, u8 action type, u8 x, u8 y
+*       MSG_SYNC_REQUEST    u8 player index of the board, checksum mismatch, asks for a keyframe of it
+*                           (spectators start again from the latest match keyframe)
+*       MSG_SPECTATE        u8 protocol version, u32 match id (0 = latest match), watch instead of joining
+*       MSG_LOCKSTEP_HASH   u32 step, u32 state hash once the step applied (see GetLockstepHash())
+*   Server -> client
+*       MSG_MATCH_START     u32 match id, u8 player index, u8 player count, settings (see NetWriteGameSettings()),
+*                           u32 board seed (the client generates the same board to predict its actions), u8 match mode
+*                           (a race board is opened with OpenGame() on both sides, no keyframe follows; a lockstep
+*                           match sends the match seed, boards are seeded with GetMatchBoardSeed())
+*       MSG_ACTION_RESULT   u32 sequence, u8 accepted, u8 hp, u16 hidden safe tiles, u32 tick
+*       MSG_PLAYER_STATUS   u8 player index, u8 status, u16 hidden safe tiles
+*       MSG_MATCH_END       u8 winner player index (NET_NO_PLAYER if nobody cleared their board)
+*       MSG_BOARD_DELTA     changes to the player board (see board_sync.h)
+*       MSG_OPPONENT_DELTA  u8 player index, then changes to the board of that opponent as in MSG_BOARD_DELTA
+*       MSG_SPECTATE_START  u32 match id, u8 player count, settings, u8 match mode: a spectator keyframe
+*                           starts, every player status and board keyframe (as MSG_OPPONENT_DELTA) follow
+*       MSG_LOCKSTEP_STEP   u32 step, u8 input count, per input u8 player index, u8 action type, u8 x, u8 y:
+*                           sent every step whatever the inputs, they apply on tick step*NET_LOCKSTEP_STEP_TICKS
+*       MSG_LOCKSTEP_DESYNC u32 step the state hash of this client differed from the server on
+*       MSG_GARBAGE         u8 player index, u32 tick, u8 rows, u8 mines: ACTION_GARBAGE applied to that board, sent
+*                           before any delta written after it, received copies get the same hidden rows (lockstep
+*                           players get it as an input of the step instead)
+*
+*   Copyright (c) 2024 (DoughnutDude)
+*
+**********************************************************************************************/
+
+#ifndef NET_PROTOCOL_H
+#define NET_PROTOCOL_H
+
+#include "game_core.h"
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define NET_PROTOCOL_VERSION        9
+#define NET_MESSAGE_HEADER_SIZE     3
+#define NET_MAX_MESSAGE_SIZE        1024    // Largest payload accepted
+#define NET_NO_PLAYER               255
+#define NET_DEFAULT_RATING          1000    // Rating of players who have none
+#define NET_LOCKSTEP_STEP_TICKS     6       // Simulation ticks per lockstep step (20 steps per second)
+#define NET_LOCKSTEP_MAX_INPUTS     250     // Inputs per step (one message), more are dropped
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum NetMessageType {
+    MSG_JOIN = 1,
+    MSG_ACTION,
+    MSG_SYNC_REQUEST,
+    MSG_SPECTATE,
+    MSG_LOCKSTEP_HASH,
+    MSG_MATCH_START = 16,
+    MSG_ACTION_RESULT,
+    MSG_PLAYER_STATUS,
+    MSG_MATCH_END,
+    MSG_BOARD_DELTA,
+    MSG_OPPONENT_DELTA,
+    MSG_SPECTATE_START,
+    MSG_LOCKSTEP_STEP,
+    MSG_LOCKSTEP_DESYNC,
+    MSG_GARBAGE,
+} NetMessageType;
+
+typedef enum MatchMode {
+    MATCH_MODE_OWN_BOARDS = 0,      // A board per player, the match lasts until every board is over
+    MATCH_MODE_RACE,                // Same board for every player, the first to clear it wins and ends the match
+    MATCH_MODE_LOCKSTEP,            // A board per player, every client runs all of them from the inputs of each step
+} MatchMode;
+
+typedef enum PlayerStatus {
+    PLAYER_STATUS_PLAYING = 0,
+    PLAYER_STATUS_WON,              // Board cleared
+    PLAYER_STATUS_LOST,             // Out of hp
+    PLAYER_STATUS_LEFT,             // Disconnected before the end of its board
+} PlayerStatus;
+
+// Messages are appended to a caller buffer, overflow is sticky and the buffer left as is
+typedef struct NetWriter {
+    unsigned char *data;
+    int capacity;
+    int size;
+    int messageStart;       // Header offset of the message being written
+    bool overflow;
+} NetWriter;
+
+// Reads past the payload return 0 and set overflow
+typedef struct NetReader {
+    const unsigned char *data;
+    int size;
+    int position;
+    bool overflow;
+} NetReader;
+
+//----------------------------------------------------------------------------------
+// Network Protocol Functions Declaration
+//----------------------------------------------------------------------------------
+void BeginNetMessage(NetWriter *writer, NetMessageType type);
+bool EndNetMessage(NetWriter *writer);      // Patch the payload size, false if the message did not fit (it is removed)
+void NetWriteU8(NetWriter *writer, unsigned int value);
+void NetWriteU16(NetWriter *writer, unsigned int value);
+void NetWriteU32(NetWriter *writer, unsigned int value);
+void NetWriteGameSettings(NetWriter *writer, GameSettings settings);
+
+// Find the first complete message of received data, returns bytes it takes (0 if incomplete, -1 if invalid)
+int ReadNetMessage(const unsigned char *data, int size, NetMessageType *type, NetReader *payload);
+unsigned int NetReadU8(NetReader *reader);
+unsigned int NetReadU16(NetReader *reader);
+unsigned int NetReadU32(NetReader *reader);
+GameSettings NetReadGameSettings(NetReader *reader);
+
+unsigned int GetMatchBoardSeed(unsigned int matchSeed, int player);     // Seed of a player board in a match of boards per player
+unsigned int GetLockstepHash(const unsigned long long *boardHashes, int count);     // Match state of a lockstep step, GetGameStateHash() of every board in player order
+
+#endif // NET_PROTOCOL_H
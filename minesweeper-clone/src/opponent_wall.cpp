@@ -0,0 +1,163 @@
+/**********************************************************************************************
+*
+*   Minesweeper Clone - Opponent Wall
+*
+*   Opponent boards as one texel per tile, updated from received deltas.
+*
+*   Copyright (c) 2024 (DoughnutDude)
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "opponent_wall.h"
+#include "net_client.h"
+#include "profiler.h"
+
+#include <math.h>           // Required for: ceilf(), floorf(), sqrtf()
+
+#define internal static
+#define global_var static
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+// NOTE: Board colors, revealed clues are the revealed gray tinted by their digit color
+global_var const Color tileColors[TILE_CODE_FLAGGED + 1] = {
+    { 120,120,120,255 },    // 0
+    { 100,100,200,255 },    // 1
+    { 80,130,80,255 },      // 2
+    { 190,80,80,255 },      // 3
+    { 70,70,150,255 },      // 4
+    { 130,70,60,255 },      // 5
+    { 60,120,120,255 },     // 6
+    { 60,60,60,255 },       // 7
+    { 95,95,95,255 },       // 8
+    { 20,20,20,255 },       // Mine
+    { 76,63,47,255 },       // Clicked mine (DARKBROWN)
+    { 110,80,60,255 },      // Wrong flag
+    { 170,170,170,255 },    // Hidden
+    { 127,106,79,255 },     // Flagged (BROWN)
+};
+
+// NOTE: Cells are maxBoardHeight tall, a board grown by garbage rows only uploads the new ones
+global_var Texture2D atlas = { 0 };         // Every player board, own one unused, atlasColumns boards per row
+global_var int atlasColumns = 0;
+global_var int cellWidth = 0;               // Board width, same for every player of a match
+global_var int cellCount = 0;
+global_var Color pixels[maxBoardWidth*maxBoardHeight];      // Changed region of a board being uploaded
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions Definition
+//----------------------------------------------------------------------------------
+// Opponents first to first + count (this player not counted) in a grid filling area, laid out for
+// boards cellRows tall (the tallest one)
+internal void DrawWallBoards(Rectangle area, int first, int count, int cellRows)
+{
+    if (count <= 0) return;
+
+    // Columns giving the biggest boards, whole texels once they are at least a pixel
+    float scale = 0.0f;
+    int columns = 1;
+    for (int i = 1; i <= count; ++i)
+    {
+        int rows = (count + i - 1)/i;
+        float scaleX = (area.width - i*OPPONENT_WALL_GAP)/(i*cellWidth);
+        float scaleY = (area.height - rows*OPPONENT_WALL_GAP)/(rows*cellRows);
+        float fit = (scaleX < scaleY)? scaleX : scaleY;
+        if (fit > scale)
+        {
+            scale = fit;
+            columns = i;
+        }
+    }
+    if (scale <= 0.0f) return;
+    if (scale >= 1.0f) scale = floorf(scale);
+
+    int player = GetNetClientPlayer();
+    float boardWidth = cellWidth*scale;
+    float boardHeight = cellRows*scale;
+    for (int i = 0; i < count; ++i)
+    {
+        int index = (first + i < player)? first + i : first + i + 1;
+        PlayerStatus status = PLAYER_STATUS_PLAYING;
+        const GameState *board = GetNetClientOpponent(index, &status);
+        int rows = (board != NULL)? board->height : cellRows;
+
+        Rectangle source = { (float)((index%atlasColumns)*cellWidth), (float)((index/atlasColumns)*maxBoardHeight), (float)cellWidth, (float)rows };
+        Rectangle dest = { area.x + (i%columns)*(boardWidth + OPPONENT_WALL_GAP), area.y + (i/columns)*(boardHeight + OPPONENT_WALL_GAP),
+                           boardWidth, rows*scale };
+        bool out = (status == PLAYER_STATUS_LOST) || (status == PLAYER_STATUS_LEFT);
+        DrawTexturePro(atlas, source, dest, { 0, 0 }, 0.0f, out? Color{ 90,90,90,255 } : WHITE);
+        if (status == PLAYER_STATUS_WON) DrawRectangleLinesEx(dest, 1.0f, GOLD);
+    }
+}
+
+//----------------------------------------------------------------------------------
+// Opponent Wall Functions Definition
+//----------------------------------------------------------------------------------
+void UpdateOpponentWall(void)
+{
+    PROFILE_FUNCTION();
+
+    int count = GetNetClientPlayerCount();
+    const GameState *any = GetNetClientOpponent((GetNetClientPlayer() == 0)? 1 : 0, NULL);
+    if (any == NULL) return;    // No match, or nobody else in it
+
+    // NOTE: A new match resets every board, all of them are reported changed and uploaded below
+    if (!IsTextureReady(atlas) || (cellWidth != any->width) || (cellCount != count))
+    {
+        if (IsTextureReady(atlas)) UnloadTexture(atlas);
+
+        cellWidth = any->width;
+        cellCount = count;
+        atlasColumns = (int)ceilf(sqrtf((float)count));
+        int rows = (count + atlasColumns - 1)/atlasColumns;
+
+        Image image = GenImageColor(atlasColumns*cellWidth, rows*maxBoardHeight, tileColors[TILE_CODE_HIDDEN]);
+        atlas = LoadTextureFromImage(image);
+        UnloadImage(image);
+    }
+
+    for (int i = 0; i < count; ++i)
+    {
+        BoardRegion region = { 0 };
+        if (!TakeNetClientOpponentChanges(i, &region)) continue;
+
+        const GameState *board = GetNetClientOpponent(i, NULL);
+        int width = region.maxX - region.minX;
+        int height = region.maxY - region.minY;
+        for (int y = 0; y < height; ++y)
+        {
+            for (int x = 0; x < width; ++x) pixels[y*width + x] = tileColors[GetTileCode(board, region.minX + x, region.minY + y)];
+        }
+
+        Rectangle rec = { (float)((i%atlasColumns)*cellWidth + region.minX), (float)((i/atlasColumns)*maxBoardHeight + region.minY), (float)width, (float)height };
+        UpdateTextureRec(atlas, rec, pixels);
+    }
+}
+
+void DrawOpponentWall(Rectangle left, Rectangle right)
+{
+    PROFILE_FUNCTION();
+
+    if (!IsTextureReady(atlas)) return;
+
+    int cellRows = 1;
+    for (int i = 0; i < cellCount; ++i)
+    {
+        const GameState *board = GetNetClientOpponent(i, NULL);
+        if ((board != NULL) && (board->height > cellRows)) cellRows = board->height;
+    }
+
+    int opponentCount = cellCount - 1;
+    int leftCount = (opponentCount + 1)/2;
+    DrawWallBoards(left, 0, leftCount, cellRows);
+    DrawWallBoards(right, leftCount, opponentCount - leftCount, cellRows);
+}
+
+void UnloadOpponentWall(void)
+{
+    if (IsTextureReady(atlas)) UnloadTexture(atlas);
+    atlas = { 0 };
+    cellCount = 0;
+}
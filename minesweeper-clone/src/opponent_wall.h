@@ -0,0 +1,31 @@
+/**********************************************************************************************
+*
+*   Minesweeper Clone - Opponent Wall
+*
+*   Live boards of every opponent of a multiplayer match, drawn small around the player board.
+*   Each board is one texel per tile in a shared atlas texture, so the wall is one textured
+*   quad per opponent in a single batch however big the boards are. Texels are only uploaded
+*   for the tiles the received deltas changed (see TakeNetClientOpponentChanges()).
+*
+*   Copyright (c) 2024 (DoughnutDude)
+*
+**********************************************************************************************/
+
+#ifndef OPPONENT_WALL_H
+#define OPPONENT_WALL_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define OPPONENT_WALL_GAP       2       // Pixels between two boards on screen
+
+//----------------------------------------------------------------------------------
+// Opponent Wall Functions Declaration
+//----------------------------------------------------------------------------------
+void UpdateOpponentWall(void);                          // Upload changed tiles, once per frame before drawing
+void DrawOpponentWall(Rectangle left, Rectangle right); // Half of the opponents on each side, boards scaled to fit
+void UnloadOpponentWall(void);
+
+#endif // OPPONENT_WALL_H
@@ -0,0 +1,133 @@
+/**********************************************************************************************
+*
+*   Minesweeper Clone - Performance Overlay
+*
+*   Frame time graph and histogram plus rlgl render statistics (draw calls, vertices,
+*   batch flushes, texture switches) of the previous frames.
+*   Recording a frame is a few additions, text is only reformatted a few times per second.
+*
+*   Copyright (c) 2024 (DoughnutDude)
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "perf_overlay.h"
+
+#include <stdio.h>          // Required for: snprintf()
+
+#define internal static
+#define global_var static
+
+#define PERF_GRAPH_HEIGHT       50
+#define PERF_GRAPH_MAX_MS       50.0f       // Frame time at the top of the graph
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+global_var float frameTimes[PERF_FRAME_HISTORY] = { 0 };        // Milliseconds
+global_var int frameHistogramBucket[PERF_FRAME_HISTORY] = { 0 };
+global_var int framesHead = 0;
+global_var int framesCount = 0;
+
+global_var const float bucketLimits[PERF_HISTOGRAM_BUCKETS - 1] = { 4.0f, 8.0f, 12.0f, 16.7f, 20.0f, 25.0f, 33.4f, 50.0f, 100.0f };
+global_var const char *bucketNames[PERF_HISTOGRAM_BUCKETS] = { "<4", "<8", "<12", "<17", "<20", "<25", "<33", "<50", "<100", "100+" };
+global_var int histogram[PERF_HISTOGRAM_BUCKETS] = { 0 };
+
+// Sums since the last text refresh
+global_var int windowFrames = 0;
+global_var float windowTime = 0.0f;
+global_var float windowMaxFrameTime = 0.0f;
+global_var float windowWorkTime = 0.0f;
+global_var rlRenderStats windowStats = { 0 };
+
+global_var char textLines[4][96] = { 0 };
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions Definition
+//----------------------------------------------------------------------------------
+internal int GetHistogramBucket(float milliseconds)
+{
+    int bucket = 0;
+    while ((bucket < PERF_HISTOGRAM_BUCKETS - 1) && (milliseconds >= bucketLimits[bucket])) ++bucket;
+    return bucket;
+}
+
+internal void UpdatePerfText(void)
+{
+    float frames = (float)windowFrames;
+    snprintf(textLines[0], sizeof(textLines[0]), "%.0f fps  frame %.2f ms avg, %.2f max", frames/windowTime, 1000.0f*windowTime/frames, windowMaxFrameTime);
+    snprintf(textLines[1], sizeof(textLines[1]), "work %.2f ms avg (before EndDrawing)", 1000.0f*windowWorkTime/frames);
+    snprintf(textLines[2], sizeof(textLines[2]), "draw calls %.1f  vertices %.0f", windowStats.drawCalls/frames, windowStats.vertices/frames);
+    snprintf(textLines[3], sizeof(textLines[3]), "batch flushes %.1f  texture switches %.1f", windowStats.batchFlushes/frames, windowStats.textureSwitches/frames);
+
+    windowFrames = 0;
+    windowTime = 0.0f;
+    windowMaxFrameTime = 0.0f;
+    windowWorkTime = 0.0f;
+    windowStats = { 0 };
+}
+
+//----------------------------------------------------------------------------------
+// Performance Overlay Functions Definition
+//----------------------------------------------------------------------------------
+void RecordPerfFrame(float frameTime, float workTime, rlRenderStats stats)
+{
+    float milliseconds = frameTime*1000.0f;
+    int bucket = GetHistogramBucket(milliseconds);
+
+    if (framesCount == PERF_FRAME_HISTORY) --histogram[frameHistogramBucket[framesHead]];
+    else ++framesCount;
+    frameTimes[framesHead] = milliseconds;
+    frameHistogramBucket[framesHead] = bucket;
+    ++histogram[bucket];
+    framesHead = (framesHead + 1)%PERF_FRAME_HISTORY;
+
+    ++windowFrames;
+    windowTime += frameTime;
+    windowWorkTime += workTime;
+    if (milliseconds > windowMaxFrameTime) windowMaxFrameTime = milliseconds;
+    windowStats.drawCalls += stats.drawCalls;
+    windowStats.vertices += stats.vertices;
+    windowStats.batchFlushes += stats.batchFlushes;
+    windowStats.textureSwitches += stats.textureSwitches;
+
+    if (windowTime >= PERF_TEXT_UPDATE_TIME) UpdatePerfText();
+}
+
+void DrawPerfOverlay(int posX, int posY)
+{
+    int width = PERF_FRAME_HISTORY + 20;
+    int graphY = posY + 4 + 4*14 + 4;
+    int histogramY = graphY + PERF_GRAPH_HEIGHT + 8;
+    DrawRectangle(posX, posY, width, histogramY + PERF_GRAPH_HEIGHT + 18 - posY, Fade(BLACK, 0.7f));
+
+    for (int i = 0; i < 4; ++i) DrawText(textLines[i], posX + 6, posY + 4 + i*14, 10, RAYWHITE);
+
+    // Frame time graph, oldest frame on the left, line at 60 fps
+    int graphX = posX + 10;
+    for (int i = 0; i < framesCount; ++i)
+    {
+        float milliseconds = frameTimes[(framesHead - framesCount + i + PERF_FRAME_HISTORY)%PERF_FRAME_HISTORY];
+        int height = (int)(milliseconds/PERF_GRAPH_MAX_MS*PERF_GRAPH_HEIGHT);
+        if (height > PERF_GRAPH_HEIGHT) height = PERF_GRAPH_HEIGHT;
+        if (height < 1) height = 1;
+
+        Color color = (milliseconds <= 16.7f)? LIME : ((milliseconds <= 33.4f)? YELLOW : RED);
+        DrawRectangle(graphX + i, graphY + PERF_GRAPH_HEIGHT - height, 1, height, color);
+    }
+    int referenceY = graphY + PERF_GRAPH_HEIGHT - (int)(16.7f/PERF_GRAPH_MAX_MS*PERF_GRAPH_HEIGHT);
+    DrawRectangle(graphX, referenceY, PERF_FRAME_HISTORY, 1, Fade(RAYWHITE, 0.5f));
+
+    // Frame time histogram (milliseconds)
+    int maxCount = 1;
+    for (int i = 0; i < PERF_HISTOGRAM_BUCKETS; ++i) if (histogram[i] > maxCount) maxCount = histogram[i];
+
+    int barWidth = PERF_FRAME_HISTORY/PERF_HISTOGRAM_BUCKETS;
+    for (int i = 0; i < PERF_HISTOGRAM_BUCKETS; ++i)
+    {
+        int height = histogram[i]*PERF_GRAPH_HEIGHT/maxCount;
+        Color color = (i <= 3)? LIME : ((i <= 6)? YELLOW : RED);
+        DrawRectangle(graphX + i*barWidth, histogramY + PERF_GRAPH_HEIGHT - height, barWidth - 2, height, color);
+        DrawText(bucketNames[i], graphX + i*barWidth, histogramY + PERF_GRAPH_HEIGHT + 4, 10, RAYWHITE);
+    }
+}
@@ -0,0 +1,33 @@
+/**********************************************************************************************
+*
+*   Minesweeper Clone - Performance Overlay
+*
+*   Frame time graph and histogram plus rlgl render statistics (draw calls, vertices,
+*   batch flushes, texture switches) of the previous frames.
+*   Recording a frame is a few additions, text is only reformatted a few times per second.
+*
+*   Copyright (c) 2024 (DoughnutDude)
+*
+**********************************************************************************************/
+
+#ifndef PERF_OVERLAY_H
+#define PERF_OVERLAY_H
+
+#include "rlgl.h"           // Required for: rlRenderStats
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define PERF_FRAME_HISTORY          240     // Frames shown in the graph and counted in the histogram
+#define PERF_HISTOGRAM_BUCKETS      10
+#define PERF_TEXT_UPDATE_TIME       0.5     // Seconds between overlay text refreshes
+
+//----------------------------------------------------------------------------------
+// Performance Overlay Functions Declaration
+//----------------------------------------------------------------------------------
+// Record a finished frame: full frame time, time spent before EndDrawing() and render stats
+// NOTE: Take stats with rlGetRenderStats() before drawing the overlay so it does not count itself
+void RecordPerfFrame(float frameTime, float workTime, rlRenderStats stats);
+void DrawPerfOverlay(int posX, int posY);
+
+#endif // PERF_OVERLAY_H
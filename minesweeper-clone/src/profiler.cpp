@@ -0,0 +1,142 @@
+/**********************************************************************************************
+*
+*   Minesweeper Clone - Profiler
+*
+*   Scoped timers recorded into a ring buffer of events, exported as Chrome trace_event JSON
+*   (open in chrome://tracing, Perfetto or Speedscope) to inspect frame spikes.
+*
+*   Copyright (c) 2024 (DoughnutDude)
+*
+**********************************************************************************************/
+
+#include "profiler.h"
+
+#if defined(PROFILER_ENABLED)
+
+#include <stdio.h>          // Required for: FILE, fopen(), fprintf(), fclose()
+
+#include <atomic>
+#include <chrono>
+
+#define internal static
+#define global_var static
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct ProfileEvent {
+    const char *name;
+    long long start;        // Nanoseconds since profiler start
+    long long duration;     // Nanoseconds, -1 for instant events
+    int threadId;
+} ProfileEvent;
+
+typedef struct OpenProfileEvent {
+    const char *name;
+    long long start;
+} OpenProfileEvent;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+global_var ProfileEvent events[PROFILER_MAX_EVENTS] = { 0 };
+global_var std::atomic<unsigned long long> eventCounter(0);     // Events recorded since startup, next slot = counter%PROFILER_MAX_EVENTS
+global_var std::atomic<int> threadCounter(0);
+
+global_var const std::chrono::steady_clock::time_point profilerStart = std::chrono::steady_clock::now();
+
+// Per thread stack of events begun and not ended yet
+global_var thread_local OpenProfileEvent openEvents[PROFILER_MAX_DEPTH];
+global_var thread_local int openCount = 0;
+global_var thread_local int threadId = -1;
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions Definition
+//----------------------------------------------------------------------------------
+internal long long GetProfileTime(void)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - profilerStart).count();
+}
+
+internal void RecordProfileEvent(const char *name, long long start, long long duration)
+{
+    if (threadId < 0) threadId = threadCounter++;
+
+    // NOTE: Lock-free, every thread claims its own slot. An export running at the same time as
+    // other threads record may see an event being written, it is a debugging tool only
+    ProfileEvent *event = &events[eventCounter++%PROFILER_MAX_EVENTS];
+    event->name = name;
+    event->start = start;
+    event->duration = duration;
+    event->threadId = threadId;
+}
+
+//----------------------------------------------------------------------------------
+// Profiler Functions Definition
+//----------------------------------------------------------------------------------
+void BeginProfileEvent(const char *name)
+{
+    if (openCount < PROFILER_MAX_DEPTH)
+    {
+        openEvents[openCount].name = name;
+        openEvents[openCount].start = GetProfileTime();
+    }
+    ++openCount;
+}
+
+void EndProfileEvent(void)
+{
+    if (openCount <= 0) return;
+
+    --openCount;
+    if (openCount < PROFILER_MAX_DEPTH)
+    {
+        long long start = openEvents[openCount].start;
+        RecordProfileEvent(openEvents[openCount].name, start, GetProfileTime() - start);
+    }
+}
+
+void MarkProfileEvent(const char *name, double secondsAgo)
+{
+    RecordProfileEvent(name, GetProfileTime() - (long long)(secondsAgo*1000000000.0), -1);
+}
+
+void ProfileRenderBatchCallback(bool begin)
+{
+    if (begin) BeginProfileEvent("rlDrawRenderBatch");
+    else EndProfileEvent();
+}
+
+bool ExportProfileTrace(const char *fileName)
+{
+    FILE *file = fopen(fileName, "wt");
+    if (file == NULL) return false;
+
+    unsigned long long last = eventCounter;
+    unsigned long long first = (last > PROFILER_MAX_EVENTS)? last - PROFILER_MAX_EVENTS : 0;
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    for (unsigned long long i = first; i < last; ++i)
+    {
+        const ProfileEvent *event = &events[i%PROFILER_MAX_EVENTS];
+        const char *separator = (i + 1 < last)? "," : "";
+
+        // Timestamps in microseconds
+        if (event->duration >= 0)
+        {
+            fprintf(file, "{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%i}%s\n",
+                    event->name, event->start/1000.0, event->duration/1000.0, event->threadId, separator);
+        }
+        else
+        {
+            fprintf(file, "{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,\"pid\":1,\"tid\":%i}%s\n",
+                    event->name, event->start/1000.0, event->threadId, separator);
+        }
+    }
+    fprintf(file, "]}\n");
+
+    fclose(file);
+    return true;
+}
+
+#endif // PROFILER_ENABLED
@@ -0,0 +1,62 @@
+/**********************************************************************************************
+*
+*   Minesweeper Clone - Profiler
+*
+*   Scoped timers recorded into a ring buffer of events, exported as Chrome trace_event JSON
+*   (open in chrome://tracing, Perfetto or Speedscope) to inspect frame spikes.
+*   Compiled in for debug builds only (_DEBUG), define ENABLE_PROFILER to force it in release
+*   or DISABLE_PROFILER to remove it from debug. When disabled every macro compiles to nothing.
+*
+*   Copyright (c) 2024 (DoughnutDude)
+*
+**********************************************************************************************/
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#if (defined(_DEBUG) && !defined(DISABLE_PROFILER)) || defined(ENABLE_PROFILER)
+    #define PROFILER_ENABLED
+#endif
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define PROFILER_MAX_EVENTS     65536       // Ring buffer size, oldest events are overwritten (~30s of frames)
+#define PROFILER_MAX_DEPTH      64          // Maximum nested scopes per thread
+#define PROFILER_TRACE_FILE     "profile_trace.json"
+
+#if defined(PROFILER_ENABLED)
+    #define PROFILE_CONCAT_(a, b)   a##b
+    #define PROFILE_CONCAT(a, b)    PROFILE_CONCAT_(a, b)
+
+    #define PROFILE_SCOPE(name)     ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)   // Time until the end of the current scope
+    #define PROFILE_FUNCTION()      PROFILE_SCOPE(__FUNCTION__)
+    #define PROFILE_BEGIN(name)     BeginProfileEvent(name)
+    #define PROFILE_END()           EndProfileEvent()
+    #define PROFILE_MARK(name, secondsAgo) MarkProfileEvent(name, secondsAgo)
+#else
+    #define PROFILE_SCOPE(name)
+    #define PROFILE_FUNCTION()
+    #define PROFILE_BEGIN(name)
+    #define PROFILE_END()
+    #define PROFILE_MARK(name, secondsAgo)
+#endif
+
+#if defined(PROFILER_ENABLED)
+//----------------------------------------------------------------------------------
+// Profiler Functions Declaration
+//----------------------------------------------------------------------------------
+// NOTE: Names must be string literals (or outlive the profiler), only the pointer is recorded
+void BeginProfileEvent(const char *name);
+void EndProfileEvent(void);                                 // End the innermost event begun on this thread
+void MarkProfileEvent(const char *name, double secondsAgo); // Instant event that happened secondsAgo
+void ProfileRenderBatchCallback(bool begin);                // For rlSetDrawRenderBatchCallback()
+bool ExportProfileTrace(const char *fileName);              // Write every event in the ring buffer as Chrome trace JSON
+
+struct ProfileScope {
+    ProfileScope(const char *name) { BeginProfileEvent(name); }
+    ~ProfileScope() { EndProfileEvent(); }
+};
+#endif
+
+#endif // PROFILER_H
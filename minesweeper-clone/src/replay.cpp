@@ -0,0 +1,280 @@
+/**********************************************************************************************
+*
+*   Minesweeper Clone - Replays
+*
+*   A replay is the seed and settings of a game plus every action it applied. Replays are
+*   stored as a compact binary stream and re-executed through the game core at full speed,
+*   checking the final state hash recorded when the game ended.
+*
+*   Copyright (c) 2024 (DoughnutDude)
+*
+**********************************************************************************************/
+
+#include "replay.h"
+
+#include <stdio.h>          // Required for: FILE, fopen(), fread(), fwrite(), fclose()
+#include <stdlib.h>         // Required for: malloc(), realloc(), free()
+#include <string.h>         // Required for: memcmp(), memcpy()
+
+#define internal static
+
+#define REPLAY_HEADER_MAX_SIZE  (4 + 1 + 6*5 + 4 + 2*5 + 8)
+#define REPLAY_ACTION_MAX_SIZE  (3*5)
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions Definition
+//----------------------------------------------------------------------------------
+internal int WriteVarint(unsigned char *data, unsigned int value)
+{
+    int size = 0;
+    while (value >= 0x80)
+    {
+        data[size] = (unsigned char)(value | 0x80);
+        value >>= 7;
+        ++size;
+    }
+    data[size] = (unsigned char)value;
+    return size + 1;
+}
+
+internal int WriteFixed(unsigned char *data, unsigned long long value, int bytes)
+{
+    for (int i = 0; i < bytes; ++i) data[i] = (unsigned char)(value >> (8*i));
+    return bytes;
+}
+
+// Read a varint at *offset, false if the stream ends or the value does not fit 32 bits
+internal bool ReadVarint(const unsigned char *data, int dataSize, int *offset, unsigned int *value)
+{
+    unsigned int result = 0;
+    for (int shift = 0; shift < 35; shift += 7)
+    {
+        if (*offset >= dataSize) return false;
+
+        unsigned char byte = data[*offset];
+        ++*offset;
+        result |= (unsigned int)(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+        {
+            *value = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+internal bool ReadFixed(const unsigned char *data, int dataSize, int *offset, unsigned long long *value, int bytes)
+{
+    if (*offset + bytes > dataSize) return false;
+
+    unsigned long long result = 0;
+    for (int i = 0; i < bytes; ++i) result |= (unsigned long long)data[*offset + i] << (8*i);
+    *offset += bytes;
+    *value = result;
+    return true;
+}
+
+//----------------------------------------------------------------------------------
+// Replay Functions Definition
+//----------------------------------------------------------------------------------
+void BeginReplay(Replay *replay, GameSettings settings)
+{
+    replay->settings = settings;
+    replay->count = 0;
+    replay->finalTick = 0;
+    replay->finalHash = 0;
+}
+
+void RecordReplayAction(Replay *replay, GameAction action)
+{
+    if (replay->count >= replay->capacity)
+    {
+        int capacity = (replay->capacity > 0)? replay->capacity*2 : 256;
+        GameAction *actions = (GameAction *)realloc(replay->actions, capacity*sizeof(GameAction));
+        if (actions == NULL) return;
+
+        replay->actions = actions;
+        replay->capacity = capacity;
+    }
+
+    replay->actions[replay->count] = action;
+    ++replay->count;
+}
+
+void EndReplay(Replay *replay, const GameState *game)
+{
+    replay->finalTick = game->tick;
+    replay->finalHash = GetGameStateHash(game);
+}
+
+void UnloadReplay(Replay *replay)
+{
+    free(replay->actions);
+    replay->actions = NULL;
+    replay->count = 0;
+    replay->capacity = 0;
+}
+
+unsigned char *EncodeReplay(const Replay *replay, int *dataSize)
+{
+    unsigned char *data = (unsigned char *)malloc(REPLAY_HEADER_MAX_SIZE + replay->count*REPLAY_ACTION_MAX_SIZE);
+    if (data == NULL) return NULL;
+
+    int size = 0;
+    memcpy(data, "MSRP", 4);
+    size += 4;
+    data[size] = REPLAY_VERSION;
+    ++size;
+
+    const GameSettings *settings = &replay->settings;
+    size += WriteVarint(data + size, settings->width);
+    size += WriteVarint(data + size, settings->height);
+    size += WriteVarint(data + size, settings->mineDensity);
+    size += WriteVarint(data + size, settings->minesDesired);
+    size += WriteVarint(data + size, settings->mineGenMode);
+    size += WriteVarint(data + size, settings->startingHP);
+    size += WriteFixed(data + size, settings->seed, 4);
+    size += WriteVarint(data + size, replay->count);
+    size += WriteVarint(data + size, replay->finalTick);
+    size += WriteFixed(data + size, replay->finalHash, 8);
+
+    int previousTick = 0;
+    for (int i = 0; i < replay->count; ++i)
+    {
+        GameAction action = replay->actions[i];
+        if ((action.tick < previousTick) || (action.x < 0) || (action.y < 0))
+        {
+            // Actions are always applied in tick order on the board, anything else is not a valid game
+            free(data);
+            return NULL;
+        }
+
+        size += WriteVarint(data + size, ((unsigned int)(action.tick - previousTick) << 3) | (unsigned int)action.type);
+        size += WriteVarint(data + size, action.x);
+        size += WriteVarint(data + size, action.y);
+        previousTick = action.tick;
+    }
+
+    *dataSize = size;
+    return data;
+}
+
+bool DecodeReplay(const unsigned char *data, int dataSize, Replay *replay)
+{
+    if ((dataSize < 5) || (memcmp(data, "MSRP", 4) != 0) || (data[4] != REPLAY_VERSION)) return false;
+
+    int offset = 5;
+    unsigned int values[8] = { 0 };
+    for (int i = 0; i < 6; ++i)
+    {
+        if (!ReadVarint(data, dataSize, &offset, &values[i])) return false;
+    }
+    unsigned long long seed = 0;
+    unsigned long long finalHash = 0;
+    if (!ReadFixed(data, dataSize, &offset, &seed, 4)) return false;
+    if (!ReadVarint(data, dataSize, &offset, &values[6])) return false;
+    if (!ReadVarint(data, dataSize, &offset, &values[7])) return false;
+    if (!ReadFixed(data, dataSize, &offset, &finalHash, 8)) return false;
+
+    GameSettings settings = { 0 };
+    settings.width = (int)values[0];
+    settings.height = (int)values[1];
+    settings.mineDensity = (int)values[2];
+    settings.minesDesired = (int)values[3];
+    settings.mineGenMode = (values[4] != 0);
+    settings.startingHP = (int)values[5];
+    settings.seed = (unsigned int)seed;
+    int count = (int)values[6];
+
+    if ((settings.width < 1) || (settings.width > maxBoardWidth) ||
+        (settings.height < 1) || (settings.height > maxBoardHeight)) return false;
+
+    // Every action takes at least 3 bytes, reject counts the stream cannot hold before allocating
+    if ((count < 0) || (count > (dataSize - offset)/3)) return false;
+
+    BeginReplay(replay, settings);
+    replay->finalTick = (int)values[7];
+    replay->finalHash = finalHash;
+
+    int tick = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        unsigned int tickAndType = 0;
+        unsigned int x = 0;
+        unsigned int y = 0;
+        if (!ReadVarint(data, dataSize, &offset, &tickAndType) ||
+            !ReadVarint(data, dataSize, &offset, &x) ||
+            !ReadVarint(data, dataSize, &offset, &y)) break;
+
+        GameAction action = { 0 };
+        tick += (int)(tickAndType >> 3);
+        action.tick = tick;
+        action.type = (GameActionType)(tickAndType & 0x7);
+        action.x = (int)x;
+        action.y = (int)y;
+        if ((action.type > ACTION_REVEAL_ALL) || (action.tick < 0)) break;
+
+        RecordReplayAction(replay, action);
+    }
+
+    if (replay->count != count)
+    {
+        UnloadReplay(replay);
+        return false;
+    }
+    return true;
+}
+
+bool SaveReplay(const Replay *replay, const char *fileName)
+{
+    int dataSize = 0;
+    unsigned char *data = EncodeReplay(replay, &dataSize);
+    if (data == NULL) return false;
+
+    bool result = false;
+    FILE *file = fopen(fileName, "wb");
+    if (file != NULL)
+    {
+        result = (fwrite(data, 1, dataSize, file) == (size_t)dataSize);
+        fclose(file);
+    }
+
+    free(data);
+    return result;
+}
+
+bool LoadReplay(const char *fileName, Replay *replay)
+{
+    FILE *file = fopen(fileName, "rb");
+    if (file == NULL) return false;
+
+    fseek(file, 0, SEEK_END);
+    long dataSize = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    bool result = false;
+    unsigned char *data = (dataSize > 0)? (unsigned char *)malloc(dataSize) : NULL;
+    if ((data != NULL) && (fread(data, 1, dataSize, file) == (size_t)dataSize))
+    {
+        result = DecodeReplay(data, (int)dataSize, replay);
+    }
+
+    free(data);
+    fclose(file);
+    return result;
+}
+
+bool PlayReplay(const Replay *replay, GameState *game)
+{
+    InitGame(game, replay->settings);
+
+    // No need to run the ticks in between actions, nothing on the board changes without an action
+    for (int i = 0; i < replay->count; ++i)
+    {
+        game->tick = replay->actions[i].tick;
+        ApplyGameAction(game, replay->actions[i]);
+    }
+    game->tick = replay->finalTick;
+
+    return (GetGameStateHash(game) == replay->finalHash);
+}
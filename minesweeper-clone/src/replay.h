@@ -0,0 +1,60 @@
+/**********************************************************************************************
+*
+*   Minesweeper Clone - Replays
+*
+*   A replay is the seed and settings of a game plus every action it applied. Replays are
+*   stored as a compact binary stream and re-executed through the game core at full speed,
+*   checking the final state hash recorded when the game ended.
+*
+*   Replay file format (.msr), little endian, varint = unsigned LEB128:
+*       4 bytes     "MSRP"
+*       1 byte      version
+*       varints     width, height, mineDensity, minesDesired, mineGenMode, startingHP
+*       4 bytes     seed
+*       varints     action count, final tick
+*       8 bytes     final state hash (GetGameStateHash())
+*       per action  varint (tick delta from previous action << 3 | type), varint x, varint y
+*
+*   Copyright (c) 2024 (DoughnutDude)
+*
+**********************************************************************************************/
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "game_core.h"
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define REPLAY_VERSION          1
+#define REPLAY_FILE_EXTENSION   ".msr"
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct Replay {
+    GameSettings settings;
+    GameAction *actions;            // Actions in the order they were applied
+    int count;
+    int capacity;
+    int finalTick;                  // Tick the recording ended on
+    unsigned long long finalHash;   // GetGameStateHash() of the game when the recording ended
+} Replay;
+
+//----------------------------------------------------------------------------------
+// Replay Functions Declaration
+//----------------------------------------------------------------------------------
+void BeginReplay(Replay *replay, GameSettings settings);            // Start recording a game, settings must contain the seed
+void RecordReplayAction(Replay *replay, GameAction action);         // Record an action accepted by the game core
+void EndReplay(Replay *replay, const GameState *game);              // Finish recording at the current tick
+void UnloadReplay(Replay *replay);
+
+unsigned char *EncodeReplay(const Replay *replay, int *dataSize);   // Encode replay to a binary stream (memory must be freed)
+bool DecodeReplay(const unsigned char *data, int dataSize, Replay *replay); // Decode a binary stream, false if it is malformed
+bool SaveReplay(const Replay *replay, const char *fileName);
+bool LoadReplay(const char *fileName, Replay *replay);
+
+bool PlayReplay(const Replay *replay, GameState *game);             // Re-execute a replay, returns true if the final hash matches
+
+#endif // REPLAY_H
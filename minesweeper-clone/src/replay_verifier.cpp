@@ -0,0 +1,575 @@
+/**********************************************************************************************
+*
+*   Minesweeper Clone - Replay Verifier
+*
+*   Checks submitted replays for the leaderboard: every replay is re-executed through the
+*   headless game core, inputs a real client can not produce are flagged (refused actions,
+*   inhuman click rates, debug actions) and the verdict is written out signed (HMAC-SHA256).
+*
+*   Copyright (c) 2024 (DoughnutDude)
+*
+**********************************************************************************************/
+
+#include "raylib.h"         // Required for: LoadDirectoryFiles(), IsFileExtension(), FileExists()
+#include "replay_verifier.h"
+
+#include <stdio.h>          // Required for: FILE, fopen(), fgets(), rename(), snprintf()
+#include <stdlib.h>         // Required for: malloc(), free(), getenv()
+#include <string.h>         // Required for: strlen(), strstr(), strcmp()
+#include <signal.h>         // Required for: signal(), SIGINT
+#include <time.h>           // Required for: time()
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+
+#define internal static
+#define global_var static
+
+#define VERIFY_PATH_LENGTH      512
+#define VERIFY_SUFFIX_LENGTH    16          // Room for the suffixes added to a path (".result.tmp", ".msr.verified")
+#define VERIFY_CLIENT_TIMEOUT   60.0        // Seconds the client waits for all its results
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct Sha256 {
+    unsigned int state[8];
+    unsigned char block[64];
+    int blockSize;
+    unsigned long long totalSize;
+} Sha256;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+// Claimed replays waiting for a worker (ring buffer of paths)
+global_var char pendingPaths[VERIFY_MAX_PENDING][VERIFY_PATH_LENGTH] = { 0 };
+global_var int pendingHead = 0;
+global_var int pendingCount = 0;
+global_var std::mutex pendingMutex;
+global_var std::condition_variable pendingSignal;
+
+global_var std::atomic<bool> daemonRunning(false);
+global_var std::atomic<int> verifiedCount(0);
+global_var std::atomic<int> rejectedCount(0);
+
+global_var const char *signingKey = "";
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions Definition
+//----------------------------------------------------------------------------------
+internal double GetSeconds(void)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+internal void SleepSeconds(double seconds)
+{
+    // NOTE: raylib WaitTime() relies on GetTime(), which needs a window
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+}
+
+// SHA-256 (FIPS 180-4)
+internal void Sha256Transform(Sha256 *sha, const unsigned char *block)
+{
+    static const unsigned int k[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+    };
+    #define ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+    unsigned int w[64];
+    for (int i = 0; i < 16; ++i) w[i] = ((unsigned int)block[i*4] << 24) | ((unsigned int)block[i*4 + 1] << 16) | ((unsigned int)block[i*4 + 2] << 8) | block[i*4 + 3];
+    for (int i = 16; i < 64; ++i)
+    {
+        unsigned int s0 = ROTR(w[i - 15], 7) ^ ROTR(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        unsigned int s1 = ROTR(w[i - 2], 17) ^ ROTR(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    unsigned int v[8];
+    for (int i = 0; i < 8; ++i) v[i] = sha->state[i];
+    for (int i = 0; i < 64; ++i)
+    {
+        unsigned int s1 = ROTR(v[4], 6) ^ ROTR(v[4], 11) ^ ROTR(v[4], 25);
+        unsigned int choose = (v[4] & v[5]) ^ (~v[4] & v[6]);
+        unsigned int temp1 = v[7] + s1 + choose + k[i] + w[i];
+        unsigned int s0 = ROTR(v[0], 2) ^ ROTR(v[0], 13) ^ ROTR(v[0], 22);
+        unsigned int majority = (v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]);
+        unsigned int temp2 = s0 + majority;
+
+        v[7] = v[6]; v[6] = v[5]; v[5] = v[4]; v[4] = v[3] + temp1;
+        v[3] = v[2]; v[2] = v[1]; v[1] = v[0]; v[0] = temp1 + temp2;
+    }
+    for (int i = 0; i < 8; ++i) sha->state[i] += v[i];
+
+    #undef ROTR
+}
+
+internal void Sha256Begin(Sha256 *sha)
+{
+    static const unsigned int initialState[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+    for (int i = 0; i < 8; ++i) sha->state[i] = initialState[i];
+    sha->blockSize = 0;
+    sha->totalSize = 0;
+}
+
+internal void Sha256Update(Sha256 *sha, const unsigned char *data, int size)
+{
+    for (int i = 0; i < size; ++i)
+    {
+        sha->block[sha->blockSize] = data[i];
+        ++sha->blockSize;
+        if (sha->blockSize == 64)
+        {
+            Sha256Transform(sha, sha->block);
+            sha->blockSize = 0;
+        }
+    }
+    sha->totalSize += size;
+}
+
+internal void Sha256End(Sha256 *sha, unsigned char *digest)
+{
+    unsigned long long totalBits = sha->totalSize*8;
+    unsigned char padding = 0x80;
+    Sha256Update(sha, &padding, 1);
+    padding = 0;
+    while (sha->blockSize != 56) Sha256Update(sha, &padding, 1);
+
+    unsigned char length[8];
+    for (int i = 0; i < 8; ++i) length[i] = (unsigned char)(totalBits >> (56 - 8*i));
+    Sha256Update(sha, length, 8);
+
+    for (int i = 0; i < 32; ++i) digest[i] = (unsigned char)(sha->state[i/4] >> (24 - 8*(i%4)));
+}
+
+// HMAC-SHA256 of text with key, written as 64 hex characters
+internal void SignText(const char *text, int textSize, const char *key, char *signature)
+{
+    unsigned char keyBlock[64] = { 0 };
+    int keySize = (int)strlen(key);
+    if (keySize > 64)
+    {
+        Sha256 sha;
+        Sha256Begin(&sha);
+        Sha256Update(&sha, (const unsigned char *)key, keySize);
+        Sha256End(&sha, keyBlock);
+    }
+    else memcpy(keyBlock, key, keySize);
+
+    unsigned char pad[64];
+    unsigned char innerDigest[32];
+    unsigned char digest[32];
+    Sha256 sha;
+
+    for (int i = 0; i < 64; ++i) pad[i] = keyBlock[i] ^ 0x36;
+    Sha256Begin(&sha);
+    Sha256Update(&sha, pad, 64);
+    Sha256Update(&sha, (const unsigned char *)text, textSize);
+    Sha256End(&sha, innerDigest);
+
+    for (int i = 0; i < 64; ++i) pad[i] = keyBlock[i] ^ 0x5c;
+    Sha256Begin(&sha);
+    Sha256Update(&sha, pad, 64);
+    Sha256Update(&sha, innerDigest, 32);
+    Sha256End(&sha, digest);
+
+    for (int i = 0; i < 32; ++i) sprintf(signature + i*2, "%02x", digest[i]);
+}
+
+// Verify one claimed replay (name.msr.working), write name.result and keep the replay as name.msr.verified
+internal void ProcessClaimedReplay(const char *workingPath, GameState *game)
+{
+    char basePath[VERIFY_PATH_LENGTH] = { 0 };
+    char resultPath[VERIFY_PATH_LENGTH + VERIFY_SUFFIX_LENGTH] = { 0 };
+    char verifiedPath[VERIFY_PATH_LENGTH + VERIFY_SUFFIX_LENGTH] = { 0 };
+
+    // Strip ".msr.working"
+    int baseLength = (int)strlen(workingPath) - (int)strlen(REPLAY_FILE_EXTENSION ".working");
+    memcpy(basePath, workingPath, baseLength);
+    snprintf(resultPath, sizeof(resultPath), "%s.result", basePath);
+    snprintf(verifiedPath, sizeof(verifiedPath), "%s" REPLAY_FILE_EXTENSION ".verified", basePath);
+
+    Replay replay = { 0 };
+    ReplayVerdict verdict = { 0 };
+    if (LoadReplay(workingPath, &replay)) verdict = VerifyReplay(&replay, game);
+    else
+    {
+        verdict.flags = REPLAY_FLAG_MALFORMED;
+        verdict.firstBadAction = -1;
+    }
+    UnloadReplay(&replay);
+
+    char text[512] = { 0 };
+    int textSize = FormatSignedVerdict(text, sizeof(text), GetFileName(basePath), verdict, signingKey);
+
+    // Result is written under a temporary name first, so a reader never sees a partial line
+    char tempPath[VERIFY_PATH_LENGTH + VERIFY_SUFFIX_LENGTH] = { 0 };
+    snprintf(tempPath, sizeof(tempPath), "%s.result.tmp", basePath);
+    FILE *file = fopen(tempPath, "wb");
+    if (file != NULL)
+    {
+        fwrite(text, 1, textSize, file);
+        fclose(file);
+        remove(resultPath);
+        rename(tempPath, resultPath);
+    }
+    remove(verifiedPath);
+    rename(workingPath, verifiedPath);
+
+    ++verifiedCount;
+    if (verdict.flags != 0) ++rejectedCount;
+}
+
+internal void VerifierWorkerThread(void)
+{
+    GameState *game = (GameState *)malloc(sizeof(GameState));     // NOTE: Too big for some thread stacks
+    char path[VERIFY_PATH_LENGTH] = { 0 };
+
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(pendingMutex);
+            pendingSignal.wait(lock, [] { return (pendingCount > 0) || !daemonRunning; });
+            if (pendingCount == 0) break;
+
+            strcpy(path, pendingPaths[pendingHead]);
+            pendingHead = (pendingHead + 1)%VERIFY_MAX_PENDING;
+            --pendingCount;
+        }
+        pendingSignal.notify_all();     // Let the scanner claim more
+
+        ProcessClaimedReplay(path, game);
+    }
+
+    free(game);
+}
+
+internal void StopDaemon(int signalId)
+{
+    (void)signalId;
+    daemonRunning = false;
+}
+
+// Simple bot playing through the game core, used by the stand-in client to make replays
+// NOTE: It peeks at the board to avoid mines, the verifier can not tell, just like with a real player
+internal void PlayBotGame(unsigned int seed, int cheat, Replay *replay, GameState *game)
+{
+    GameSettings settings = { 0 };
+    settings.width = 16;
+    settings.height = 16;
+    settings.minesDesired = 40;
+    settings.mineGenMode = 1;
+    settings.startingHP = 1;
+    settings.seed = seed;
+
+    InitGame(game, settings);
+    BeginReplay(replay, settings);
+
+    unsigned int random = seed*2654435761u + 1;
+    int tick = 0;
+    for (int i = 0; (i < 10000) && !IsGameOver(game); ++i)
+    {
+        random = random*1103515245u + 12345u;
+        tick += 12 + (random >> 16)%40;     // 100-430ms between clicks
+
+        GameAction action = { 0 };
+        action.tick = tick;
+        action.type = ACTION_REVEAL;
+        action.x = (random >> 8)%settings.width;
+        action.y = (random >> 20)%settings.height;
+        if ((i > 0) && ((game->board[action.y][action.x] < 0) || (game->boardMask[action.y][action.x] != 1))) continue;
+
+        game->tick = tick;
+        if (ApplyGameAction(game, action)) RecordReplayAction(replay, action);
+    }
+    game->tick = tick;
+    EndReplay(replay, game);
+
+    // Tamper with some replays so the client can check the verifier catches them
+    if ((cheat == 1) && (replay->count > VERIFY_MAX_FAST_ACTIONS + 1))
+    {
+        // Machine-speed inputs
+        for (int i = 1; i < replay->count; ++i) replay->actions[i].tick = replay->actions[0].tick + i;
+    }
+    else if ((cheat == 2) && (replay->count > 1))
+    {
+        // First tile clicked again once revealed, between the first two clicks
+        GameAction action = replay->actions[0];
+        action.tick = (replay->actions[0].tick + replay->actions[1].tick)/2;
+        RecordReplayAction(replay, action);
+        for (int i = replay->count - 1; i > 1; --i) replay->actions[i] = replay->actions[i - 1];
+        replay->actions[1] = action;
+    }
+    else if (cheat != 0) replay->finalHash ^= 1;    // Edited board
+}
+
+//----------------------------------------------------------------------------------
+// Replay Verifier Functions Definition
+//----------------------------------------------------------------------------------
+ReplayVerdict VerifyReplay(const Replay *replay, GameState *game)
+{
+    ReplayVerdict verdict = { 0 };
+    verdict.actionCount = replay->count;
+    verdict.firstBadAction = -1;
+    verdict.settings = replay->settings;
+
+    InitGame(game, replay->settings);
+
+    int previousTick = -VERIFY_MIN_ACTION_TICKS;
+    for (int i = 0; i < replay->count; ++i)
+    {
+        GameAction action = replay->actions[i];
+
+        if (action.type == ACTION_REVEAL_ALL) verdict.flags |= REPLAY_FLAG_DEBUG_ACTION;
+        if (action.tick > replay->finalTick) verdict.flags |= REPLAY_FLAG_BAD_TIMING;
+        if (action.tick - previousTick < VERIFY_MIN_ACTION_TICKS) ++verdict.fastActions;
+        previousTick = action.tick;
+
+        game->tick = action.tick;
+        if (!ApplyGameAction(game, action))
+        {
+            ++verdict.refusedActions;
+            if (verdict.firstBadAction < 0) verdict.firstBadAction = i;
+        }
+    }
+    game->tick = replay->finalTick;
+
+    verdict.hash = GetGameStateHash(game);
+    verdict.won = game->winCon;
+    verdict.time = GetGameTimer(game);
+
+    if (verdict.hash != replay->finalHash) verdict.flags |= REPLAY_FLAG_HASH_MISMATCH;
+    if (verdict.refusedActions > 0) verdict.flags |= REPLAY_FLAG_REFUSED_ACTION;
+    if (verdict.fastActions > VERIFY_MAX_FAST_ACTIONS) verdict.flags |= REPLAY_FLAG_INHUMAN_SPEED;
+
+    return verdict;
+}
+
+const char *GetReplayVerdictName(ReplayVerdict verdict)
+{
+    if (verdict.flags != 0) return "REJECTED";
+    return verdict.won? "VALID" : "UNFINISHED";
+}
+
+int FormatSignedVerdict(char *text, int size, const char *replayName, ReplayVerdict verdict, const char *key)
+{
+    const GameSettings *board = &verdict.settings;
+    int length = snprintf(text, size, "%s %s board=%ix%i %s=%i hp=%i seed=%u flags=%u won=%i time=%.3f actions=%i refused=%i fast=%i hash=%016llx",
+                          replayName, GetReplayVerdictName(verdict), board->width, board->height, board->mineGenMode? "mines" : "density",
+                          board->mineGenMode? board->minesDesired : board->mineDensity, board->startingHP, board->seed, verdict.flags,
+                          verdict.won, verdict.time, verdict.actionCount, verdict.refusedActions, verdict.fastActions, verdict.hash);
+    if ((length < 0) || (length + 70 >= size)) return 0;
+
+    char signature[65] = { 0 };
+    SignText(text, length, key, signature);
+    length += snprintf(text + length, size - length, " sig=%s\n", signature);
+
+    return length;
+}
+
+bool CheckVerdictSignature(const char *text, const char *key)
+{
+    const char *signature = strstr(text, " sig=");
+    if ((signature == NULL) || (strlen(signature + 5) < 64)) return false;
+
+    char expected[65] = { 0 };
+    SignText(text, (int)(signature - text), key, expected);
+
+    return (strncmp(signature + 5, expected, 64) == 0);
+}
+
+int RunReplayVerifierDaemon(const char *inboxPath, int workerCount)
+{
+    if (!DirectoryExists(inboxPath))
+    {
+        printf("verifier: inbox directory %s not found\n", inboxPath);
+        return 2;
+    }
+
+    // NOTE: Verdicts signed with an empty key could be forged by anyone
+    signingKey = getenv(VERIFY_KEY_ENV);
+    if ((signingKey == NULL) || (signingKey[0] == '\0'))
+    {
+        printf("verifier: %s not set, refusing to sign verdicts without a key\n", VERIFY_KEY_ENV);
+        return 3;
+    }
+
+    if (workerCount < 1) workerCount = (int)std::thread::hardware_concurrency();
+    if (workerCount < 1) workerCount = 1;
+
+    daemonRunning = true;
+    signal(SIGINT, StopDaemon);
+
+    std::thread *workers = new std::thread[workerCount];
+    for (int i = 0; i < workerCount; ++i) workers[i] = std::thread(VerifierWorkerThread);
+
+    printf("verifier: watching %s with %i workers (Ctrl+C to stop)\n", inboxPath, workerCount);
+
+    // Replays claimed by a previous run that did not finish them
+    FilePathList leftovers = LoadDirectoryFiles(inboxPath);
+    for (unsigned int i = 0; i < leftovers.count; ++i)
+    {
+        if (IsFileExtension(leftovers.paths[i], ".working") && (strlen(leftovers.paths[i]) < VERIFY_PATH_LENGTH))
+        {
+            // NOTE: Workers are already running, room is checked under the lock
+            std::unique_lock<std::mutex> lock(pendingMutex);
+            pendingSignal.wait(lock, [] { return (pendingCount < VERIFY_MAX_PENDING) || !daemonRunning; });
+            if (!daemonRunning) break;
+            strcpy(pendingPaths[(pendingHead + pendingCount)%VERIFY_MAX_PENDING], leftovers.paths[i]);
+            ++pendingCount;
+        }
+    }
+    UnloadDirectoryFiles(leftovers);
+    pendingSignal.notify_all();
+
+    double reportTime = GetSeconds() + 1.0;
+    int reportedCount = 0;
+    while (daemonRunning)
+    {
+        int claimedCount = 0;
+        FilePathList files = LoadDirectoryFiles(inboxPath);
+        for (unsigned int i = 0; (i < files.count) && daemonRunning; ++i)
+        {
+            if (!IsFileExtension(files.paths[i], REPLAY_FILE_EXTENSION)) continue;
+
+            // Wait for room in the pending ring, workers drain it
+            std::unique_lock<std::mutex> lock(pendingMutex);
+            pendingSignal.wait(lock, [] { return (pendingCount < VERIFY_MAX_PENDING) || !daemonRunning; });
+            if (!daemonRunning) break;
+
+            // Claim the replay by renaming it, it is never picked up twice
+            char *workingPath = pendingPaths[(pendingHead + pendingCount)%VERIFY_MAX_PENDING];
+            int length = snprintf(workingPath, VERIFY_PATH_LENGTH, "%s.working", files.paths[i]);
+            if ((length < VERIFY_PATH_LENGTH) && (rename(files.paths[i], workingPath) == 0))    // NOTE: Names too long to claim are left alone
+            {
+                ++pendingCount;
+                ++claimedCount;
+                lock.unlock();
+                pendingSignal.notify_all();
+            }
+        }
+        UnloadDirectoryFiles(files);
+
+        if (GetSeconds() >= reportTime)
+        {
+            int count = verifiedCount;
+            if (count != reportedCount) printf("verifier: %i verified (%i/s), %i rejected\n", count, count - reportedCount, (int)rejectedCount);
+            reportedCount = count;
+            reportTime += 1.0;
+        }
+
+        if (claimedCount == 0) SleepSeconds(VERIFY_POLL_TIME);
+    }
+
+    // Claimed replays are finished before stopping
+    pendingSignal.notify_all();
+    for (int i = 0; i < workerCount; ++i) workers[i].join();
+    delete[] workers;
+
+    printf("verifier: stopped, %i verified, %i rejected\n", (int)verifiedCount, (int)rejectedCount);
+    return 0;
+}
+
+int RunReplayVerifierClient(const char *inboxPath, int replayCount)
+{
+    if (!DirectoryExists(inboxPath))
+    {
+        printf("client: inbox directory %s not found\n", inboxPath);
+        return 2;
+    }
+
+    const char *key = getenv(VERIFY_KEY_ENV);
+    if ((key == NULL) || (key[0] == '\0'))
+    {
+        printf("client: %s not set, verdicts can not be checked\n", VERIFY_KEY_ENV);
+        return 3;
+    }
+    if (strlen(inboxPath) + 32 >= VERIFY_PATH_LENGTH)     // Room for "/client_NNNNNN.result"
+    {
+        printf("client: inbox path too long\n");
+        return 3;
+    }
+    if (replayCount < 1) replayCount = 1;
+
+    GameState *game = (GameState *)malloc(sizeof(GameState));
+    Replay replay = { 0 };
+    char path[VERIFY_PATH_LENGTH] = { 0 };
+    char tempPath[VERIFY_PATH_LENGTH + VERIFY_SUFFIX_LENGTH] = { 0 };
+    unsigned int runSeed = (unsigned int)time(NULL);
+
+    // Every 10th replay is tampered with, in turns: inhuman speed, refused click, edited board
+    double startTime = GetSeconds();
+    for (int i = 0; i < replayCount; ++i)
+    {
+        int cheat = ((i%10) == 9)? 1 + (i/10)%3 : 0;
+        PlayBotGame(runSeed + i, cheat, &replay, game);
+
+        snprintf(path, VERIFY_PATH_LENGTH, "%s/client_%06i" REPLAY_FILE_EXTENSION, inboxPath, i);
+        snprintf(tempPath, sizeof(tempPath), "%s.tmp", path);
+        if (SaveReplay(&replay, tempPath)) rename(tempPath, path);
+    }
+    UnloadReplay(&replay);
+    free(game);
+    double submitTime = GetSeconds();
+
+    // Collect results
+    int resultCount = 0;
+    int expectedCount = 0;
+    int badSignatures = 0;
+    int verdictCounts[3] = { 0 };   // VALID, UNFINISHED, REJECTED
+    bool *collected = (bool *)calloc(replayCount, sizeof(bool));
+    double endTime = submitTime;
+
+    while ((resultCount < replayCount) && (GetSeconds() - submitTime < VERIFY_CLIENT_TIMEOUT))
+    {
+        for (int i = 0; i < replayCount; ++i)
+        {
+            if (collected[i]) continue;
+
+            snprintf(path, VERIFY_PATH_LENGTH, "%s/client_%06i.result", inboxPath, i);
+            FILE *file = fopen(path, "rb");
+            if (file == NULL) continue;
+
+            char line[512] = { 0 };
+            bool read = (fgets(line, sizeof(line), file) != NULL);
+            fclose(file);
+            if (!read) continue;
+
+            collected[i] = true;
+            ++resultCount;
+            endTime = GetSeconds();
+
+            if (!CheckVerdictSignature(line, key)) ++badSignatures;
+            if (strstr(line, " VALID ") != NULL) ++verdictCounts[0];
+            else if (strstr(line, " UNFINISHED ") != NULL) ++verdictCounts[1];
+            else ++verdictCounts[2];
+
+            // Tampered replays must be rejected, untouched ones must not
+            bool tampered = ((i%10) == 9);
+            if (tampered == (strstr(line, " REJECTED ") != NULL)) ++expectedCount;
+        }
+        if (resultCount < replayCount) SleepSeconds(VERIFY_POLL_TIME);
+    }
+    free(collected);
+
+    printf("client: %i replays submitted in %.3fs\n", replayCount, submitTime - startTime);
+    printf("client: %i results in %.3fs (%.0f replays/s)\n", resultCount, endTime - submitTime,
+           (endTime > submitTime)? resultCount/(endTime - submitTime) : 0.0);
+    printf("client: %i valid, %i unfinished, %i rejected, %i as expected, %i bad signatures\n",
+           verdictCounts[0], verdictCounts[1], verdictCounts[2], expectedCount, badSignatures);
+
+    return ((resultCount == replayCount) && (expectedCount == replayCount) && (badSignatures == 0))? 0 : 1;
+}
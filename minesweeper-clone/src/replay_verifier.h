@@ -0,0 +1,72 @@
+/**********************************************************************************************
+*
+*   Minesweeper Clone - Replay Verifier
+*
+*   Checks submitted replays for the leaderboard: every replay is re-executed through the
+*   headless game core, inputs a real client can not produce are flagged (refused actions,
+*   inhuman click rates, debug actions) and the verdict is written out signed (HMAC-SHA256),
+*   with the board it was played on: a verdict for an easy board can not pass for a hard one.
+*   The daemon refuses to start without a signing key.
+*
+*   The daemon watches an inbox directory and verifies replays in parallel on a worker pool:
+*       <inbox>/name.msr            dropped by the client (write to a temp name, then rename)
+*       <inbox>/name.msr.working    claimed by the daemon
+*       <inbox>/name.result         signed verdict, one line
+*       <inbox>/name.msr.verified   replay kept once verified
+*
+*   Copyright (c) 2024 (DoughnutDude)
+*
+**********************************************************************************************/
+
+#ifndef REPLAY_VERIFIER_H
+#define REPLAY_VERIFIER_H
+
+#include "replay.h"
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define VERIFY_MIN_ACTION_TICKS     3           // Closest two inputs can humanly be (25ms at SIM_TICK_RATE)
+#define VERIFY_MAX_FAST_ACTIONS     4           // Inputs closer than VERIFY_MIN_ACTION_TICKS tolerated per replay
+#define VERIFY_POLL_TIME            0.05        // Seconds between inbox directory scans when idle
+#define VERIFY_MAX_PENDING          1024        // Replays claimed and waiting for a worker
+#define VERIFY_KEY_ENV              "MINESWEEPER_VERIFY_KEY"   // Environment variable holding the signing key
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum ReplayFlag {
+    REPLAY_FLAG_MALFORMED       = 1 << 0,   // File could not be decoded
+    REPLAY_FLAG_HASH_MISMATCH   = 1 << 1,   // Final board differs from the recorded one
+    REPLAY_FLAG_REFUSED_ACTION  = 1 << 2,   // Input the board refuses (i.e. click on a revealed tile), clients never record those
+    REPLAY_FLAG_INHUMAN_SPEED   = 1 << 3,   // Too many inputs closer than VERIFY_MIN_ACTION_TICKS
+    REPLAY_FLAG_DEBUG_ACTION    = 1 << 4,   // Debug reveal used
+    REPLAY_FLAG_BAD_TIMING      = 1 << 5,   // Actions past the final tick
+} ReplayFlag;
+
+typedef struct ReplayVerdict {
+    unsigned int flags;     // ReplayFlag bits, 0 = legitimate
+    bool won;
+    float time;             // Game timer recomputed from ticks, in seconds
+    int actionCount;
+    int refusedActions;
+    int fastActions;
+    int firstBadAction;     // Index of the first refused action, -1 if none
+    unsigned long long hash;
+    GameSettings settings;  // Board of the replay (seed included), signed with the verdict
+} ReplayVerdict;
+
+//----------------------------------------------------------------------------------
+// Replay Verifier Functions Declaration
+//----------------------------------------------------------------------------------
+ReplayVerdict VerifyReplay(const Replay *replay, GameState *game);  // Re-execute and check a replay, game is scratch memory
+const char *GetReplayVerdictName(ReplayVerdict verdict);            // VALID, UNFINISHED or REJECTED
+
+// Format a verdict as a single signed text line, returns its length
+int FormatSignedVerdict(char *text, int size, const char *replayName, ReplayVerdict verdict, const char *key);
+bool CheckVerdictSignature(const char *text, const char *key);      // Check a line produced by FormatSignedVerdict()
+
+int RunReplayVerifierDaemon(const char *inboxPath, int workerCount); // Watch inbox and verify until interrupted
+int RunReplayVerifierClient(const char *inboxPath, int replayCount); // Submit generated replays and check the signed results
+
+#endif // REPLAY_VERIFIER_H
@@ -0,0 +1,358 @@
+/**********************************************************************************************
+*
+*   Minesweeper Clone - Screen Capture
+*
+*   Screenshots (F12) and GIF recording (CTRL+F12) that never stall the game loop:
+*   the render thread only copies the framebuffer once into a ring of buffers, flipping,
+*   quantization, PNG/GIF encoding and file writes happen on a worker thread.
+*   When every buffer is still busy, the frame is skipped instead of waiting.
+*
+*   Copyright (c) 2024 (DoughnutDude)
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "rlgl.h"           // Required for: rlDrawRenderBatchActive(), rlReadScreenPixelsToBuffer()
+#include "screen_capture.h"
+#include "logger.h"
+
+// NOTE: raylib built-in gif recording is disabled in config.h, so the implementation lives here
+#define MSF_GIF_IMPL
+#include "external/msf_gif.h"
+
+#include <stdio.h>          // Required for: snprintf()
+#include <stdlib.h>         // Required for: malloc(), free()
+#include <string.h>         // Required for: strcpy()
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#define internal static
+#define global_var static
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum CaptureKind {
+    CAPTURE_NONE = 0,
+    CAPTURE_SCREENSHOT,     // Save buffer as PNG
+    CAPTURE_GIF_FRAME,      // Append buffer to the GIF being recorded
+    CAPTURE_GIF_END,        // Finish the GIF being recorded and save it (no pixel data)
+} CaptureKind;
+
+typedef struct CaptureBuffer {
+    CaptureKind kind;
+    bool busy;              // Owned by the worker until processed
+    int width;
+    int height;
+    int centiSeconds;       // GIF frame duration
+    unsigned char *data;    // RGBA, bottom row first (as read from OpenGL)
+    int capacity;           // Bytes allocated for data
+    char fileName[256];
+} CaptureBuffer;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+global_var CaptureBuffer buffers[CAPTURE_BUFFER_COUNT] = { };
+global_var int writeIndex = 0;              // Next buffer filled by the render thread
+global_var int readIndex = 0;               // Next buffer processed by the worker
+global_var bool workerRunning = false;
+
+global_var std::mutex captureMutex;
+global_var std::condition_variable captureSignal;
+global_var std::thread captureWorker;
+
+// Render thread state
+global_var bool screenshotRequested = false;
+global_var bool gifRecording = false;
+global_var bool gifStopPending = false;     // GIF_END not yet queued (ring was full)
+global_var int gifWidth = 0;
+global_var int gifHeight = 0;
+global_var double gifFrameTime = 1.0/DEFAULT_GIF_FRAMERATE;
+global_var double gifNextCaptureTime = 0.0;
+global_var double gifLastCaptureTime = 0.0;
+global_var int captureCounter = 0;
+global_var int droppedFrames = 0;
+global_var char gifFileName[256] = { 0 };
+
+// Worker thread state
+global_var MsfGifState gifState = { 0 };
+global_var bool gifOpen = false;
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions Definition
+//----------------------------------------------------------------------------------
+internal void SaveGif(const char *fileName)
+{
+    MsfGifResult result = msf_gif_end(&gifState);
+    SaveFileData(fileName, result.data, (unsigned int)result.dataSize);
+    msf_gif_free(result);
+    gifOpen = false;
+
+    LOG_MESSAGE(LOG_LEVEL_INFO, LOG_CATEGORY_CAPTURE, "[%s] Animated GIF saved", fileName);
+}
+
+// Heavy part of every capture, runs on the worker thread
+internal void ProcessCaptureBuffer(CaptureBuffer *buffer)
+{
+    switch (buffer->kind)
+    {
+        case CAPTURE_SCREENSHOT:
+        {
+            // Flip vertically and force alpha to 255, framebuffer alpha is meaningless here
+            int pitch = buffer->width*4;
+            for (int y = 0; y < buffer->height/2; ++y)
+            {
+                unsigned char *top = buffer->data + y*pitch;
+                unsigned char *bottom = buffer->data + (buffer->height - 1 - y)*pitch;
+                for (int x = 0; x < pitch; ++x)
+                {
+                    unsigned char value = top[x];
+                    top[x] = bottom[x];
+                    bottom[x] = value;
+                }
+            }
+            for (int i = 3; i < pitch*buffer->height; i += 4) buffer->data[i] = 255;
+
+            Image image = { buffer->data, buffer->width, buffer->height, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+            ExportImage(image, buffer->fileName);
+
+            LOG_MESSAGE(LOG_LEVEL_INFO, LOG_CATEGORY_CAPTURE, "[%s] Screenshot saved", buffer->fileName);
+        } break;
+        case CAPTURE_GIF_FRAME:
+        {
+            if (!gifOpen)
+            {
+                msf_gif_begin(&gifState, buffer->width, buffer->height);
+                gifOpen = true;
+            }
+            // NOTE: Negative pitch makes msf_gif read the bottom-up rows flipped
+            msf_gif_frame(&gifState, buffer->data, buffer->centiSeconds, 16, -buffer->width*4);
+        } break;
+        case CAPTURE_GIF_END:
+        {
+            if (gifOpen) SaveGif(buffer->fileName);
+        } break;
+        default: break;
+    }
+}
+
+internal void CaptureWorkerThread(void)
+{
+    for (;;)
+    {
+        CaptureBuffer *buffer = NULL;
+        {
+            std::unique_lock<std::mutex> lock(captureMutex);
+            captureSignal.wait(lock, [] { return buffers[readIndex].busy || !workerRunning; });
+
+            // Pending captures are always finished before stopping
+            if (!buffers[readIndex].busy) break;
+            buffer = &buffers[readIndex];
+        }
+
+        ProcessCaptureBuffer(buffer);
+
+        {
+            std::lock_guard<std::mutex> lock(captureMutex);
+            buffer->busy = false;
+        }
+        readIndex = (readIndex + 1)%CAPTURE_BUFFER_COUNT;
+    }
+}
+
+// Get the next ring buffer if the worker is done with it, never waits
+internal CaptureBuffer *AcquireCaptureBuffer(int width, int height)
+{
+    CaptureBuffer *buffer = NULL;
+    {
+        std::lock_guard<std::mutex> lock(captureMutex);
+        if (!buffers[writeIndex].busy) buffer = &buffers[writeIndex];
+    }
+
+    if ((buffer != NULL) && (width*height*4 > buffer->capacity))
+    {
+        free(buffer->data);
+        buffer->capacity = width*height*4;
+        buffer->data = (unsigned char *)malloc(buffer->capacity);
+    }
+    if (buffer != NULL)
+    {
+        buffer->width = width;
+        buffer->height = height;
+    }
+
+    return buffer;
+}
+
+internal void SubmitCaptureBuffer(CaptureBuffer *buffer)
+{
+    if (!workerRunning)
+    {
+        // No worker available (i.e. PLATFORM_WEB), process in place
+        ProcessCaptureBuffer(buffer);
+        writeIndex = (writeIndex + 1)%CAPTURE_BUFFER_COUNT;
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(captureMutex);
+        buffer->busy = true;
+    }
+    writeIndex = (writeIndex + 1)%CAPTURE_BUFFER_COUNT;
+    captureSignal.notify_one();
+}
+
+// Get framebuffer size in pixels
+internal void GetCaptureSize(int *width, int *height)
+{
+    Vector2 scale = GetWindowScaleDPI();
+    *width = (int)((float)GetRenderWidth()*scale.x);
+    *height = (int)((float)GetRenderHeight()*scale.y);
+}
+
+//----------------------------------------------------------------------------------
+// Screen Capture Functions Definition
+//----------------------------------------------------------------------------------
+void InitScreenCapture(void)
+{
+#if !defined(PLATFORM_WEB)
+    workerRunning = true;
+    captureWorker = std::thread(CaptureWorkerThread);
+#endif
+}
+
+void CloseScreenCapture(void)
+{
+    if (workerRunning)
+    {
+        {
+            std::lock_guard<std::mutex> lock(captureMutex);
+            workerRunning = false;
+        }
+        captureSignal.notify_one();
+        captureWorker.join();
+    }
+
+    // Worker is stopped, finish a GIF still open
+    if (gifOpen) SaveGif(gifFileName);
+    gifRecording = false;
+    gifStopPending = false;
+
+    for (int i = 0; i < CAPTURE_BUFFER_COUNT; ++i)
+    {
+        free(buffers[i].data);
+        buffers[i] = CaptureBuffer{ };
+    }
+    writeIndex = 0;
+    readIndex = 0;
+
+    if (droppedFrames > 0) LOG_MESSAGE(LOG_LEVEL_INFO, LOG_CATEGORY_CAPTURE, "%i frames skipped, capture buffers were busy", droppedFrames);
+}
+
+void SetGifCaptureFramerate(int fps)
+{
+    if (fps < 1) fps = 1;
+    if (fps > 50) fps = 50;     // GIF frame delays are in centiseconds, most viewers clamp anything faster
+    gifFrameTime = 1.0/fps;
+}
+
+void RequestScreenshot(void)
+{
+    screenshotRequested = true;
+}
+
+void ToggleGifRecording(void)
+{
+    if (gifRecording)
+    {
+        gifRecording = false;
+        gifStopPending = true;
+        LOG_MESSAGE(LOG_LEVEL_INFO, LOG_CATEGORY_CAPTURE, "Finish animated GIF recording");
+    }
+    else if (!gifStopPending)
+    {
+        gifRecording = true;
+        GetCaptureSize(&gifWidth, &gifHeight);
+        gifNextCaptureTime = GetTime();
+        gifLastCaptureTime = gifNextCaptureTime;
+        snprintf(gifFileName, sizeof(gifFileName), "screenrec%03i.gif", captureCounter);
+        ++captureCounter;
+        LOG_MESSAGE(LOG_LEVEL_INFO, LOG_CATEGORY_CAPTURE, "Start animated GIF recording: %s", gifFileName);
+    }
+}
+
+bool IsGifRecording(void)
+{
+    return gifRecording;
+}
+
+void CaptureScreen(void)
+{
+    double currentTime = GetTime();
+
+    if (gifStopPending)
+    {
+        CaptureBuffer *buffer = AcquireCaptureBuffer(0, 0);
+        if (buffer != NULL)
+        {
+            buffer->kind = CAPTURE_GIF_END;
+            strcpy(buffer->fileName, gifFileName);
+            SubmitCaptureBuffer(buffer);
+            gifStopPending = false;
+        }
+    }
+
+    bool captureGifFrame = gifRecording && (currentTime >= gifNextCaptureTime);
+    if (screenshotRequested || captureGifFrame)
+    {
+        rlDrawRenderBatchActive();      // Make sure everything drawn so far is in the framebuffer
+
+        int width = 0;
+        int height = 0;
+        GetCaptureSize(&width, &height);
+
+        if (screenshotRequested)
+        {
+            CaptureBuffer *buffer = AcquireCaptureBuffer(width, height);
+            if (buffer != NULL)
+            {
+                rlReadScreenPixelsToBuffer(buffer->data, width, height);
+                buffer->kind = CAPTURE_SCREENSHOT;
+                snprintf(buffer->fileName, sizeof(buffer->fileName), "screenshot%03i.png", captureCounter);
+                ++captureCounter;
+                SubmitCaptureBuffer(buffer);
+            }
+            else LOG_MESSAGE(LOG_LEVEL_WARNING, LOG_CATEGORY_CAPTURE, "Screenshot skipped, capture buffers are busy");
+            screenshotRequested = false;
+        }
+
+        if (captureGifFrame)
+        {
+            // NOTE: GIF frames must keep the size the recording started with, frames of a resized window are skipped
+            CaptureBuffer *buffer = ((width == gifWidth) && (height == gifHeight))? AcquireCaptureBuffer(width, height) : NULL;
+            if (buffer != NULL)
+            {
+                rlReadScreenPixelsToBuffer(buffer->data, width, height);
+                buffer->kind = CAPTURE_GIF_FRAME;
+                buffer->centiSeconds = (int)((currentTime - gifLastCaptureTime)*100.0 + 0.5);
+                if (buffer->centiSeconds < 2) buffer->centiSeconds = 2;
+                SubmitCaptureBuffer(buffer);
+                gifLastCaptureTime = currentTime;
+            }
+            else ++droppedFrames;
+
+            gifNextCaptureTime += gifFrameTime;
+            if (gifNextCaptureTime < currentTime) gifNextCaptureTime = currentTime + gifFrameTime;
+        }
+    }
+
+    // Draw record indicator, after the capture so it never shows up in the recording
+    if (gifRecording && (((int)(currentTime*2.0))%2 == 1))
+    {
+        DrawCircle(30, GetScreenHeight() - 20, 10, MAROON);
+        DrawText("GIF RECORDING", 50, GetScreenHeight() - 25, 10, RED);
+    }
+}
@@ -0,0 +1,36 @@
+/**********************************************************************************************
+*
+*   Minesweeper Clone - Screen Capture
+*
+*   Screenshots (F12) and GIF recording (CTRL+F12) that never stall the game loop:
+*   the render thread only copies the framebuffer once into a ring of buffers, flipping,
+*   quantization, PNG/GIF encoding and file writes happen on a worker thread.
+*   When every buffer is still busy, the frame is skipped instead of waiting.
+*
+*   Copyright (c) 2024 (DoughnutDude)
+*
+**********************************************************************************************/
+
+#ifndef SCREEN_CAPTURE_H
+#define SCREEN_CAPTURE_H
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define CAPTURE_BUFFER_COUNT        4       // Framebuffer copies in flight to the worker
+#define DEFAULT_GIF_FRAMERATE       15      // GIF frames captured per second
+
+//----------------------------------------------------------------------------------
+// Screen Capture Functions Declaration
+//----------------------------------------------------------------------------------
+void InitScreenCapture(void);               // Start the capture worker thread
+void CloseScreenCapture(void);              // Finish pending captures (saving any GIF in progress) and stop the worker
+
+void SetGifCaptureFramerate(int fps);       // Set GIF frames captured per second
+void RequestScreenshot(void);               // Take a screenshot of the current frame
+void ToggleGifRecording(void);              // Start/stop GIF recording
+bool IsGifRecording(void);
+
+void CaptureScreen(void);                   // Copy the current frame if requested, call after drawing, before EndDrawing()
+
+#endif // SCREEN_CAPTURE_H
@@ -52,26 +52,30 @@ void InitEndingScreen(void)
 // Ending Screen Update logic
 void UpdateEndingScreen(void)
 {
+    PROFILE_FUNCTION();
+
     // TODO: Update ENDING screen variables here!
 
     // Press enter or tap to return to TITLE screen
     if (IsKeyPressed(KEY_ENTER) || IsGestureDetected(GESTURE_TAP))
     {
         finishResult = 1;
-        PlaySound(fxCoin);
+        PlaySfx(SFX_UI);
     }
 }
 
 // Ending Screen Draw logic
 void DrawEndingScreen(void)
 {
+    PROFILE_FUNCTION();
+
     // TODO: Draw ENDING screen here!
     DrawRectangle(0, 0, GetScreenWidth(), GetScreenHeight(), BLUE);
 
     Vector2 pos = { 20, 10 };
     DrawTextEx(font, "ENDING SCREEN", pos, font.baseSize, font.glyphPadding, DARKBLUE);
     pos = { 120, 220 };
-    DrawTextEx(font, "PRESS ENTER or TAP to RETURN to TITLE SCREEN", pos, 20, font.glyphPadding, DARKBLUE);
+    DrawTextEx(GetFontForSize(&fontAtlases, 20), "PRESS ENTER or TAP to RETURN to TITLE SCREEN", pos, 20, font.glyphPadding, DARKBLUE);
 }
 
 // Ending Screen Unload logic
@@ -31,6 +31,12 @@
 
 #include "raylib.h"
 #include "screens.h"
+#include "input_latency.h"
+#include "game_sim.h"
+#include "net_client.h"
+#include "opponent_wall.h"
+#include "board_sync.h"     // Required for: GetTileCode()
+#include <string.h>         // Required for: memset()
 //#include "raymath.h"
 
 //----------------------------------------------------------------------------------
@@ -38,21 +44,31 @@
 //----------------------------------------------------------------------------------
 global_var int framesCounter = 0;
 global_var int finishResult = 0;
-global_var float dt = 0.0f;
 
-bool winCon;
-int hp = startingHP;
-int actionCount = 0;
+// NOTE: The game runs on the simulation thread, the screen draws its latest snapshot
+global_var const GameSnapshot *snapshot = NULL;
+global_var const GameState *game = NULL;
+global_var int boardId = 0;                 // Board of this screen, older snapshots show the previous one
+global_var int actionsSent = 0;             // Actions pushed to the simulation, including previous boards
+global_var int actionsSeen = 0;             // Actions reported applied to the latency tracker
+global_var int sfxSeen[SFX_CATEGORY_COUNT] = { 0 };
+
+// NOTE: Multiplayer boards come from the network client instead, predicted locally (see net_client.h)
+global_var bool networked = false;
+global_var bool spectating = false;         // Watching a match, any player board can be shown
+
+// Board drawn into a texture, tiles are only drawn again once they look different
+global_var RenderTexture2D boardCache = { 0 };
+global_var signed char boardCacheTiles[maxBoardHeight][maxBoardWidth];     // TileCode drawn, -1 = not drawn yet
+global_var unsigned int boardCacheVersion = 0;
+global_var bool boardCacheValid = false;
 
 Vector2 screenCenter = { 0 };
 Vector2 cameraPos = { 0 };
+Vector2 previousCameraPos = { 0 }; // Camera position on the previous tick, used for render interpolation
 Camera2D camera = { 0 };
 Rectangle player = { 0 };
 
-int mineCount = 0;
-int maxMines = 0;
-//int board[maxBoardHeight][maxBoardWidth] = { 0 }; // -2 = mine(clicked on), -1 = mine, non-negative = number of adjacent mines
-//int boardMask[maxBoardHeight][maxBoardWidth] = { 0 }; // 0 = revealed, 1 = hidden, 2 = flagged
 Rectangle boardRect = { 0 };
 float tileSize = 40.0f;
 Vector2 boardCenter = { 0 };
@@ -61,163 +77,193 @@ int textSize = 0;
 //----------------------------------------------------------------------------------
 // Gameplay Screen Functions Definition
 //----------------------------------------------------------------------------------
-int DetectMinesTouchingTile(int x, int y)
+Rectangle MakeRectFromTile(int x, int y)
 {
-    int result = 0;
-    for (int offsetY = -1; offsetY < 2; ++offsetY)
-    {
-        for (int offsetX = -1; offsetX < 2; ++offsetX)
-        {
-            if (!((offsetX == 0) && (offsetY == 0)))
-            {
-                int neighborX = x + offsetX;
-                int neighborY = y + offsetY;
-                if ((neighborX < boardWidth) && (neighborX >= 0) &&
-                    (neighborY < boardHeight) && (neighborY >= 0) &&
-                    board[neighborY][neighborX] < 0)
-                {
-                    ++result;
-                }
-            }
-        }
-    }
+    Rectangle result = { x * tileSize,
+                         y * tileSize,
+                         tileSize, tileSize };
     return result;
 }
 
-// Increment the clue count of each adjacent tile to let them know that they are touching a mine (board[y][x]).
-void PingTilesTouchingMine(int x, int y)
+// Queue a board action for the tick its input event happened on
+internal void QueueGameplayAction(GameActionType type, Vector2 mousePos, double eventTime)
 {
-    for (int offsetY = -1; offsetY < 2; ++offsetY)
+    if (!CheckCollisionPointRec(mousePos, boardRect)) return;
+
+    GameAction action = { 0 };
+    action.tick = GetSimulationTick(eventTime);
+    action.type = type;
+    action.x = (int)(mousePos.x/tileSize);
+    action.y = (int)(mousePos.y/tileSize);
+
+    if (networked)
     {
-        for (int offsetX = -1; offsetX < 2; ++offsetX)
+        // Predicted right away, results only correct the board when the prediction was wrong
+        int previousHP = game->hp;
+        if (SendNetClientAction(action))
         {
-            if (!((offsetX == 0) && (offsetY == 0)))
-            {
-                int neighborX = x + offsetX;
-                int neighborY = y + offsetY;
-                if ((neighborX < boardWidth) && (neighborX >= 0) &&
-                    (neighborY < boardHeight) && (neighborY >= 0) &&
-                    board[neighborY][neighborX] >= 0)
-                {
-                    ++board[neighborY][neighborX];
-                }
-            }
+            BeginInputLatency(eventTime);
+            MarkInputLatencyApplied(1);
+
+            if (game->hp < previousHP) PlaySfx(SFX_MINE);
+            else if (type == ACTION_REVEAL) PlaySfx(SFX_REVEAL);
+            else if (type == ACTION_CHORD) PlaySfx(SFX_CHORD);
+            else if (type == ACTION_FLAG) PlaySfx(SFX_FLAG);
         }
     }
+    else if (PushSimulationAction(action))
+    {
+        BeginInputLatency(eventTime);
+        ++actionsSent;
+    }
 }
 
-void GenerateMinesRecursively(int x, int y)
+// Pick up the latest simulation snapshot, reporting what it applied since the last one
+internal void UpdateGameplaySnapshot(void)
 {
-    if (board[y][x] < 0 || mineCount >= maxMines)
+    if (networked)
     {
+        UpdateNetClient(GetTime());
+        game = GetNetClientGame();
         return;
     }
-    board[y][x] = -1;
-    ++mineCount;
-    PingTilesTouchingMine(x, y);
-    int offsetX = GetRandomValue(-1, 2);
-    int offsetY = GetRandomValue(-1, 2);
-    while (((offsetX == 0) && (offsetY == 0)))
-    {
-        offsetX = GetRandomValue(-1, 2);
-        offsetY = GetRandomValue(-1, 2);
-    }
-    int neighborX = x + offsetX;
-    int neighborY = y + offsetY;
-    if ((neighborX < boardWidth) && (neighborX >= 0) &&
-        (neighborY < boardHeight) && (neighborY >= 0))
+
+    snapshot = GetGameSnapshot();
+    game = &snapshot->state;
+
+    MarkInputLatencyApplied(snapshot->actionsProcessed - actionsSeen);
+    if (snapshot->actionsProcessed > actionsSeen) actionsSeen = snapshot->actionsProcessed;
+
+    for (int category = 0; category < SFX_CATEGORY_COUNT; ++category)
     {
-        GenerateMinesRecursively(neighborX, neighborY);
+        for (; sfxSeen[category] < snapshot->sfxTriggers[category]; ++sfxSeen[category]) PlaySfx((SfxCategory)category);
     }
 }
 
-void FloodFillClearTilesRecursively(int x, int y) //TODO: non-recursive solution. Currently fails for boards that are large + sparse.
+// Draw one tile as it looks on the board, pressed = hidden tile held down by a click
+internal void DrawBoardTile(int x, int y, bool pressed, Font tileFont)
 {
-    if (((x < boardWidth) && (x >= 0) && (y < boardHeight) && (y >= 0)) && (board[y][x] >= 0) && (boardMask[y][x] == 1))
-    {
-        boardMask[y][x] = 0;
+    Rectangle boardTile = MakeRectFromTile(x, y);
+    Color tileColor = { 120,120,120,255 };
+    Color textColor = BLACK;
+    char tileTextSymbol[8];     // NOTE: Sized for any signed char clue, "-128\n"
 
-        if (board[y][x] > 0) return;
-
-#if 1
-        for (int offsetY = -1; offsetY < 2; ++offsetY)
+    if (game->boardMask[y][x] > 0) // Draw hidden tiles
+    {
+        textColor = { 0,0,0,0 };
+        if (!pressed)
         {
-            for (int offsetX = -1; offsetX < 2; ++offsetX)
+            tileColor = { 150,150,150,255 };
+            if (game->boardMask[y][x] == 2)
             {
-                if (!((offsetX == 0) && (offsetY == 0)))
-                {
-                    int neighborX = x + offsetX;
-                    int neighborY = y + offsetY;
-                    if ((neighborX < boardWidth) && (neighborX >= 0) &&
-                        (neighborY < boardHeight) && (neighborY >= 0) &&
-                        (boardMask[neighborY][neighborX] == 1 || (board[neighborY][neighborX] >= 0)))
-                    {
-                        FloodFillClearTilesRecursively(neighborX, neighborY);
-                    }
-                }
+                sprintf(tileTextSymbol, "F\n");
+                textColor = BROWN; // Draw flag
             }
         }
-#else //just the same thing, but with if-else's instead of loops
-        if (x < boardWidth)
-        {
-            FloodFillClearTilesRecursively(x + 1, y);//east
-            if (y >= 0)
-            {
-                FloodFillClearTilesRecursively(x + 1, y - 1);//north-east
-            } else return;
-        } else return;
-        if (x >= 0)
-        {
-            FloodFillClearTilesRecursively(x - 1, y);//west
-            if (y < boardHeight)
-            {
-                FloodFillClearTilesRecursively(x - 1, y + 1);//south-west
-            } else return;
-        } else return;
-        if (y < boardHeight)
-        {
-            FloodFillClearTilesRecursively(x, y + 1);//south
-            if (x < boardWidth)
-            {
-                FloodFillClearTilesRecursively(x + 1, y + 1);//south-east
-            } else return;
-        } else return;
-        if (y >= 0)
-        {
-            FloodFillClearTilesRecursively(x, y - 1);//north
-            if (x >= 0)
-            {
-                FloodFillClearTilesRecursively(x - 1, y - 1);//north-west
-            } else return;
-        } else return;
-#endif
     }
-}
-
-void AttemptTileReveal(int x, int y)
-{
-    if (boardMask[y][x] == 1)
+    else if (game->boardMask[y][x] == 0) // Draw revealed tiles
     {
-        switch (board[y][x])
+        sprintf(tileTextSymbol, "%d\n", game->board[y][x]);
+        switch (game->board[y][x])
         {
+        case -2:
+            tileColor = DARKBROWN;
         case -1:
-            --hp;
-            board[y][x] = -2; // The mine has now been clicked/stepped on.
+            textColor = { 255,255,255,255 };
+            sprintf(tileTextSymbol, "#\n");
+            break;
         case 0:
-            // If a tile is touching 0 mines, then it clears tiles until mines are detected.
-            FloodFillClearTilesRecursively(x, y);
-        default:
-            boardMask[y][x] = 0;
+            textColor = { 0,0,0,0 };
+            break;
+        case 1:
+            textColor = { 0,0,255,255 };
+            break;
+        case 2:
+            textColor = { 00,90,00,255 };
+            break;
+        case 3:
+            textColor = { 200,00,00,255 };
+            break;
+        case 4:
+            textColor = { 00,00,90,255 };
+            break;
+        case 5:
+            textColor = { 90,10,10,255 };
+            break;
+        case 6:
+            textColor = { 03,82,84,255 };
+            break;
+        case 7:
+            textColor = { 10,10,10,255 };
+            break;
+        case 8:
+            textColor = { 75,75,75,255 };
+            break;
         }
     }
+    else // Draw incorrectly flagged tiles when the game ends.
+    {
+        tileColor = { 150,150,150,255 };
+        textColor = DARKBROWN;
+        sprintf(tileTextSymbol, "X\n");
+    }
+    DrawRectangle(boardTile.x, boardTile.y, tileSize, tileSize, tileColor);
+    tileColor.r -= 20;
+    tileColor.g -= 20;
+    tileColor.b -= 20;
+    DrawRectangleLines(boardTile.x, boardTile.y, tileSize, tileSize, tileColor);
+    if (textColor.a > 0)
+    {
+        DrawTextEx(tileFont, tileTextSymbol, { boardTile.x + tileSize / 3, boardTile.y + tileSize / 10 },
+            textSize, font.glyphPadding, textColor);
+    }
 }
 
-Rectangle MakeRectFromTile(int x, int y)
+// Draw the tiles that changed since the last update into the board texture
+// NOTE: Compared by look (TileCode), a rolled back prediction only redraws the tiles it got wrong
+internal void UpdateBoardCache(unsigned int version)
 {
-    Rectangle result = { x * tileSize,
-                         y * tileSize,
-                         tileSize, tileSize };
-    return result;
+    PROFILE_FUNCTION();
+
+    int cacheWidth = (int)(tileSize*game->width);
+    int cacheHeight = (int)(tileSize*game->height);
+    if (!IsRenderTextureReady(boardCache) || (boardCache.texture.width != cacheWidth) || (boardCache.texture.height != cacheHeight))
+    {
+        // NOTE: A board grown taller (garbage rows) keeps what is drawn, only its new rows are drawn below
+        RenderTexture2D previous = boardCache;
+        bool grown = boardCacheValid && IsRenderTextureReady(previous) && (previous.texture.width == cacheWidth) && (previous.texture.height < cacheHeight);
+        boardCache = LoadRenderTexture(cacheWidth, cacheHeight);
+        if (grown)
+        {
+            BeginTextureMode(boardCache);
+            ClearBackground(BLANK);
+            DrawTextureRec(previous.texture, { 0, 0, (float)previous.texture.width, -(float)previous.texture.height }, { 0, 0 }, WHITE);
+            EndTextureMode();
+            for (int y = (int)(previous.texture.height/tileSize); y < maxBoardHeight; ++y) memset(boardCacheTiles[y], -1, maxBoardWidth);
+        }
+        else boardCacheValid = false;
+        if (IsRenderTextureReady(previous)) UnloadRenderTexture(previous);
+    }
+    if (boardCacheValid && (version == boardCacheVersion)) return;
+    if (!boardCacheValid) memset(boardCacheTiles, -1, sizeof(boardCacheTiles));
+
+    Font tileFont = GetFontForSize(&fontAtlases, textSize);
+    BeginTextureMode(boardCache);
+    for (int y = 0; y < game->height; ++y)
+    {
+        for (int x = 0; x < game->width; ++x)
+        {
+            signed char code = (signed char)GetTileCode(game, x, y);
+            if (boardCacheTiles[y][x] == code) continue;
+
+            DrawBoardTile(x, y, false, tileFont);
+            boardCacheTiles[y][x] = code;
+        }
+    }
+    EndTextureMode();
+
+    boardCacheVersion = version;
+    boardCacheValid = true;
 }
 
 //
@@ -226,13 +272,6 @@ void InitGameplayScreen(void)
 {
     framesCounter = 0;
     finishResult = 0;
-    dt = GetFrameTime();
-    timeStart = 0;
-    timer = 0;
-
-    winCon = false;
-    hp = startingHP;
-    actionCount = 0;
 
     screenCenter.x = (float)GetScreenWidth() / 2.0f;
     screenCenter.y = (float)GetScreenHeight() / 2.0f;
@@ -241,6 +280,7 @@ void InitGameplayScreen(void)
     boardRect = { 0, 0, (tileSize * boardWidth), (tileSize * boardHeight) };
 
     cameraPos = boardCenter;
+    previousCameraPos = cameraPos;
 
     camera.target = cameraPos;
     camera.offset = screenCenter;
@@ -249,90 +289,70 @@ void InitGameplayScreen(void)
 
     textSize = 0.8f * (float)tileSize;
 
-    // init board
-    mineCount = 0;
-    if (!mineGenMode)
-    {
-        maxMines = (float)mineDensity/100.0f * (boardWidth * boardHeight);
-    }
-    else
-    {
-        maxMines = minesDesired; 
-    }
-    if (maxMines >= boardWidth * boardHeight)
-    {
-        maxMines = boardWidth * boardHeight - 1;
-    }
+    boardCacheValid = false;
+    CancelPendingInputLatency();
 
-    for (int y = 0; y < boardHeight; ++y)
+    networked = (serverAddress != NULL);
+    spectating = networked && serverSpectate;
+    if (networked)
     {
-        for (int x = 0; x < boardWidth; ++x)
+        bool connected = spectating? SpectateNetClient(serverAddress, serverPort, serverMatch) : ConnectNetClient(serverAddress, serverPort, serverRating, GameSettings{ 0 });
+        if (!connected)
         {
-            board[y][x] = 0;     // Clear board every time we load in.
-            boardMask[y][x] = 1; // Set this to 0 to start with board revealed.
-        }
-    }
-#if 1
-    int x = GetRandomValue(0, boardWidth-1);
-    int y = GetRandomValue(0, boardHeight-1);
-    GenerateMinesRecursively(x, y);
-    while (mineCount < maxMines)
-    {
-        x = GetRandomValue(0, boardWidth - 1);
-        y = GetRandomValue(0, boardHeight - 1);
-        if (board[y][x] >= 0)
-        {
-            board[y][x] = -1;
-            ++mineCount;
-            PingTilesTouchingMine(x, y);
-        }
-    }
-#else
-    for (int y = 0; y < boardHeight; ++y)
-    {
-        for (int x = 0; x < boardWidth; ++x)
-        {
-            // TODO: Parameterize board generation for the possibility of
-            //no-guess modes, adjustable mine density, dynamic procedural/random gen, etc.
-            int randVal = GetRandomValue(0,5); // ~20% mine density. Less consistent as density value goes down.
-            if (!randVal) {
-                board[y][x] = -1;
-                ++mineCount;
-                PingTilesTouchingMine(x, y);
-            }
+            LOG_MESSAGE(LOG_LEVEL_ERROR, LOG_CATEGORY_GAME, "Can not connect to server %s:%i", serverAddress, serverPort);
         }
+        game = GetNetClientGame();
+        return;
     }
-#endif
-    char str[16];
-    sprintf(str, "mines: %d\n",mineCount);
-    printf(str);
+
+    // init board
+    GameSettings settings = { 0 };
+    settings.width = boardWidth;
+    settings.height = boardHeight;
+    settings.mineDensity = mineDensity;
+    settings.minesDesired = minesDesired;
+    settings.mineGenMode = mineGenMode;
+    settings.startingHP = startingHP;
+    settings.seed = (unsigned int)time(NULL) ^ (unsigned int)(GetTime()*1000000.0);
+    boardId = StartSimulationGame(settings, GetTime());
+
+    // Actions of the previous board still on their way are not reported, sounds they trigger still play
+    snapshot = GetGameSnapshot();
+    game = &snapshot->state;
+    actionsSeen = actionsSent;
+    for (int category = 0; category < SFX_CATEGORY_COUNT; ++category) sfxSeen[category] = snapshot->sfxTriggers[category];
+
+    LOG_DEBUG_MESSAGE(LOG_CATEGORY_GAME, "New board %ix%i, seed %u", settings.width, settings.height, settings.seed);
 }
 
 // Gameplay Screen Update logic
 void UpdateGameplayScreen(void)
 {
+    PROFILE_FUNCTION();
+
 #if 1
     ++framesCounter;
-    dt = GetFrameTime();
-    if (!winCon && (hp > 0) && (timer < 10000) && timeStart)
+
+    UpdateGameplaySnapshot();
+
+    // Multiplayer board size is only known once the match starts, garbage rows then make it taller under the camera
+    if (networked && ((boardCenter.x != tileSize*game->width/2.0f) || (boardCenter.y != tileSize*game->height/2.0f)))
     {
-        timer = GetTime() - timeStart;
+        bool grown = (game->startTick >= 0) && (boardCenter.x == tileSize*game->width/2.0f) && (boardCenter.y < tileSize*game->height/2.0f);
+        boardCenter = { tileSize*game->width/2.0f, tileSize*game->height/2.0f };
+        if (!grown)
+        {
+            cameraPos = boardCenter;
+            previousCameraPos = cameraPos;
+        }
     }
 
     screenCenter.x = (float)GetScreenWidth() / 2;
     screenCenter.y = (float)GetScreenHeight() / 2;
     camera.offset = screenCenter;
 
-    boardRect = { 0, 0, (tileSize * boardWidth),
-                  (tileSize * boardHeight) };
-
-    float scrollSpeedX = 3.0f;
-    float scrollSpeedY = 3.0f;
-
-    if (IsKeyDown(KEY_W)) cameraPos.y -= scrollSpeedY;
-    if (IsKeyDown(KEY_S)) cameraPos.y += scrollSpeedY;
-    if (IsKeyDown(KEY_A)) cameraPos.x -= scrollSpeedX;
-    if (IsKeyDown(KEY_D)) cameraPos.x += scrollSpeedX;
+    boardRect = { 0, 0, (tileSize * game->width),
+                  (tileSize * game->height) };
 
 #if 0 // For camera rotation. Would need adjustment of mouse coords.
     if (IsKeyDown(KEY_E)) camera.rotation--;
@@ -347,224 +367,82 @@ void UpdateGameplayScreen(void)
     else if (camera.zoom < 0.1f) camera.zoom = 0.1f;
 #endif
 
-    if (IsKeyPressed(KEY_R))
+    // Mouse capture
+    // NOTE: Every click of the frame is queued in order, mapped to a tile at its own cursor position
+    // with the camera the player was looking at when clicking (the one drawn last frame)
+    MouseButtonEvent event = { 0 };
+    while (GetMouseButtonEvent(&event))
     {
-        if (IsKeyDown(KEY_LEFT_CONTROL))
-        {
-            InitGameplayScreen();
-        }
-        cameraPos = boardCenter;
+        Vector2 mousePos = event.position + camera.target - camera.offset;
+        if ((event.button == MOUSE_BUTTON_LEFT) && !event.pressed) QueueGameplayAction(ACTION_REVEAL, mousePos, event.time);
+        else if ((event.button == MOUSE_BUTTON_RIGHT) && event.pressed) QueueGameplayAction(ACTION_FLAG, mousePos, event.time);
+        else if ((event.button == MOUSE_BUTTON_MIDDLE) && !event.pressed) QueueGameplayAction(ACTION_CHORD, mousePos, event.time);
     }
-    camera.target = cameraPos;
-
-#if 0
-    if (((framesCounter) % 7) == 0) {
-        --origin.y; //this is where we'd do the scrolling stuff
+    if (spectating) // Watch the previous or next player
+    {
+        int count = GetNetClientPlayerCount();
+        if ((count > 0) && IsKeyPressed(KEY_RIGHT)) SetNetClientWatchedPlayer((GetNetClientPlayer() + 1)%count);
+        if ((count > 0) && IsKeyPressed(KEY_LEFT)) SetNetClientWatchedPlayer((GetNetClientPlayer() + count - 1)%count);
     }
-#endif
-
-    // Mouse capture
-    if (hp > 0)
+    if (IsKeyPressed(KEY_P) && !networked) // Reveals entire board.
     {
-        if (IsKeyPressed(KEY_P)) // Reveals entire board.
+        GameAction action = { 0 };
+        action.tick = GetSimulationTick(GetTime());
+        action.type = ACTION_REVEAL_ALL;
+        if (PushSimulationAction(action))
         {
-            for (int y = 0; y < boardHeight; ++y)
-            {
-                for (int x = 0; x < boardWidth; ++x)
-                {
-                    boardMask[y][x] = 0;
-                }
-            }
-        }
-        bool clickL = IsMouseButtonReleased(MOUSE_BUTTON_LEFT);
-        bool clickR = IsMouseButtonPressed(MOUSE_BUTTON_RIGHT);
-        bool clickM = IsMouseButtonReleased(MOUSE_BUTTON_MIDDLE);
-        Vector2 mousePos = GetMousePosition() + camera.target - camera.offset;
-        if (clickL != clickR != clickM)
-        {
-            if (CheckCollisionPointRec(mousePos, boardRect))
-            {
-                int x = (mousePos.x)/tileSize;
-                int y = (mousePos.y)/tileSize;
-                Rectangle boardTile;
-
-                if (clickL && boardMask[y][x] == 1)
-                {
-                    if (!timeStart)
-                    {
-                        timeStart = GetTime();
-                        printf("bepis\n");//debug output
-                    }
-                    ++actionCount;
-                    printf("ac %d\n", actionCount);//debug output
-                    if (actionCount == 1) // Move mines away from first click and its adjacent tiles.
-                    {
-                        for (int offsetY = -1; offsetY < 2; ++offsetY)
-                        {
-                            for (int offsetX = -1; offsetX < 2; ++offsetX)
-                            {
-                                int neighborX = x + offsetX;
-                                int neighborY = y + offsetY;
-                                if ((neighborX < boardWidth) && (neighborX >= 0) &&
-                                    (neighborY < boardHeight) && (neighborY >= 0) &&
-                                    board[neighborY][neighborX] < 0)
-                                {
-                                    bool mineMovedSuccessfully = false;
-                                    int iter = 0;
-                                    while (!mineMovedSuccessfully && (iter < 300))
-                                    {
-                                        ++iter;
-                                        int newX = GetRandomValue(0, boardWidth-1);
-                                        int newY = GetRandomValue(0, boardHeight-1);
-                                        // Make sure new random tile is not in neighborhood
-                                        if (!((newX <= x + 1) && (newX >= x - 1) &&
-                                            (newY <= y + 1) && (newY >= y - 1)) &&
-                                            board[newY][newX] != -1)
-                                        {
-                                            board[neighborY][neighborX] = DetectMinesTouchingTile(neighborX, neighborY);
-                                            for (int offsetY2 = -1; offsetY2 < 2; ++offsetY2)
-                                            {
-                                                for (int offsetX2 = -1; offsetX2 < 2; ++offsetX2)
-                                                {
-                                                    if (!((offsetX2 == 0) && (offsetY2 == 0)))
-                                                    {
-                                                        int neighborX2 = neighborX + offsetX2;
-                                                        int neighborY2 = neighborY + offsetY2;
-                                                        if ((neighborX2 < boardWidth) && (neighborX2 >= 0) &&
-                                                            (neighborY2 < boardHeight) && (neighborY2 >= 0) &&
-                                                            board[neighborY2][neighborX2] > 0)
-                                                        {
-                                                            --board[neighborY2][neighborX2];
-                                                        }
-                                                    }
-                                                }
-                                            }
-                                            board[newY][newX] = -1;
-                                            PingTilesTouchingMine(newX, newY);
-                                            mineMovedSuccessfully = true;
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                    AttemptTileReveal(x, y);
-                }
-                else if (clickR)
-                {
-                    if (boardMask[y][x] == 1)
-                    {
-                        //++actionCount;
-                        //printf("ac %d\n", actionCount);//debug output
-                        boardMask[y][x] = 2;
-                    }
-                    else if (boardMask[y][x] == 2)
-                    {
-                        //++actionCount;
-                        //printf("ac %d\n", actionCount);//debug output
-                        boardMask[y][x] = 1;
-                    }
-                }
-                else if (clickM && boardMask[y][x] == 0)
-                {
-                    // [Chording]:
-                    // First make sure that the number of adjacent flagged/mine-havin tiles
-                    //is the same as the number in the clicked tile's value.
-                    int numOfAdjacentFlags = 0;
-                    for (int offsetY = -1; offsetY < 2; ++offsetY)
-                    {
-                        for (int offsetX = -1; offsetX < 2; ++offsetX)
-                        {
-                            if (!((offsetX == 0) && (offsetY == 0)))
-                            {
-                                int neighborX = x + offsetX;
-                                int neighborY = y + offsetY;
-                                if ((neighborX < boardWidth) && (neighborX >= 0) &&
-                                    (neighborY < boardHeight) && (neighborY >= 0) &&
-                                    (boardMask[neighborY][neighborX] == 2 || (board[neighborY][neighborX] == -2) ||
-                                    (boardMask[neighborY][neighborX] == 0 && board[neighborY][neighborX] == -1)))
-                                {
-                                    ++numOfAdjacentFlags;
-                                }
-                            }
-                        }
-                    }
-                    // Then reveal all adjacent tiles
-                    if (numOfAdjacentFlags == board[y][x])
-                    {
-                        ++actionCount;
-                        printf("ac %d\n", actionCount);//debug output
-                        for (int offsetY = -1; offsetY < 2; ++offsetY)
-                        {
-                            for (int offsetX = -1; offsetX < 2; ++offsetX)
-                            {
-                                if (!((offsetX == 0) && (offsetY == 0)))
-                                {
-                                    int neighborX = x + offsetX;
-                                    int neighborY = y + offsetY;
-                                    if ((neighborX < boardWidth) && (neighborX >= 0) &&
-                                        (neighborY < boardHeight) && (neighborY >= 0))
-                                    {
-                                        AttemptTileReveal(neighborX, neighborY);
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-                // Check for win condition after every mouse click.
-                //if all non-mine spaces have been revealed, winCon = true.
-                // Maybe broken? saw a weird bug once with premature win while not all tiles had yet been revealed.
-                winCon = true;
-                for (int y = 0; y < boardHeight; ++y)
-                {
-                    for (int x = 0; x < boardWidth; ++x)
-                    {
-                        if (!(boardMask[y][x] == 0 || board[y][x] < 0))
-                        {
-                            winCon = false;
-                            break;
-                        }
-                    }
-                }
-                winCon = winCon && (hp > 0); // We also make sure that the player has health remaining.
-            }
+            BeginInputLatency(GetTime());
+            ++actionsSent;
         }
     }
 
-    // When game is done, regardless of win or lose, all mines should be revealed.
-    if ((hp <= 0) || winCon)
+    if (IsKeyPressed(KEY_R))
     {
-        for (int y = 0; y < boardHeight; ++y)
+        if (IsKeyDown(KEY_LEFT_CONTROL))
         {
-            for (int x = 0; x < boardWidth; ++x)
-            {
-                if ((board[y][x] < 0) && (boardMask[y][x] != 2))
-                {
-                    boardMask[y][x] = 0;
-                }
-                else if ((board[y][x] >= 0) && boardMask[y][x] == 2)
-                {
-                    // All incorrectly flagged spaces should also be revealed.
-                    boardMask[y][x] = -1;
-                }
-            }
+            InitGameplayScreen();
         }
+        cameraPos = boardCenter;
+        previousCameraPos = cameraPos;
     }
 
     // Press enter or tap to change to ENDING screen
     if (IsKeyPressed(KEY_ESCAPE))
     {
         finishResult = (int)OPTIONS;
-        PlaySound(fxCoin);
+        PlaySfx(SFX_UI);
     }
 #endif
 }
 
+// Gameplay Screen fixed-timestep logic, called SIM_TICK_RATE times per second
+// NOTE: Only the camera, the game itself ticks on the simulation thread
+void TickGameplayScreen(void)
+{
+    PROFILE_FUNCTION();
+
+    previousCameraPos = cameraPos;
+
+    float scrollSpeedX = 180.0f*(float)SIM_TICK_TIME;   // Pixels per second
+    float scrollSpeedY = 180.0f*(float)SIM_TICK_TIME;
+
+    if (IsKeyDown(KEY_W)) cameraPos.y -= scrollSpeedY;
+    if (IsKeyDown(KEY_S)) cameraPos.y += scrollSpeedY;
+    if (IsKeyDown(KEY_A)) cameraPos.x -= scrollSpeedX;
+    if (IsKeyDown(KEY_D)) cameraPos.x += scrollSpeedX;
+}
+
 // Gameplay Screen Draw logic
 void DrawGameplayScreen(void)
 {
+    PROFILE_FUNCTION();
+
 #if 1
+    UpdateGameplaySnapshot();   // NOTE: Again, results of actions sent this frame may be in already
+
+    // Render the camera between the last two simulation ticks
+    camera.target = previousCameraPos + simAlpha*(cameraPos - previousCameraPos);
+
     Vector2 mousePos = {};
     bool clickL = IsMouseButtonDown(MOUSE_BUTTON_LEFT);
     bool clickM = IsMouseButtonDown(MOUSE_BUTTON_MIDDLE);
@@ -574,145 +452,111 @@ void DrawGameplayScreen(void)
     }
 
     DrawRectangle(0, 0, GetScreenWidth(), GetScreenHeight(), DARKGRAY); // Draw backdrop
+    if (networked && (GetNetClientState() == NET_CLIENT_WAITING))
+    {
+        DrawTextEx(font, "Waiting for players...", { screenCenter.x - 180, screenCenter.y - 20 }, font.baseSize, font.glyphPadding, BEIGE);
+        return;
+    }
+    if (networked && (game->width == 0))
+    {
+        DrawTextEx(font, "Server not reachable, ctrl+r to retry", { screenCenter.x - 300, screenCenter.y - 20 }, font.baseSize, font.glyphPadding, BEIGE);
+        return;
+    }
+    if (!networked && (snapshot->boardId != boardId)) return;   // New board not generated yet, usually ready next frame
+
+    UpdateBoardCache(networked? GetNetClientBoardVersion() : snapshot->boardVersion);
+    if (networked) UpdateOpponentWall();
 
     //----------------------------------------------------------------------------------
     BeginMode2D(camera); // Everything within the 2D mode gets affected by camera movement/transformations
     
     // Draw minesweeper board
     DrawRectangleLines(boardRect.x-1, boardRect.y-1, boardRect.width+2, boardRect.height+2, SKYBLUE); // Board outline/border
-    for (int y = 0; y < boardHeight; ++y)
+    DrawTextureRec(boardCache.texture, { 0, 0, (float)boardCache.texture.width, -(float)boardCache.texture.height }, { 0, 0 }, WHITE);
+
+    // Hidden tiles held down by a click are drawn over the cached board
+    if ((clickL || clickM) && CheckCollisionPointRec(mousePos, boardRect))
     {
-        for (int x = 0; x < boardWidth; ++x)
+        Font tileFont = GetFontForSize(&fontAtlases, textSize*camera.zoom);  // Atlas for the digits size on screen, not scaled
+        int mouseX = (int)(mousePos.x/tileSize);
+        int mouseY = (int)(mousePos.y/tileSize);
+        for (int y = mouseY - 1; y <= mouseY + 1; ++y)
         {
-            Rectangle boardTile = MakeRectFromTile(x, y);
-            Color tileColor = { 120,120,120,255 };
-            Color textColor = BLACK;
-            char tileTextSymbol[4];
-
-            if (boardMask[y][x] > 0) // Draw hidden tiles
+            for (int x = mouseX - 1; x <= mouseX + 1; ++x)
             {
-                textColor = { 0,0,0,0 };
-                if (!(clickL && CheckCollisionPointRec(mousePos, boardTile)))
-                {
-                    tileColor = { 150,150,150,255 };
-                    if (boardMask[y][x] == 2)
-                    {
-                        sprintf(tileTextSymbol, "F\n");
-                        textColor = BROWN; // Draw flag
-                    }
-                }
-                if (clickM)
-                {
-                    for (int offsetY = -1; offsetY < 2; ++offsetY)
-                    {
-                        for (int offsetX = -1; offsetX < 2; ++offsetX)
-                        {
-                            int neighborX = x + offsetX;
-                            int neighborY = y + offsetY;
-                            Rectangle neighborTile = MakeRectFromTile(neighborX, neighborY);
-                            if ((neighborX < boardWidth) && (neighborX >= 0) &&
-                                (neighborY < boardHeight) && (neighborY >= 0) &&
-                                (boardMask[y][x] != 2) && CheckCollisionPointRec(mousePos, neighborTile))
-                                //mousePos += cameraPos - boardCenter; Vector2{-tileSize,tileSize}
-                            {
-                                textColor = { 0,0,0,0 };
-                                tileColor = { 120,120,120,255 };
-                            }
-                        }
-                    }
-                }
-            }
-            else if (boardMask[y][x] == 0) // Draw revealed tiles
-            {
-                sprintf(tileTextSymbol, "%d\n", board[y][x]);
-                switch (board[y][x])
-                {
-                case -2:
-                    tileColor = DARKBROWN;
-                case -1:
-                    textColor = { 255,255,255,255 };
-                    sprintf(tileTextSymbol, "#\n");
-                    break;
-                case 0:
-                    textColor = { 0,0,0,0 };
-                    break;
-                case 1:
-                    textColor = { 0,0,255,255 };
-                    break;
-                case 2:
-                    textColor = { 00,90,00,255 };
-                    break;
-                case 3:
-                    textColor = { 200,00,00,255 };
-                    break;
-                case 4:
-                    textColor = { 00,00,90,255 };
-                    break;
-                case 5:
-                    textColor = { 90,10,10,255 };
-                    break;
-                case 6:
-                    textColor = { 03,82,84,255 };
-                    break;
-                case 7:
-                    textColor = { 10,10,10,255 };
-                    break;
-                case 8:
-                    textColor = { 75,75,75,255 };
-                    break;
-                }
-            }
-            else // Draw incorrectly flagged tiles when the game ends.
-            {
-                tileColor = { 150,150,150,255 };
-                textColor = DARKBROWN;
-                sprintf(tileTextSymbol, "X\n");
-            }
-            DrawRectangle(boardTile.x, boardTile.y, tileSize, tileSize, tileColor);
-            tileColor.r -= 20;
-            tileColor.g -= 20;
-            tileColor.b -= 20;
-            DrawRectangleLines(boardTile.x, boardTile.y, tileSize, tileSize, tileColor);
-            if (textColor.a > 0)
-            {
-                DrawTextEx(font, tileTextSymbol, { boardTile.x + tileSize / 3, boardTile.y + tileSize / 10 },
-                    textSize, font.glyphPadding, textColor);
+                if ((x < 0) || (x >= game->width) || (y < 0) || (y >= game->height) || (game->boardMask[y][x] <= 0)) continue;
+
+                bool pressed = (clickL && (x == mouseX) && (y == mouseY)) || (clickM && (game->boardMask[y][x] != 2));
+                if (pressed) DrawBoardTile(x, y, true, tileFont);
             }
         }
     }
     EndMode2D();
     //----------------------------------------------------------------------------------
 
-    if (hp <= 0) // Lose screen
+    if (networked) // Opponent boards on both sides of the board, over it if the window is too narrow
+    {
+        float sideWidth = (GetScreenWidth() - boardRect.width*camera.zoom)/2.0f - 20.0f;
+        if (sideWidth < GetScreenWidth()/6.0f) sideWidth = GetScreenWidth()/6.0f;
+
+        Rectangle left = { 10, 50, sideWidth, GetScreenHeight() - 60.0f };
+        Rectangle right = { GetScreenWidth() - 10 - sideWidth, 50, sideWidth, GetScreenHeight() - 60.0f };
+        DrawOpponentWall(left, right);
+    }
+
+    if (game->hp <= 0) // Lose screen
     {
         Color gameOverColor = MAROON;
         gameOverColor.a = 200;
         DrawRectangle(screenCenter.x - 200, screenCenter.y - 50, 400, 100, gameOverColor );
         gameOverColor = BEIGE;
         gameOverColor.a = 240;
-        DrawTextEx(font, "GAME OVER", { screenCenter.x - 180, screenCenter.y - 50 },
+        DrawTextEx(GetFontForSize(&fontAtlases, font.baseSize*2), spectating? "BOARD LOST" : "GAME OVER", { screenCenter.x - 180, screenCenter.y - 50 },
                    font.baseSize*2, font.glyphPadding, gameOverColor);
-        DrawTextEx(font, "ctrl+r to restart", { screenCenter.x - 180, screenCenter.y + 10 },
+        if (!spectating) DrawTextEx(font, "ctrl+r to restart", { screenCenter.x - 180, screenCenter.y + 10 },
             font.baseSize, font.glyphPadding, gameOverColor);
     }
-    else if (winCon)
+    else if (game->winCon)
     {
         Color victoryColor = DARKPURPLE;
         victoryColor.a = 200;
         DrawRectangle(screenCenter.x - 200, screenCenter.y - 50, 400, 100, victoryColor);
         victoryColor = BEIGE;
         victoryColor.a = 240;
-        DrawTextEx(font, "YOU WON", { screenCenter.x - 180, screenCenter.y - 50 },
+        DrawTextEx(GetFontForSize(&fontAtlases, font.baseSize*2), spectating? "CLEARED" : "YOU WON", { screenCenter.x - 180, screenCenter.y - 50 },
             font.baseSize * 2, font.glyphPadding, victoryColor);
-        DrawTextEx(font, "ctrl+r to restart", { screenCenter.x - 180, screenCenter.y + 10 },
+        if (!spectating) DrawTextEx(font, "ctrl+r to restart", { screenCenter.x - 180, screenCenter.y + 10 },
             font.baseSize, font.glyphPadding, victoryColor);
     }
 
+    if (networked && (GetNetClientState() == NET_CLIENT_ENDED))
+    {
+        int winner = GetNetClientWinner();
+        bool you = !spectating && (winner == GetNetClientPlayer());
+        const char *matchText = (winner < 0)? "Match over, nobody cleared their board" :
+                                you? "Match over, you won" : TextFormat("Match over, player %i won", winner + 1);
+        if ((GetNetClientMatchMode() == MATCH_MODE_RACE) && (winner >= 0))
+        {
+            matchText = you? "Race over, you cleared the board first" : TextFormat("Race over, player %i cleared the board first", winner + 1);
+        }
+        DrawTextEx(font, matchText, { screenCenter.x - 180, screenCenter.y + 60 }, font.baseSize, font.glyphPadding, BEIGE);
+    }
+
+    if (spectating)
+    {
+        const char *watchText = TextFormat("Watching player %i of %i, left/right to switch", GetNetClientPlayer() + 1, GetNetClientPlayerCount());
+        DrawTextEx(GetFontForSize(&fontAtlases, font.baseSize/2), watchText, { 50, 10 }, font.baseSize/2, font.glyphPadding, BEIGE);
+    }
+    else if (networked && (GetNetClientStats().desyncs > 0))
+    {
+        DrawTextEx(GetFontForSize(&fontAtlases, font.baseSize/2), "Desynced, opponent boards may be wrong", { 50, 10 }, font.baseSize/2, font.glyphPadding, MAROON);
+    }
+
     Vector2 pos = {5,10};
     Color uiBackdropColor = DARKPURPLE;
     uiBackdropColor.a = 100;
     DrawRectangle(0, 0, 40, 40, uiBackdropColor);
-    DrawTextEx(font, "ESC", pos, font.baseSize/2, font.glyphPadding, BEIGE);
+    DrawTextEx(GetFontForSize(&fontAtlases, font.baseSize/2), "ESC", pos, font.baseSize/2, font.glyphPadding, BEIGE);
 
 
     // Draw timer
@@ -722,23 +566,27 @@ void DrawGameplayScreen(void)
     timerColor = BEIGE;
     timerColor.a = 240;
     char buffer[256];
-    sprintf(buffer, "%04d\n", (int)timer);
+    sprintf(buffer, "%04d\n", (int)GetGameTimer(game));
     DrawTextEx(font, buffer, { GetScreenWidth() - 90.f, 2.f },
         font.baseSize, font.glyphPadding, timerColor);
 #endif
 }
 
+
 // Gameplay Screen Unload logic
 void UnloadGameplayScreen(void)
 {
-    for (int y = 0; y < boardHeight; ++y)
+    if (networked)
     {
-        for (int x = 0; x < boardWidth; ++x)
-        {
-            board[y][x] = 0;
-            boardMask[y][x] = 1;
-        }
+        CloseNetClient();
+        UnloadOpponentWall();
     }
+    else StopSimulationGame();
+    CancelPendingInputLatency();
+
+    if (IsRenderTextureReady(boardCache)) UnloadRenderTexture(boardCache);
+    boardCache = { 0 };
+    boardCacheValid = false;
 }
 
 // Gameplay Screen should finish?
@@ -746,3 +594,21 @@ int FinishGameplayScreen(void)
 {
     return finishResult;
 }
+
+// Gameplay Screen idle wait time, used by the frame loop to sleep on input events
+// NOTE: 0 = camera is panning, > 0 = time until the timer display changes, < 0 = nothing changes without input
+double GetGameplayIdleWaitTime(void)
+{
+    if (IsKeyDown(KEY_W) || IsKeyDown(KEY_A) || IsKeyDown(KEY_S) || IsKeyDown(KEY_D)) return 0.0;
+    if (networked) return (GetNetClientState() == NET_CLIENT_OFFLINE)? -1.0 : 0.0;    // Server messages are not input events
+    if (IsSimulationPending()) return 0.0;
+
+    if (!IsGameOver(game) && (game->startTick >= 0))
+    {
+        // Wake up right when the next whole second is displayed
+        float timer = GetGameTimer(game);
+        if (timer < MAX_GAME_TIME) return ((double)((int)timer + 1) - (double)timer);
+    }
+
+    return -1.0;
+}
@@ -30,6 +30,7 @@
 
 #include "raylib.h"
 #include "screens.h"
+#include "asset_stream.h"
 
 //----------------------------------------------------------------------------------
 // Module Variables Definition (local)
@@ -77,6 +78,8 @@ void InitLogoScreen(void)
 // Logo Screen Update logic
 void UpdateLogoScreen(void)
 {
+    PROFILE_FUNCTION();
+
     if (state == 0)                 // State 0: Top-left square corner blink logic
     {
         framesCounter++;
@@ -119,22 +122,20 @@ void UpdateLogoScreen(void)
             {
                 alpha -= 0.02f;
 
-                if (alpha <= 0.0f)
-                {
-                    alpha = 0.0f;
-                    finishResult = (int)TITLE;   // Jump to title screen
-                }
+                if (alpha <= 0.0f) alpha = 0.0f;
             }
         }
     }
-    if (GetCharPressed()) {
-        finishResult = (int)TITLE;
-    }
+
+    // Jump to title screen as soon as its assets are streamed in, the animation only covers loading
+    if (IsAssetGroupReady(ASSET_GROUP_TITLE)) finishResult = (int)TITLE;
 }
 
 // Logo Screen Draw logic
 void DrawLogoScreen(void)
 {
+    PROFILE_FUNCTION();
+
     if (state == 0)         // Draw blinking top-left square corner
     {
         if ((framesCounter/10)%2) DrawRectangle(logoPositionX, logoPositionY, 16, 16, BLACK);
@@ -165,6 +166,8 @@ void DrawLogoScreen(void)
         DrawText(TextSubtext("raylib", 0, lettersCount), GetScreenWidth()/2 - 44, GetScreenHeight()/2 + 48, 50, Fade(BLACK, alpha));
 
         if (framesCounter > 20) DrawText("powered by", logoPositionX, logoPositionY - 27, 20, Fade(DARKGRAY, alpha));
+
+        if (alpha <= 0.0f) DrawText("loading...", GetScreenWidth()/2 - 40, GetScreenHeight()/2, 20, DARKGRAY);
     }
 }
 
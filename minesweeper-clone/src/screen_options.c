@@ -120,6 +120,8 @@ void InitOptionsScreen(void)
 // Options Screen Update logic
 void UpdateOptionsScreen(void)
 {
+    PROFILE_FUNCTION();
+
     menu.mineGenMode.text = (mineGenMode == 0) ? "Mine Gen Mode:  %" : "Mine Gen Mode:  #";
     menu.mineCap.button.text = (mineGenMode == 0) ? "Mine Density: %" : "Number of Mines: ";
     bool clickL = IsMouseButtonReleased(MOUSE_BUTTON_LEFT);
@@ -165,7 +167,7 @@ void UpdateOptionsScreen(void)
             if (CheckCollisionPointRec(mousePos, menu.resumeButton.rect))
             {
                 finishResult = (int)previousScreen;
-                PlaySound(fxCoin);
+                PlaySfx(SFX_UI);
             }
             else if (CheckCollisionPointRec(mousePos, menu.defaults.rect))
             {
@@ -175,12 +177,12 @@ void UpdateOptionsScreen(void)
                 mineDensity = 20;
                 minesDesired = 99;
                 startingHP = 1;
-                PlaySound(fxCoin);
+                PlaySfx(SFX_UI);
             }
             else if (CheckCollisionPointRec(mousePos, menu.mineGenMode.rect))
             {
                 mineGenMode = !mineGenMode;
-                PlaySound(fxCoin);
+                PlaySfx(SFX_UI);
             }
             else if (CheckCollisionPointRec(mousePos, menu.mainMenuButton.rect))
             {
@@ -189,7 +191,7 @@ void UpdateOptionsScreen(void)
             else if (CheckCollisionPointRec(mousePos, menu.quitButton.rect))
             {
                 finishResult = -1;
-                PlaySound(fxCoin);
+                PlaySfx(SFX_UI);
                 running = false;
             }
         }
@@ -261,13 +263,15 @@ void UpdateOptionsScreen(void)
     if (IsKeyPressed(KEY_ESCAPE))
     {
         finishResult = (int)previousScreen;
-        PlaySound(fxCoin);
+        PlaySfx(SFX_UI);
     }
 }
 
 // Options Screen Draw logic
 void DrawOptionsScreen(void)
 {
+    PROFILE_FUNCTION();
+
     DrawRectangle(0, 0, GetScreenWidth(), GetScreenHeight(), DARKGRAY); //draw backdrop
     Vector2 pos = { 20, 10 };
     DrawTextEx(font, "OPTIONS", pos, font.baseSize, font.glyphPadding, BEIGE);
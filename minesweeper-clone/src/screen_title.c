@@ -52,6 +52,8 @@ void InitTitleScreen(void)
 // Title Screen Update logic
 void UpdateTitleScreen(void)
 {
+    PROFILE_FUNCTION();
+
     // TODO: Update TITLE screen variables here!
 
     // Press enter or tap to change to GAMEPLAY screen
@@ -61,19 +63,21 @@ void UpdateTitleScreen(void)
     if (clickL != tap != IsMouseButtonPressed(MOUSE_BUTTON_LEFT))
     {
         finishResult = (int)GAMEPLAY;
-        PlaySound(fxCoin);
+        PlaySfx(SFX_UI);
     }
 
     if (IsKeyPressed(KEY_ESCAPE))
     {
         finishResult = (int)OPTIONS;
-        PlaySound(fxCoin);
+        PlaySfx(SFX_UI);
     }
 }
 
 // Title Screen Draw logic
 void DrawTitleScreen(void)
 {
+    PROFILE_FUNCTION();
+
     // TODO: Draw TITLE screen here!
     DrawRectangle(0, 0, GetScreenWidth(), GetScreenHeight(), DARKGRAY);
     Vector2 pos = { 20, 10 };
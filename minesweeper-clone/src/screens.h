@@ -35,6 +35,12 @@
 #include <stdio.h>
 #include <time.h>
 
+#include "game_core.h"
+#include "profiler.h"
+#include "logger.h"
+#include "font_atlas.h"
+#include "sfx.h"
+
 //----------------------------------------------------------------------------------
 // Types and Structures Definition
 //----------------------------------------------------------------------------------
@@ -42,8 +48,6 @@
 #define global_var	  static
 #define internal      static
 
-#define maxBoardHeight 99
-#define maxBoardWidth 99
 
 typedef enum GameScreen { UNKNOWN = -1, LOGO = 0, TITLE = 1, OPTIONS = 2, GAMEPLAY = 3, ENDING = 4} GameScreen;
 typedef struct Button {
@@ -69,8 +73,10 @@ struct TextBox {
 //----------------------------------------------------------------------------------
 extern GameScreen currentScreen;
 extern Font font;
+extern FontAtlasSet fontAtlases; // Game font at every text size, font is its FONT_ATLAS_BASE_SIZE atlas
 extern Music music;
 extern Sound fxCoin;
+extern float simAlpha; // Fraction of a tick elapsed since the last screen tick, for render interpolation
 
 extern bool running;
 extern int boardHeight;
@@ -79,11 +85,11 @@ extern int mineDensity;
 extern int minesDesired;
 extern bool mineGenMode; // 0 = by density, 1 = til maxMineCount
 extern int startingHP;
-extern float timer;
-extern float timeStart;
-
-extern int board[maxBoardHeight][maxBoardWidth]; // -2 = mine(clicked on), -1 = mine, non-negative = number of adjacent mines
-extern int boardMask[maxBoardHeight][maxBoardWidth]; // 0 = revealed, 1 = hidden, 2 = flagged, -1 = incorrectly flagged (only used for game lose screen)
+extern const char *serverAddress;   // Match server the gameplay screen joins, NULL = single player
+extern int serverPort;
+extern bool serverSpectate;         // Watch a match instead of joining one
+extern unsigned int serverMatch;    // Match watched, 0 = the latest one
+extern int serverRating;            // Sent when joining, players are matched with close ones
 
 #ifdef __cplusplus
 extern "C" {            // Prevents name mangling of functions
@@ -137,9 +143,11 @@ int FinishOptionsScreen(void);
 //----------------------------------------------------------------------------------
 void InitGameplayScreen(void);
 void UpdateGameplayScreen(void);
+void TickGameplayScreen(void);
 void DrawGameplayScreen(void);
 void UnloadGameplayScreen(void);
 int FinishGameplayScreen(void);
+double GetGameplayIdleWaitTime(void);
 
 //----------------------------------------------------------------------------------
 // Ending Screen Functions Declaration
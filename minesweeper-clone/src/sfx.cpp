@@ -0,0 +1,158 @@
+/**********************************************************************************************
+*
+*   Minesweeper Clone - Sound Effects
+*
+*   Preallocated voice pool with per-category caps and voice stealing.
+*
+*   Copyright (c) 2024 (DoughnutDude)
+*
+**********************************************************************************************/
+
+#include "sfx.h"
+#include "logger.h"
+
+#define internal static
+#define global_var static
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct SfxSettings {
+    int maxVoices;          // Voices playing this category at the same time
+    float volume;
+    float pitch;
+    float pitchVariation;   // Random pitch offset range, +/-
+} SfxSettings;
+
+typedef struct SfxVoice {
+    Sound alias;
+    unsigned int startIndex;    // Play order, lowest is the oldest voice
+} SfxVoice;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+// NOTE: Every category plays the same source sound for now, told apart by pitch and volume
+global_var const SfxSettings sfxSettings[SFX_CATEGORY_COUNT] = {
+    { 2, 1.00f, 1.00f, 0.00f },     // SFX_UI
+    { 6, 0.35f, 1.50f, 0.10f },     // SFX_REVEAL
+    { 4, 0.50f, 1.25f, 0.05f },     // SFX_CHORD
+    { 3, 0.40f, 0.80f, 0.05f },     // SFX_FLAG
+    { 2, 1.00f, 0.50f, 0.00f },     // SFX_MINE
+};
+
+global_var SfxVoice voices[SFX_MAX_VOICES];
+global_var int firstVoice[SFX_CATEGORY_COUNT];
+global_var int voiceCount[SFX_CATEGORY_COUNT];
+global_var int pendingTriggers[SFX_CATEGORY_COUNT];
+global_var unsigned int playCounter = 0;
+global_var unsigned int randomState = 0x9e3779b9u;
+global_var bool sfxReady = false;
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions Definition
+//----------------------------------------------------------------------------------
+// Random value in [-1, 1], xorshift32 (no GetRandomValue(), it shares its state with the game)
+internal float GetSfxRandom(void)
+{
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return (float)(randomState & 0xffff)/32767.5f - 1.0f;
+}
+
+// Free voice of the category, its oldest one if all are playing
+internal SfxVoice *GetSfxVoice(SfxCategory category)
+{
+    SfxVoice *oldest = &voices[firstVoice[category]];
+    for (int i = firstVoice[category]; i < firstVoice[category] + voiceCount[category]; ++i)
+    {
+        if (!IsSoundPlaying(voices[i].alias)) return &voices[i];
+        if (voices[i].startIndex < oldest->startIndex) oldest = &voices[i];
+    }
+
+    StopSound(oldest->alias);
+    return oldest;
+}
+
+//----------------------------------------------------------------------------------
+// Sound Effects Functions Definition
+//----------------------------------------------------------------------------------
+void InitSoundEffects(Sound source)
+{
+    if (sfxReady || !IsSoundReady(source))
+    {
+        if (!sfxReady) LOG_MESSAGE(LOG_LEVEL_WARNING, LOG_CATEGORY_GAME, "Sound effects source not loaded, playing no sound effects");
+        return;
+    }
+
+    // NOTE: Aliases allocate their own audio buffer, only done here
+    int voiceIndex = 0;
+    for (int category = 0; category < SFX_CATEGORY_COUNT; ++category)
+    {
+        firstVoice[category] = voiceIndex;
+        voiceCount[category] = 0;
+        for (int i = 0; (i < sfxSettings[category].maxVoices) && (voiceIndex < SFX_MAX_VOICES); ++i)
+        {
+            voices[voiceIndex].alias = LoadSoundAlias(source);
+            voices[voiceIndex].startIndex = 0;
+            if (!IsSoundReady(voices[voiceIndex].alias)) break;
+
+            SetSoundVolume(voices[voiceIndex].alias, sfxSettings[category].volume);
+            SetSoundPitch(voices[voiceIndex].alias, sfxSettings[category].pitch);
+            ++voiceCount[category];
+            ++voiceIndex;
+        }
+        pendingTriggers[category] = 0;
+    }
+
+    sfxReady = true;
+}
+
+void UnloadSoundEffects(void)
+{
+    if (!sfxReady) return;
+
+    for (int category = 0; category < SFX_CATEGORY_COUNT; ++category)
+    {
+        for (int i = firstVoice[category]; i < firstVoice[category] + voiceCount[category]; ++i)
+        {
+            StopSound(voices[i].alias);
+            UnloadSoundAlias(voices[i].alias);
+        }
+        voiceCount[category] = 0;
+        pendingTriggers[category] = 0;
+    }
+
+    sfxReady = false;
+}
+
+void PlaySfx(SfxCategory category)
+{
+    ++pendingTriggers[category];
+}
+
+void UpdateSoundEffects(void)
+{
+    for (int category = 0; category < SFX_CATEGORY_COUNT; ++category)
+    {
+        int triggers = pendingTriggers[category];
+        pendingTriggers[category] = 0;
+        if (!sfxReady || (triggers == 0) || (voiceCount[category] == 0)) continue;
+
+        const SfxSettings *settings = &sfxSettings[category];
+        SfxVoice *voice = GetSfxVoice((SfxCategory)category);
+
+        // Triggers coalesced this frame make the voice a bit louder, up to 1.5x
+        float volume = settings->volume*(1.0f + 0.1f*(float)(triggers - 1));
+        if (volume > 1.5f*settings->volume) volume = 1.5f*settings->volume;
+        if (volume > 1.0f) volume = 1.0f;
+
+        // NOTE: Pitch is only changed on a stopped voice, the mixer reads its converter while playing
+        SetSoundVolume(voice->alias, volume);
+        if (settings->pitchVariation > 0.0f) SetSoundPitch(voice->alias, settings->pitch + settings->pitchVariation*GetSfxRandom());
+
+        voice->startIndex = ++playCounter;
+        PlaySound(voice->alias);
+    }
+}
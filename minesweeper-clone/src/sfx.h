@@ -0,0 +1,46 @@
+/**********************************************************************************************
+*
+*   Minesweeper Clone - Sound Effects
+*
+*   Preallocated voice pool for gameplay and menu sounds. Every category owns a few sound
+*   aliases sharing the sample data of its source sound, created once at startup, so playing
+*   a sound never allocates nor locks the audio device.
+*   Triggers are only counted when they happen and started once per frame by
+*   UpdateSoundEffects(): a burst of reveals in one frame is one louder voice, not a pile of
+*   overlapping ones. A category with all its voices busy steals its oldest one.
+*
+*   Copyright (c) 2024 (DoughnutDude)
+*
+**********************************************************************************************/
+
+#ifndef SFX_H
+#define SFX_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define SFX_MAX_VOICES          24      // Voices of every category together
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum SfxCategory {
+    SFX_UI = 0,             // Menu buttons and screen changes
+    SFX_REVEAL,             // Tile revealed
+    SFX_CHORD,              // Neighbors of a clue revealed
+    SFX_FLAG,               // Flag placed or removed
+    SFX_MINE,               // Mine hit, hp lost
+    SFX_CATEGORY_COUNT
+} SfxCategory;
+
+//----------------------------------------------------------------------------------
+// Sound Effects Functions Declaration
+//----------------------------------------------------------------------------------
+void InitSoundEffects(Sound source);    // Create every category voices, source must stay loaded until UnloadSoundEffects()
+void UnloadSoundEffects(void);
+void PlaySfx(SfxCategory category);     // Queue a trigger, started on the next UpdateSoundEffects()
+void UpdateSoundEffects(void);          // Start queued triggers, main thread, once per frame
+
+#endif // SFX_H
@@ -59,9 +59,11 @@
 // Wait for events passively (sleeping while no events) instead of polling them actively every frame
 //#define SUPPORT_EVENTS_WAITING          1
 // Allow automatic screen capture of current screen pressing F12, defined in KeyCallback()
-#define SUPPORT_SCREEN_CAPTURE          1
+// NOTE: Disabled, Minesweeper Clone captures screenshots/gifs off the render thread (screen_capture.cpp)
+//#define SUPPORT_SCREEN_CAPTURE          1
 // Allow automatic gif recording of current screen pressing CTRL+F12, defined in KeyCallback()
-#define SUPPORT_GIF_RECORDING           1
+// WARNING: Enabling it also compiles msf_gif implementation in rcore.c, clashing with screen_capture.cpp
+//#define SUPPORT_GIF_RECORDING           1
 // Support CompressData() and DecompressData() functions
 #define SUPPORT_COMPRESSION_API         1
 // Support automatic generated events, loading and recording of those events when required
@@ -84,6 +86,7 @@
 #define MAX_TOUCH_POINTS                8       // Maximum number of touch points supported
 #define MAX_KEY_PRESSED_QUEUE          16       // Maximum number of keys in the key input queue
 #define MAX_CHAR_PRESSED_QUEUE         16       // Maximum number of characters in the char input queue
+#define MAX_MOUSE_BUTTON_EVENT_QUEUE   64       // Maximum number of mouse button events in the mouse input queue
 
 #define MAX_DECOMPRESSION_SIZE         64       // Max size allocated for decompression in MB
 
@@ -506,6 +506,14 @@ typedef struct FilePathList {
     char **paths;                   // Filepaths entries
 } FilePathList;
 
+// Mouse button event, queued with its own timestamp and cursor position
+typedef struct MouseButtonEvent {
+    double time;                    // Event time, same clock as GetTime()
+    int button;                     // Mouse button (MouseButton)
+    bool pressed;                   // Button pressed (true) or released (false)
+    Vector2 position;               // Mouse position at the time of the event
+} MouseButtonEvent;
+
 //----------------------------------------------------------------------------------
 // Enumerators Definition
 //----------------------------------------------------------------------------------
@@ -985,6 +993,7 @@ RLAPI void SetClipboardText(const char *text);                    // Set clipboa
 RLAPI const char *GetClipboardText(void);                         // Get clipboard text content
 RLAPI void EnableEventWaiting(void);                              // Enable waiting for events on EndDrawing(), no automatic event polling
 RLAPI void DisableEventWaiting(void);                             // Disable waiting for events on EndDrawing(), automatic events polling
+RLAPI void SetEventWaitingTimeout(double seconds);                // Set maximum time to wait for events on EndDrawing() (0 = wait indefinitely)
 
 // Custom frame control functions
 // NOTE: Those functions are intended for advance users that want full control over the frame processing
@@ -1052,6 +1061,7 @@ RLAPI void SetTargetFPS(int fps);                                 // Set target
 RLAPI int GetFPS(void);                                           // Get current FPS
 RLAPI float GetFrameTime(void);                                   // Get time in seconds for last frame drawn (delta time)
 RLAPI double GetTime(void);                                       // Get elapsed time in seconds since InitWindow()
+RLAPI double GetSwapTime(void);                                   // Get time the last frame buffers were swapped (same clock as GetTime())
 
 // Misc. functions
 RLAPI int GetRandomValue(int min, int max);                       // Get a random value between min and max (both included)
@@ -1151,6 +1161,7 @@ RLAPI void SetMouseScale(float scaleX, float scaleY);         // Set mouse scali
 RLAPI float GetMouseWheelMove(void);                          // Get mouse wheel movement for X or Y, whichever is larger
 RLAPI Vector2 GetMouseWheelMoveV(void);                       // Get mouse wheel movement for both X and Y
 RLAPI void SetMouseCursor(int cursor);                        // Set mouse cursor
+RLAPI bool GetMouseButtonEvent(MouseButtonEvent *event);      // Get next mouse button event (in order), call it multiple times for events queued, returns false when the queue is empty
 
 // Input-related functions: touch
 RLAPI int GetTouchX(void);                                    // Get touch position X for touch point 0 (relative to screen size)
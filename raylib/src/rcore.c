@@ -325,6 +325,9 @@
 #ifndef MAX_CHAR_PRESSED_QUEUE
     #define MAX_CHAR_PRESSED_QUEUE        16        // Maximum number of characters in the char input queue
 #endif
+#ifndef MAX_MOUSE_BUTTON_EVENT_QUEUE
+    #define MAX_MOUSE_BUTTON_EVENT_QUEUE  64        // Maximum number of mouse button events in the mouse input queue
+#endif
 
 #ifndef MAX_DECOMPRESSION_SIZE
     #define MAX_DECOMPRESSION_SIZE        64        // Maximum size allocated for decompression in MB
@@ -386,6 +389,7 @@ typedef struct CoreData {
         bool shouldClose;                   // Check if window set for closing
         bool resizedLastFrame;              // Check if window has been resized last frame
         bool eventWaiting;                  // Wait for events before ending frame
+        double eventWaitTimeout;            // Maximum time to wait for events (0 = wait indefinitely)
 
         Point position;                     // Window position (required on fullscreen toggle)
         Point previousPosition;             // Window previous position (required on borderless windowed toggle)
@@ -455,6 +459,10 @@ typedef struct CoreData {
             char previousButtonState[MAX_MOUSE_BUTTONS];    // Registers previous mouse button state
             Vector2 currentWheelMove;       // Registers current mouse wheel variation
             Vector2 previousWheelMove;      // Registers previous mouse wheel variation
+
+            MouseButtonEvent buttonEventQueue[MAX_MOUSE_BUTTON_EVENT_QUEUE];  // Mouse button events queue (in arrival order)
+            int buttonEventQueueCount;      // Mouse button events queue count
+            int buttonEventQueueHead;       // Mouse button events queue next event to read
 #if defined(PLATFORM_DRM)
             Vector2 eventWheelMove;         // Registers the event mouse wheel variation
             // NOTE: currentButtonState[] can't be written directly due to multithreading, app could miss the update
@@ -488,6 +496,7 @@ typedef struct CoreData {
         double update;                      // Time measure for frame update
         double draw;                        // Time measure for frame draw
         double frame;                       // Time measure for one frame
+        double swap;                        // Time the last frame buffers were swapped
         double target;                      // Desired time for one frame, if 0 not applied
 #if defined(PLATFORM_ANDROID) || defined(PLATFORM_DRM)
         unsigned long long int base;        // Base time measure for hi-res timer
@@ -2213,6 +2222,13 @@ void DisableEventWaiting(void)
     CORE.Window.eventWaiting = false;
 }
 
+// Set maximum time to wait for events on EndDrawing() when event waiting is enabled
+// NOTE: A value of 0 (or negative) waits indefinitely until an event arrives
+void SetEventWaitingTimeout(double seconds)
+{
+    CORE.Window.eventWaitTimeout = (seconds > 0.0)? seconds : 0.0;
+}
+
 // Show mouse cursor
 void ShowCursor(void)
 {
@@ -3049,6 +3065,12 @@ float GetFrameTime(void)
     return (float)CORE.Time.frame;
 }
 
+// Get time the last frame buffers were swapped (same clock as GetTime())
+double GetSwapTime(void)
+{
+    return CORE.Time.swap;
+}
+
 // Get elapsed time measure in seconds since InitTimer()
 // NOTE: On PLATFORM_DESKTOP InitTimer() is called on InitWindow()
 // NOTE: On PLATFORM_DESKTOP, timer is initialized on glfwInit()
@@ -3888,6 +3910,22 @@ int GetCharPressed(void)
     return value;
 }
 
+// Get next mouse button event from the queue, with its own timestamp and cursor position
+// NOTE: Several clicks within a single frame are all kept, in the order they were received
+bool GetMouseButtonEvent(MouseButtonEvent *event)
+{
+    bool result = false;
+
+    if (CORE.Input.Mouse.buttonEventQueueHead < CORE.Input.Mouse.buttonEventQueueCount)
+    {
+        *event = CORE.Input.Mouse.buttonEventQueue[CORE.Input.Mouse.buttonEventQueueHead];
+        CORE.Input.Mouse.buttonEventQueueHead++;
+        result = true;
+    }
+
+    return result;
+}
+
 // Set a custom key to exit program
 // NOTE: default exitKey is ESCAPE
 void SetExitKey(int key)
@@ -5149,10 +5187,12 @@ void SwapScreenBuffer(void)
 {
 #if defined(PLATFORM_DESKTOP) || defined(PLATFORM_WEB)
     glfwSwapBuffers(CORE.Window.handle);
+    CORE.Time.swap = GetTime();
 #endif
 
 #if defined(PLATFORM_ANDROID) || defined(PLATFORM_DRM)
     eglSwapBuffers(CORE.Window.device, CORE.Window.surface);
+    CORE.Time.swap = GetTime();
 
 #if defined(PLATFORM_DRM)
 
@@ -5196,6 +5236,9 @@ void PollInputEvents(void)
     // Reset keys/chars pressed registered
     CORE.Input.Keyboard.keyPressedQueueCount = 0;
     CORE.Input.Keyboard.charPressedQueueCount = 0;
+    // Reset mouse button events registered
+    CORE.Input.Mouse.buttonEventQueueCount = 0;
+    CORE.Input.Mouse.buttonEventQueueHead = 0;
     // Reset key repeats
     for (int i = 0; i < MAX_KEYBOARD_KEYS; i++) CORE.Input.Keyboard.keyRepeatInFrame[i] = 0;
 
@@ -5344,7 +5387,12 @@ void PollInputEvents(void)
 
     CORE.Window.resizedLastFrame = false;
 
-    if (CORE.Window.eventWaiting) glfwWaitEvents();     // Wait for in input events before continue (drawing is paused)
+    if (CORE.Window.eventWaiting)
+    {
+        // Wait for in input events before continue (drawing is paused), optionally with a time limit
+        if (CORE.Window.eventWaitTimeout > 0.0) glfwWaitEventsTimeout(CORE.Window.eventWaitTimeout);
+        else glfwWaitEvents();
+    }
     else glfwPollEvents();      // Poll input events: keyboard/mouse/window events (callbacks)
 #endif  // PLATFORM_DESKTOP
 
@@ -5474,7 +5522,8 @@ static void ScanDirectoryFiles(const char *basePath, FilePathList *files, const
 
     if (dir != NULL)
     {
-        while ((dp = readdir(dir)) != NULL)
+        // NOTE: Files created after capacity was computed (i.e. LoadDirectoryFiles() count scan) are skipped
+        while (((dp = readdir(dir)) != NULL) && (files->count < files->capacity))
         {
             if ((strcmp(dp->d_name, ".") != 0) &&
                 (strcmp(dp->d_name, "..") != 0))
@@ -5732,6 +5781,19 @@ static void MouseButtonCallback(GLFWwindow *window, int button, int action, int
     // but future releases may add more actions (i.e. GLFW_REPEAT)
     CORE.Input.Mouse.currentButtonState[button] = action;
 
+    // Queue the event with the cursor position it happened at
+    // NOTE: Timestamp is taken when the callback runs (during event polling), it keeps events ordering
+    if (CORE.Input.Mouse.buttonEventQueueCount < MAX_MOUSE_BUTTON_EVENT_QUEUE)
+    {
+        MouseButtonEvent *event = &CORE.Input.Mouse.buttonEventQueue[CORE.Input.Mouse.buttonEventQueueCount];
+        event->time = GetTime();
+        event->button = button;
+        event->pressed = (action == GLFW_PRESS);
+        event->position = GetMousePosition();
+        CORE.Input.Mouse.buttonEventQueueCount++;
+    }
+    else TRACELOG(LOG_WARNING, "INPUT: Mouse button events queue is full, event dropped");
+
 #if defined(SUPPORT_GESTURES_SYSTEM) && defined(SUPPORT_MOUSE_GESTURES)         // PLATFORM_DESKTOP
     // Process mouse events as touches to be able to use mouse-gestures
     GestureEvent gestureEvent = { 0 };
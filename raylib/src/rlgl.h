@@ -546,6 +546,17 @@ typedef enum {
     RL_CULL_FACE_BACK
 } rlCullMode;
 
+// Render batch draw callback, called with begin = true before a batch is drawn and begin = false after (i.e. profiling)
+typedef void (*rlDrawRenderBatchCallback)(bool begin);
+
+// Render statistics, accumulated by render batches draw
+typedef struct rlRenderStats {
+    int drawCalls;              // Draw calls issued (glDrawArrays()/glDrawElements())
+    int vertices;               // Vertices submitted
+    int batchFlushes;           // Render batches drawn with vertex data
+    int textureSwitches;        // Texture changes between consecutive draw calls
+} rlRenderStats;
+
 //------------------------------------------------------------------------------------
 // Functions Declaration - Matrix operations
 //------------------------------------------------------------------------------------
@@ -673,6 +684,9 @@ RLAPI void rlUnloadRenderBatch(rlRenderBatch batch);                        // U
 RLAPI void rlDrawRenderBatch(rlRenderBatch *batch);                         // Draw render batch data (Update->Draw->Reset)
 RLAPI void rlSetRenderBatchActive(rlRenderBatch *batch);                    // Set the active render batch for rlgl (NULL for default internal)
 RLAPI void rlDrawRenderBatchActive(void);                                   // Update and draw internal render batch
+RLAPI void rlSetDrawRenderBatchCallback(rlDrawRenderBatchCallback callback); // Set callback around every render batch draw (NULL to disable)
+RLAPI rlRenderStats rlGetRenderStats(void);                                 // Get render statistics since last reset (active batch included, as if drawn now)
+RLAPI void rlResetRenderStats(void);                                        // Reset render statistics (i.e. every frame)
 RLAPI bool rlCheckRenderBatchLimit(int vCount);                             // Check internal buffer overflow for a given number of vertex
 
 RLAPI void rlSetTexture(unsigned int id);               // Set current texture for render batch and check buffers limits
@@ -706,6 +720,7 @@ RLAPI void rlUnloadTexture(unsigned int id);                              // Unl
 RLAPI void rlGenTextureMipmaps(unsigned int id, int width, int height, int format, int *mipmaps); // Generate mipmap data for selected texture
 RLAPI void *rlReadTexturePixels(unsigned int id, int width, int height, int format);              // Read texture pixel data
 RLAPI unsigned char *rlReadScreenPixels(int width, int height);           // Read screen pixel data (color buffer)
+RLAPI void rlReadScreenPixelsToBuffer(unsigned char *data, int width, int height); // Read screen pixel data into a preallocated buffer (no flip, bottom row first)
 
 // Framebuffer management (fbo)
 RLAPI unsigned int rlLoadFramebuffer(int width, int height);              // Load an empty framebuffer
@@ -1035,6 +1050,9 @@ typedef void *(*rlglLoadProc)(const char *name);   // OpenGL extension functions
 //----------------------------------------------------------------------------------
 #if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
 static rlglData RLGL = { 0 };
+static rlDrawRenderBatchCallback drawRenderBatchCallback = NULL;
+static rlRenderStats renderStats = { 0 };
+static unsigned int renderStatsTextureId = 0;       // Last texture counted for texture switches
 #endif  // GRAPHICS_API_OPENGL_33 || GRAPHICS_API_OPENGL_ES2
 
 #if defined(GRAPHICS_API_OPENGL_ES2)
@@ -2699,12 +2717,16 @@ void rlUnloadRenderBatch(rlRenderBatch batch)
 void rlDrawRenderBatch(rlRenderBatch *batch)
 {
 #if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    if (drawRenderBatchCallback != NULL) drawRenderBatchCallback(true);
+
     // Update batch vertex buffers
     //------------------------------------------------------------------------------------------------------------
     // NOTE: If there is not vertex data, buffers doesn't need to be updated (vertexCount > 0)
     // TODO: If no data changed on the CPU arrays --> No need to re-update GPU arrays (use a change detector flag?)
     if (RLGL.State.vertexCounter > 0)
     {
+        renderStats.batchFlushes++;
+
         // Activate elements VAO
         if (RLGL.ExtSupported.vao) glBindVertexArray(batch->vertexBuffer[batch->currentBuffer].vaoId);
 
@@ -2825,6 +2847,14 @@ void rlDrawRenderBatch(rlRenderBatch *batch)
                 // Bind current draw call texture, activated as GL_TEXTURE0 and Bound to sampler2D texture0 by default
                 glBindTexture(GL_TEXTURE_2D, batch->draws[i].textureId);
 
+                if (batch->draws[i].vertexCount > 0)
+                {
+                    renderStats.drawCalls++;
+                    renderStats.vertices += batch->draws[i].vertexCount;
+                    if (batch->draws[i].textureId != renderStatsTextureId) renderStats.textureSwitches++;
+                    renderStatsTextureId = batch->draws[i].textureId;
+                }
+
                 if ((batch->draws[i].mode == RL_LINES) || (batch->draws[i].mode == RL_TRIANGLES)) glDrawArrays(batch->draws[i].mode, vertexOffset, batch->draws[i].vertexCount);
                 else
                 {
@@ -2890,6 +2920,8 @@ void rlDrawRenderBatch(rlRenderBatch *batch)
     // Change to next buffer in the list (in case of multi-buffering)
     batch->currentBuffer++;
     if (batch->currentBuffer >= batch->bufferCount) batch->currentBuffer = 0;
+
+    if (drawRenderBatchCallback != NULL) drawRenderBatchCallback(false);
 #endif
 }
 
@@ -2912,6 +2944,55 @@ void rlDrawRenderBatchActive(void)
 #endif
 }
 
+// Set callback around every render batch draw
+void rlSetDrawRenderBatchCallback(rlDrawRenderBatchCallback callback)
+{
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    drawRenderBatchCallback = callback;
+#endif
+}
+
+// Get render statistics since last reset
+// NOTE: Active batch data is counted as if the batch was drawn now
+rlRenderStats rlGetRenderStats(void)
+{
+    rlRenderStats stats = { 0 };
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    stats = renderStats;
+
+    if ((RLGL.currentBatch != NULL) && (RLGL.State.vertexCounter > 0))
+    {
+        unsigned int textureId = renderStatsTextureId;
+        int eyeCount = RLGL.State.stereoRender? 2 : 1;
+
+        stats.batchFlushes++;
+        for (int i = 0; i < RLGL.currentBatch->drawCounter; i++)
+        {
+            if (RLGL.currentBatch->draws[i].vertexCount > 0)
+            {
+                stats.drawCalls += eyeCount;
+                stats.vertices += RLGL.currentBatch->draws[i].vertexCount*eyeCount;
+                if (RLGL.currentBatch->draws[i].textureId != textureId) stats.textureSwitches++;
+                textureId = RLGL.currentBatch->draws[i].textureId;
+            }
+        }
+    }
+#endif
+    return stats;
+}
+
+// Reset render statistics
+void rlResetRenderStats(void)
+{
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    renderStats.drawCalls = 0;
+    renderStats.vertices = 0;
+    renderStats.batchFlushes = 0;
+    renderStats.textureSwitches = 0;
+    renderStatsTextureId = 0;
+#endif
+}
+
 // Check internal buffer overflow for a given number of vertex
 // and force a rlRenderBatch draw call if required
 bool rlCheckRenderBatchLimit(int vCount)
@@ -3446,6 +3527,14 @@ unsigned char *rlReadScreenPixels(int width, int height)
     return imgData;     // NOTE: image data should be freed
 }
 
+// Read screen pixel data (color buffer) into a preallocated RGBA buffer of width*height*4 bytes
+// NOTE: Data is left as returned by OpenGL: bottom row first and alpha not forced to 255,
+// so the single copy is as cheap as possible and any fix-up can be done out of the render thread
+void rlReadScreenPixelsToBuffer(unsigned char *data, int width, int height)
+{
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, data);
+}
+
 // Framebuffer management (fbo)
 //-----------------------------------------------------------------------------------------
 // Load a framebuffer to be used for rendering